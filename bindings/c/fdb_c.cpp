@@ -24,6 +24,10 @@
 #include "fdbclient/MultiVersionTransaction.h"
 #include "foundationdb/fdb_c.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 int g_api_version = 0;
 
 /*
@@ -34,12 +38,14 @@ int g_api_version = 0;
  *   FDBFuture -> ThreadSingleAssignmentVarBase
  *   FDBDatabase -> IDatabase
  *   FDBTransaction -> ITransaction
+ *   FDBCompletionQueue -> CompletionQueue
  */
 #define TSAVB(f) ((ThreadSingleAssignmentVarBase*)(f))
 #define TSAV(T, f) ((ThreadSingleAssignmentVar<T>*)(f))
 
 #define DB(d) ((IDatabase*)d)
 #define TXN(t) ((ITransaction*)t)
+#define CQ(q) ((CompletionQueue*)q)
 
 // Legacy (pre API version 610)
 #define CLUSTER(c) ((char*)c)
@@ -200,6 +206,116 @@ fdb_error_t fdb_future_set_callback( FDBFuture* f,
 	CATCH_AND_RETURN( TSAVB(f)->callOrSetAsCallback( cb, ignore, 0 ); );
 }
 
+/*
+ * A completion queue collects ready futures so that an application can collect many of them with one call from its
+ * own threads, rather than taking a callback into its runtime on the network thread for each one.
+ *
+ * The queue holds a reference to each future in it, so a future the application destroys while it is queued stays
+ * valid until poll() finds that it holds the only reference, releases it, and skips it.
+ */
+class CompletionQueue : public ThreadSafeReferenceCounted<CompletionQueue> {
+public:
+	~CompletionQueue() {
+		for(auto& c : completed) {
+			TSAVB(c.future)->delref();
+		}
+	}
+
+	void push(FDBFuture* f, void* userdata) {
+		TSAVB(f)->addref();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			completed.push_back(FDBCompletion{ f, userdata });
+		}
+		ready.notify_one();
+	}
+
+	int poll(FDBCompletion* out, int maxCompletions, bool wait) {
+		std::vector<FDBFuture*> destroyed;
+		int count = 0;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while(count == 0) {
+				if(wait) {
+					ready.wait(lock, [this](){ return !completed.empty(); });
+				}
+				while(count < maxCompletions && !completed.empty()) {
+					FDBCompletion c = completed.front();
+					completed.pop_front();
+					if(TSAVB(c.future)->isSoleOwnerUnsafe()) {
+						destroyed.push_back(c.future);
+					} else {
+						TSAVB(c.future)->delref();
+						out[count++] = c;
+					}
+				}
+				if(!wait) {
+					break;
+				}
+			}
+		}
+
+		for(auto f : destroyed) {
+			TSAVB(f)->delref();
+		}
+		return count;
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable ready;
+	std::deque<FDBCompletion> completed;
+};
+
+class CAPIQueueCallback : public ThreadCallback, public FastAllocated<CAPIQueueCallback> {
+public:
+	CAPIQueueCallback(Reference<CompletionQueue> queue, FDBFuture* f, void* userdata)
+		: queue(queue), f(f), userdata(userdata) {}
+
+	virtual bool canFire(int notMadeActive) { return true; }
+	virtual void fire(const Void& unused, int& userParam) {
+		queue->push(f, userdata);
+		delete this;
+	}
+	virtual void error(const Error& e, int& userParam) {
+		// A future is cancelled when the application destroys or cancels it, after which it must not be handed back
+		if(e.code() != error_code_operation_cancelled && e.code() != error_code_actor_cancelled) {
+			queue->push(f, userdata);
+		}
+		delete this;
+	}
+
+private:
+	Reference<CompletionQueue> queue;
+	FDBFuture* f;
+	void* userdata;
+};
+
+extern "C" DLLEXPORT
+fdb_error_t fdb_completion_queue_create( FDBCompletionQueue** out_queue ) {
+	CATCH_AND_RETURN( *out_queue = (FDBCompletionQueue*)new CompletionQueue(); );
+}
+
+extern "C" DLLEXPORT
+void fdb_completion_queue_destroy( FDBCompletionQueue* q ) {
+	CATCH_AND_DIE( CQ(q)->delref(); );
+}
+
+extern "C" DLLEXPORT
+fdb_error_t fdb_future_set_queue( FDBFuture* f, FDBCompletionQueue* q, void* userdata ) {
+	CAPIQueueCallback* cb = new CAPIQueueCallback(Reference<CompletionQueue>::addRef(CQ(q)), f, userdata);
+	int ignore;
+	CATCH_AND_RETURN( TSAVB(f)->callOrSetAsCallback( cb, ignore, 0 ); );
+}
+
+extern "C" DLLEXPORT
+fdb_error_t fdb_completion_queue_poll( FDBCompletionQueue* q, FDBCompletion* out_completions, int max_completions,
+                                       fdb_bool_t wait, int* out_count ) {
+	if(max_completions <= 0)
+		return error_code_client_invalid_operation;
+	CATCH_AND_RETURN( *out_count = CQ(q)->poll(out_completions, max_completions, wait); );
+}
+
 extern "C" DLLEXPORT
 fdb_error_t fdb_future_get_error_impl( FDBFuture* f ) {
 	return TSAVB(f)->getErrorCode();
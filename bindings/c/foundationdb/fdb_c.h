@@ -64,6 +64,7 @@ extern "C" {
     typedef struct FDB_future FDBFuture;
     typedef struct FDB_database FDBDatabase;
     typedef struct FDB_transaction FDBTransaction;
+    typedef struct FDB_completion_queue FDBCompletionQueue;
 
     typedef int fdb_error_t;
     typedef int fdb_bool_t;
@@ -115,6 +116,26 @@ extern "C" {
     fdb_future_set_callback( FDBFuture* f, FDBCallback callback,
                              void* callback_parameter );
 
+    typedef struct completion {
+        FDBFuture* future;
+        void* callback_parameter;
+    } FDBCompletion;
+
+    DLLEXPORT WARN_UNUSED_RESULT fdb_error_t
+    fdb_completion_queue_create( FDBCompletionQueue** out_queue );
+
+    DLLEXPORT void fdb_completion_queue_destroy( FDBCompletionQueue* q );
+
+    DLLEXPORT WARN_UNUSED_RESULT fdb_error_t
+    fdb_future_set_queue( FDBFuture* f, FDBCompletionQueue* q,
+                          void* callback_parameter );
+
+    DLLEXPORT WARN_UNUSED_RESULT fdb_error_t
+    fdb_completion_queue_poll( FDBCompletionQueue* q,
+                               FDBCompletion* out_completions,
+                               int max_completions, fdb_bool_t wait,
+                               int* out_count );
+
 #if FDB_API_VERSION >= 23
     DLLEXPORT WARN_UNUSED_RESULT fdb_error_t
     fdb_future_get_error( FDBFuture* f );
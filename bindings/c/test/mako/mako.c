@@ -344,6 +344,71 @@ int run_op_get(FDBTransaction *transaction, char *keystr, char *valstr,
   return 0;
 }
 
+/* issue all GETs of a transaction at once and collect them in batches from a
+ * completion queue. errors are counted but not retried. */
+int run_op_get_queued(FDBTransaction *transaction, FDBCompletionQueue *queue,
+                      mako_args_t *args, mako_stats_t *stats, int op,
+                      char *keystr, int snapshot) {
+  FDBFuture *f;
+  FDBCompletion completions[QUEUE_POLL_MAX];
+  fdb_error_t err;
+  struct timespec timer_start, timer_end;
+  int sample = (stats->xacts % args->sampling == 0);
+  int pending = 0;
+  int polled;
+  int keynum;
+  int i;
+
+  if (sample) {
+    clock_gettime(CLOCK_MONOTONIC, &timer_start);
+  }
+
+  for (i = 0; i < args->txnspec.ops[op][OP_COUNT]; i++) {
+    if (args->zipf) {
+      keynum = zipfian_next();
+    } else {
+      keynum = urand(0, args->rows - 1);
+    }
+    genkey(keystr, keynum, args->rows, args->key_length + 1);
+
+    f = fdb_transaction_get(transaction, (uint8_t *)keystr, strlen(keystr),
+                            snapshot);
+    err = fdb_future_set_queue(f, queue, NULL);
+    if (err) {
+      fdb_future_destroy(f);
+      stats->errors[op]++;
+      continue;
+    }
+    pending++;
+  }
+
+  while (pending > 0) {
+    err = fdb_completion_queue_poll(queue, completions, QUEUE_POLL_MAX, 1,
+                                    &polled);
+    if (err) {
+      fprintf(stderr, "ERROR: fdb_completion_queue_poll: %s\n",
+              fdb_get_error(err));
+      return -1;
+    }
+    for (i = 0; i < polled; i++) {
+      if (fdb_future_get_error(completions[i].future)) {
+        stats->errors[op]++;
+      } else {
+        stats->ops[op]++;
+      }
+      fdb_future_destroy(completions[i].future);
+    }
+    pending -= polled;
+  }
+
+  if (sample) {
+    /* one latency sample for the whole batch */
+    clock_gettime(CLOCK_MONOTONIC, &timer_end);
+    update_op_stats(&timer_start, &timer_end, op, stats);
+  }
+  return 0;
+}
+
 int run_op_getrange(FDBTransaction *transaction, char *keystr, char *keystr2,
                     char *valstr, int snapshot, int reverse) {
   FDBFuture *f;
@@ -453,9 +518,9 @@ int run_op_clearrange(FDBTransaction *transaction, char *keystr,
 }
 
 /* run one transaction */
-int run_transaction(FDBTransaction *transaction, mako_args_t *args,
-                    mako_stats_t *stats, char *keystr, char *keystr2,
-                    char *valstr) {
+int run_transaction(FDBTransaction *transaction, FDBCompletionQueue *queue,
+                    mako_args_t *args, mako_stats_t *stats, char *keystr,
+                    char *keystr2, char *valstr) {
   int i;
   int count;
   int rc;
@@ -473,6 +538,13 @@ int run_transaction(FDBTransaction *transaction, mako_args_t *args,
   for (i = 0; i < MAX_OP; i++) {
 
     if ((args->txnspec.ops[i][OP_COUNT] > 0) && (i != OP_COMMIT)) {
+      if (queue && ((i == OP_GET) || (i == OP_SGET))) {
+        if (run_op_get_queued(transaction, queue, args, stats, i, keystr,
+                              i == OP_SGET) != 0) {
+          stats->errors[i]++;
+        }
+        continue;
+      }
       for (count = 0; count < args->txnspec.ops[i][OP_COUNT]; count++) {
 
         /* pick a random key(s) */
@@ -634,8 +706,9 @@ int run_transaction(FDBTransaction *transaction, mako_args_t *args,
   return 0;
 }
 
-int run_workload(FDBTransaction *transaction, mako_args_t *args, int thread_tps,
-                 int thread_iters, volatile int *signal, mako_stats_t *stats) {
+int run_workload(FDBTransaction *transaction, FDBCompletionQueue *queue,
+                 mako_args_t *args, int thread_tps, int thread_iters,
+                 volatile int *signal, mako_stats_t *stats) {
   int xacts = 0;
   int rc = 0;
   struct timespec timer_prev, timer_now;
@@ -683,7 +756,8 @@ int run_workload(FDBTransaction *transaction, mako_args_t *args, int thread_tps,
       }
     }
 
-    rc = run_transaction(transaction, args, stats, keystr, keystr2, valstr);
+    rc = run_transaction(transaction, queue, args, stats, keystr, keystr2,
+                         valstr);
     if (rc) {
       /* should never get here */
       fprintf(stderr, "ERROR: run_transaction failed (%d)\n", rc);
@@ -710,10 +784,13 @@ void *worker_thread(void *thread_args) {
   int worker_id = ((thread_args_t *)thread_args)->process->worker_id;
   int thread_id = ((thread_args_t *)thread_args)->thread_id;
   mako_args_t *args = ((thread_args_t *)thread_args)->process->args;
-  FDBDatabase *database = ((thread_args_t *)thread_args)->process->database;
+  process_info_t *process = ((thread_args_t *)thread_args)->process;
+  FDBDatabase *database =
+      process->databases[thread_id % process->num_databases];
   fdb_error_t err;
   int rc;
   FDBTransaction *transaction;
+  FDBCompletionQueue *queue = NULL;
   int thread_tps;
   int thread_iters = 0;
   int op;
@@ -752,6 +829,12 @@ void *worker_thread(void *thread_args) {
   err = fdb_database_create_transaction(database, &transaction);
   check_fdb_error(err);
 
+  /* reads are collected from a completion queue */
+  if (args->completion_queue) {
+    err = fdb_completion_queue_create(&queue);
+    check_fdb_error(err);
+  }
+
   /* i'm ready */
   __sync_fetch_and_add(readycount, 1);
   while (*signal == SIGNAL_OFF) {
@@ -776,8 +859,8 @@ void *worker_thread(void *thread_args) {
 
   /* run the workload */
   else if (args->mode == MODE_RUN) {
-    rc = run_workload(transaction, args, thread_tps, thread_iters, signal,
-                      stats);
+    rc = run_workload(transaction, queue, args, thread_tps, thread_iters,
+                      signal, stats);
     if (rc < 0) {
       fprintf(stderr, "ERROR: run_workload failed\n");
     }
@@ -786,6 +869,8 @@ void *worker_thread(void *thread_args) {
   /* fall through */
 FDB_FAIL:
   fdb_transaction_destroy(transaction);
+  if (queue)
+    fdb_completion_queue_destroy(queue);
   pthread_exit(0);
 }
 
@@ -872,6 +957,39 @@ int worker_process_main(mako_args_t *args, int worker_id, mako_shmhdr_t *shm) {
     }
   }
 
+  /* use a private copy of the external client for each client thread */
+  if (args->external_client_library[0] != '\0') {
+    if (args->verbose >= VERBOSE_DEBUG) {
+      printf("DEBUG: Using external client library %s\n",
+             args->external_client_library);
+    }
+    err = fdb_network_set_option(
+        FDB_NET_OPTION_EXTERNAL_CLIENT_LIBRARY,
+        (uint8_t *)args->external_client_library,
+        strlen(args->external_client_library));
+    if (err) {
+      fprintf(stderr,
+              "ERROR: fdb_network_set_option(FDB_NET_OPTION_EXTERNAL_CLIENT_"
+              "LIBRARY): %s\n",
+              fdb_get_error(err));
+    }
+  }
+  if (args->client_threads > 1) {
+    int64_t client_threads = args->client_threads;
+    if (args->verbose >= VERBOSE_DEBUG) {
+      printf("DEBUG: Using %d client threads\n", args->client_threads);
+    }
+    err = fdb_network_set_option(FDB_NET_OPTION_CLIENT_THREADS_PER_VERSION,
+                                 (uint8_t *)&client_threads,
+                                 sizeof(client_threads));
+    if (err) {
+      fprintf(stderr,
+              "ERROR: fdb_network_set_option(FDB_NET_OPTION_CLIENT_THREADS_"
+              "PER_VERSION): %s\n",
+              fdb_get_error(err));
+    }
+  }
+
   /* Network thread must be setup before doing anything */
   if (args->verbose == VERBOSE_DEBUG) {
     printf("DEBUG: fdb_setup_network\n");
@@ -893,6 +1011,15 @@ int worker_process_main(mako_args_t *args, int worker_id, mako_shmhdr_t *shm) {
 
   /* set up cluster and datbase for workder threads */
 
+  /* each database is assigned to its own client network thread */
+  process.num_databases = args->client_threads > 1 ? args->client_threads : 1;
+  process.databases =
+      (FDBDatabase **)calloc(sizeof(FDBDatabase *), process.num_databases);
+  if (!process.databases) {
+    fprintf(stderr, "ERROR: cannot allocate databases\n");
+    return -1;
+  }
+
 #if FDB_API_VERSION < 610
   /* cluster */
   f = fdb_create_cluster(args->cluster_file);
@@ -905,12 +1032,16 @@ int worker_process_main(mako_args_t *args, int worker_id, mako_shmhdr_t *shm) {
   /* big mystery -- do we ever have a database named other than "DB"? */
   f = fdb_cluster_create_database(cluster, (uint8_t *)"DB", 2);
   fdb_block_wait(f);
-  err = fdb_future_get_database(f, &process.database);
+  err = fdb_future_get_database(f, &process.databases[0]);
   check_fdb_error(err);
   fdb_future_destroy(f);
+  process.num_databases = 1;
 
 #else /* >= 610 */
-  fdb_create_database(args->cluster_file, &process.database);
+  for (i = 0; i < process.num_databases; i++) {
+    err = fdb_create_database(args->cluster_file, &process.databases[i]);
+    check_fdb_error(err);
+  }
 #endif
 
   if (args->verbose >= VERBOSE_DEBUG) {
@@ -961,7 +1092,10 @@ EXIT:
     free(thread_args);
 
   /* clean up database and cluster */
-  fdb_database_destroy(process.database);
+  for (i = 0; i < process.num_databases; i++) {
+    fdb_database_destroy(process.databases[i]);
+  }
+  free(process.databases);
 #if FDB_API_VERSION < 610
   fdb_cluster_destroy(cluster);
 #endif
@@ -1011,6 +1145,9 @@ int init_args(mako_args_t *args) {
   args->knobs[0] = '\0';
   args->trace = 0;
   args->tracepath[0] = '\0';
+  args->client_threads = 1;
+  args->external_client_library[0] = '\0';
+  args->completion_queue = 0;
   for (i = 0; i < MAX_OP; i++) {
     args->txnspec.ops[i][OP_COUNT] = 0;
   }
@@ -1170,6 +1307,12 @@ void usage() {
   printf("%-24s%s\n", "    --tracepath=PATH", "Set trace file path");
   printf("%-24s%s\n", "    --knobs=KNOBS", "Set client knobs");
   printf("%-24s%s\n", "    --flatbuffers", "Use flatbuffers");
+  printf("%-24s%s\n", "    --client_threads=N",
+         "Specify number of client network threads");
+  printf("%-24s%s\n", "    --external_client_library=PATH",
+         "Specify the external client library to run on the client threads");
+  printf("%-24s%s\n", "    --completion_queue",
+         "Issue GETs together and collect them from a completion queue");
 }
 
 /* parse benchmark paramters */
@@ -1196,6 +1339,9 @@ int parse_args(int argc, char *argv[], mako_args_t *args) {
         {"mode", required_argument, NULL, 'm'},
         {"knobs", required_argument, NULL, ARG_KNOBS},
         {"tracepath", required_argument, NULL, ARG_TRACEPATH},
+        {"client_threads", required_argument, NULL, ARG_CLIENT_THREADS},
+        {"external_client_library", required_argument, NULL,
+         ARG_EXTERNAL_CLIENT_LIBRARY},
         /* no args */
         {"help", no_argument, NULL, 'h'},
         {"json", no_argument, NULL, 'j'},
@@ -1204,6 +1350,7 @@ int parse_args(int argc, char *argv[], mako_args_t *args) {
         {"flatbuffers", no_argument, NULL, ARG_FLATBUFFERS},
         {"trace", no_argument, NULL, ARG_TRACE},
         {"version", no_argument, NULL, ARG_VERSION},
+        {"completion_queue", no_argument, NULL, ARG_COMPLETION_QUEUE},
         {NULL, 0, NULL, 0}};
     idx = 0;
     c = getopt_long(argc, argv, short_options, long_options, &idx);
@@ -1284,6 +1431,15 @@ int parse_args(int argc, char *argv[], mako_args_t *args) {
       args->trace = 1;
       memcpy(args->tracepath, optarg, strlen(optarg) + 1);
       break;
+    case ARG_CLIENT_THREADS:
+      args->client_threads = atoi(optarg);
+      break;
+    case ARG_EXTERNAL_CLIENT_LIBRARY:
+      strcpy(args->external_client_library, optarg);
+      break;
+    case ARG_COMPLETION_QUEUE:
+      args->completion_queue = 1;
+      break;
     }
   }
   return 0;
@@ -1306,6 +1462,10 @@ int validate_args(mako_args_t *args) {
     fprintf(stderr, "ERROR: --vallen must be a positive integer\n");
     return -1;
   }
+  if (args->client_threads < 1) {
+    fprintf(stderr, "ERROR: --client_threads must be a positive integer\n");
+    return -1;
+  }
   if (args->key_length < 4 /* "mako" */ + digits(args->rows)) {
     fprintf(stderr,
             "ERROR: --keylen must be larger than %d to store \"mako\" prefix "
@@ -64,6 +64,11 @@
 #define ARG_FLATBUFFERS 8
 #define ARG_TRACE 9
 #define ARG_TRACEPATH 10
+#define ARG_CLIENT_THREADS 11
+#define ARG_EXTERNAL_CLIENT_LIBRARY 12
+#define ARG_COMPLETION_QUEUE 13
+
+#define QUEUE_POLL_MAX 64 /* completions collected per poll */
 
 #define KEYPREFIX "mako"
 #define KEYPREFIXLEN 4
@@ -97,6 +102,9 @@ typedef struct {
   char tracepath[PATH_MAX];
   char knobs[KNOB_MAX];
   uint8_t flatbuffers;
+  int client_threads;
+  char external_client_library[PATH_MAX];
+  int completion_queue;
 } mako_args_t;
 
 /* shared memory */
@@ -123,7 +131,8 @@ typedef struct {
 /* per-process information */
 typedef struct {
   int worker_id;
-  FDBDatabase *database;
+  int num_databases;
+  FDBDatabase **databases; /* one per client network thread */
   mako_args_t *args;
   mako_shmhdr_t *shm;
 } process_info_t;
@@ -53,22 +53,26 @@ namespace FDB {
 		return *(double*)&big;
 	}
 
+	// memchr is vectorized by the platform's C library, and strings rarely contain escaped nulls
 	static size_t find_string_terminator(const StringRef data, size_t offset) {
 		size_t i = offset;
-		while (i < data.size() - 1 && !(data[i] == (uint8_t)'\x00' && data[i+1] != (uint8_t)'\xff')) {
-			i += (data[i] == '\x00' ? 2 : 1);
+		while (i < data.size() - 1) {
+			const uint8_t* nul = (const uint8_t*)memchr(data.begin() + i, 0, data.size() - 1 - i);
+			if(!nul) {
+				return data.size() - 1;
+			}
+			i = nul - data.begin();
+			if(data[i+1] != (uint8_t)'\xff') {
+				return i;
+			}
+			i += 2;
 		}
 
 		return i;
 	}
 
 	static size_t find_string_terminator(const Standalone<VectorRef<unsigned char> > data, size_t offset ) {
-		size_t i = offset;
-		while (i < data.size() - 1 && !(data[i] == '\x00' && data[i+1] != (uint8_t)'\xff')) {
-			i += (data[i] == '\x00' ? 2 : 1);
-		}
-
-		return i;
+		return find_string_terminator(StringRef(data.begin(), data.size()), offset);
 	}
 
 	// If encoding and the sign bit is 1 (the number is negative), flip all the bits.
@@ -158,22 +162,34 @@ namespace FDB {
 	Tuple& Tuple::append(StringRef const& str, bool utf8) {
 		offsets.push_back(data.size());
 
-		const uint8_t utfChar = utf8 ? STRING_CODE : BYTES_CODE;
-		data.append(data.arena(), &utfChar, 1);
-
-		size_t lastPos = 0;
-		for(size_t pos = 0; pos < str.size(); ++pos) {
-			if(str[pos] == '\x00') {
-				data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-				data.push_back(data.arena(), (uint8_t)'\x00');
-				data.push_back(data.arena(), (uint8_t)'\xff');
-				lastPos = pos + 1;
-			}
+		// Each \x00 is escaped as \x00\xff, so count them first to size the encoding exactly
+		const uint8_t* in = str.begin();
+		const uint8_t* end = str.end();
+		int nulls = 0;
+		for(const uint8_t* p = in; p < end && (p = (const uint8_t*)memchr(p, 0, end - p)) != nullptr; ++p) {
+			++nulls;
 		}
 
-		data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
-		data.push_back(data.arena(), (uint8_t)'\x00');
+		data.reserve(data.arena(), data.size() + str.size() + nulls + 2);
+		uint8_t* begin = data.begin() + data.size();
+		uint8_t* out = begin;
 
+		*out++ = utf8 ? STRING_CODE : BYTES_CODE;
+		for(; nulls > 0; --nulls) {
+			const uint8_t* nul = (const uint8_t*)memchr(in, 0, end - in);
+			memcpy(out, in, nul - in);
+			out += nul - in;
+			*out++ = (uint8_t)'\x00';
+			*out++ = (uint8_t)'\xff';
+			in = nul + 1;
+		}
+		if(end > in) {
+			memcpy(out, in, end - in);
+			out += end - in;
+		}
+		*out++ = (uint8_t)'\x00';
+
+		data.extendUnsafeNoReallocNoInit(out - begin);
 		return *this;
 	}
 
@@ -334,21 +350,21 @@ namespace FDB {
 
 		Standalone<StringRef> result;
 		VectorRef<uint8_t> staging;
-
-		for (size_t i = b; i < e; ++i) {
-			if(data[i] == '\x00') {
-				staging.append(result.arena(), data.begin() + b, i - b);
-				++i;
-				b = i + 1;
-
-				if(i < e) {
-					staging.push_back(result.arena(), '\x00');
-				}
+		staging.reserve(result.arena(), e - b);
+
+		const uint8_t* p = data.begin() + b;
+		const uint8_t* end = data.begin() + e;
+		while(p < end) {
+			const uint8_t* nul = (const uint8_t*)memchr(p, 0, end - p);
+			if(!nul) {
+				staging.append(result.arena(), p, end - p);
+				break;
 			}
-		}
-
-		if(b < e) {
-			staging.append(result.arena(), data.begin() + b, e - b);
+			staging.append(result.arena(), p, nul - p);
+			if(nul + 1 < end) {
+				staging.push_back(result.arena(), '\x00');
+			}
+			p = nul + 2;
 		}
 
 		result.StringRef::operator=(StringRef(staging.begin(), staging.size()));
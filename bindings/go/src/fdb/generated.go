@@ -218,6 +218,13 @@ func (o NetworkOptions) SetDisableLocalClient() error {
 	return o.setOpt(64, nil)
 }
 
+// Spawns multiple network threads for each external client library, allowing client throughput to scale beyond a single network thread. Each database created after the network is set up is assigned to one of these threads. Implies disable_local_client. Must be set before setting up the network.
+//
+// Parameter: Number of network threads to start for each external client library
+func (o NetworkOptions) SetClientThreadsPerVersion(param int64) error {
+	return o.setOpt(65, int64ToBytes(param))
+}
+
 // Disables logging of client statistics, such as sampled transaction activity.
 func (o NetworkOptions) SetDisableClientStatisticsLogging() error {
 	return o.setOpt(70, nil)
@@ -290,6 +297,13 @@ func (o DatabaseOptions) SetSnapshotRywDisable() error {
 	return o.setOpt(27, nil)
 }
 
+// Cache the values of single key reads of keys beginning with this prefix across transactions on this database. Cached values are only returned to transactions which see the same value of the metadata version key as when they were cached, so every transaction that modifies keys under this prefix must also update the metadata version key. May be set more than once to cache several prefixes.
+//
+// Parameter: Key prefix to cache
+func (o DatabaseOptions) SetReadCachePrefix(param []byte) error {
+	return o.setOpt(28, param)
+}
+
 // Sets the maximum escaped length of key and value fields to be logged to the trace file via the LOG_TRANSACTION option. This sets the ``transaction_logging_max_field_length`` option of each transaction created by this database. See the transaction option description for more information.
 //
 // Parameter: Maximum length of escaped key and value fields.
@@ -484,6 +498,13 @@ func (o TransactionOptions) SetUseProvisionalProxies() error {
 	return o.setOpt(711, nil)
 }
 
+// Allows the transaction to reuse a read version that was obtained by another transaction on the same database up to this many milliseconds ago, instead of requesting a new one. The transaction may not see commits made in that window, including commits made by this client, so this option should only be used by transactions that tolerate slightly stale reads. The staleness is capped at one second. If set to 0, a new read version is always requested.
+//
+// Parameter: value in milliseconds of maximum staleness
+func (o TransactionOptions) SetReadVersionMaxStaleness(param int64) error {
+	return o.setOpt(720, int64ToBytes(param))
+}
+
 type StreamingMode int
 
 const (
@@ -1242,8 +1242,10 @@ ACTOR Future<std::string> getLayerStatus(Reference<ReadYourWritesTransaction> tr
 		blobstats.create("total") = current_stats.getJSON();
 		BlobStoreEndpoint::Stats diff = current_stats - last_stats;
 		json_spirit::mObject diffObj = diff.getJSON();
-		if(last_ts > 0)
+		if(last_ts > 0) {
 			diffObj["bytes_per_second"] = double(current_stats.bytes_sent - last_stats.bytes_sent) / (now() - last_ts);
+			diffObj["upload_bytes_per_second"] = double(current_stats.bytes_uploaded - last_stats.bytes_uploaded) / (now() - last_ts);
+		}
 		blobstats.create("recent") = diffObj;
 		last_stats = current_stats;
 		last_ts = now();
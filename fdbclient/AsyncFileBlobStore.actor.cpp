@@ -20,6 +20,8 @@
 
 #include "fdbclient/AsyncFileBlobStore.actor.h"
 #include "fdbrpc/AsyncFileReadAhead.actor.h"
+#include "fdbclient/md5/md5.h"
+#include "fdbclient/libb64/encode.h"
 #include "flow/UnitTest.h"
 #include "flow/actorcompiler.h" // has to be last include
 
@@ -79,4 +81,88 @@ TEST_CASE("/backup/throttling") {
 	return Void();
 }
 
+TEST_CASE("/backup/contentMD5") {
+	state UnsentPacketQueue empty;  // NonCopyable state vars so must be declared at top of actor
+	state UnsentPacketQueue content;
+	std::string emptyMD5 = wait(computeContentMD5(&empty));
+	ASSERT(emptyMD5 == "1B2M2Y8AsgTpgAmY7PhCfg==");
 
+	// Content spanning many packet buffers must sum the same as the same bytes in one piece
+	state std::string data;
+	for(int i = 0; i < 100000; ++i)
+		data.push_back((char)deterministicRandom()->randomInt(0, 256));
+	PacketWriter pw(content.getWriteBuffer(), NULL, Unversioned());
+	pw.serializeBytes(data);
+
+	MD5_CTX sum;
+	::MD5_Init(&sum);
+	::MD5_Update(&sum, data.data(), data.size());
+	std::string sumBytes;
+	sumBytes.resize(16);
+	::MD5_Final((unsigned char *)sumBytes.data(), &sum);
+	state std::string expected = base64::encoder::from_string(sumBytes);
+	expected.resize(expected.size() - 1);
+
+	std::string md5 = wait(computeContentMD5(&content));
+	ASSERT(md5 == expected);
+
+	return Void();
+}
+
+// Read-only file where every read takes a fixed amount of time no matter its size, like a ranged GET against a blob store
+class LatencyBoundFile : public IAsyncFile, public ReferenceCounted<LatencyBoundFile> {
+public:
+	LatencyBoundFile(int64_t fileSize, double latency) : fileSize(fileSize), latency(latency) {}
+
+	virtual void addref() { ReferenceCounted<LatencyBoundFile>::addref(); }
+	virtual void delref() { ReferenceCounted<LatencyBoundFile>::delref(); }
+
+	ACTOR static Future<int> read_impl(Reference<LatencyBoundFile> f, uint8_t *data, int length, int64_t offset) {
+		wait(delay(f->latency));
+		int len = std::max<int64_t>(0, std::min<int64_t>(length, f->fileSize - offset));
+		for(int i = 0; i < len; ++i)
+			data[i] = (uint8_t)(offset + i);
+		return len;
+	}
+
+	virtual Future<int> read(void *data, int length, int64_t offset) { return read_impl(Reference<LatencyBoundFile>::addRef(this), (uint8_t *)data, length, offset); }
+	virtual Future<Void> write(void const *data, int length, int64_t offset) { throw file_not_writable(); }
+	virtual Future<Void> truncate(int64_t size) { throw file_not_writable(); }
+	virtual Future<Void> sync() { return Void(); }
+	virtual Future<int64_t> size() { return fileSize; }
+	virtual std::string getFilename() { return "LatencyBoundFile"; }
+	virtual int64_t debugFD() { return -1; }
+
+	int64_t fileSize;
+	double latency;
+};
+
+TEST_CASE("/backup/readAhead/adaptive") {
+	state int blockSize = 4096;
+	state int64_t fileSize = 200 * blockSize + 123;
+	state Reference<AsyncFileReadAheadCache> f(new AsyncFileReadAheadCache(Reference<IAsyncFile>(new LatencyBoundFile(fileSize, 0.01)), blockSize, 0, 8, 2, 8));
+	state Standalone<StringRef> buf = makeString(blockSize);
+	state int64_t offset = 0;
+
+	// Sequential reads should be served correctly and grow the read ahead since reads in parallel finish sooner
+	while(offset < fileSize) {
+		int len = wait(f->read(mutateString(buf), blockSize, offset));
+		ASSERT(len == std::min<int64_t>(blockSize, fileSize - offset));
+		for(int i = 0; i < len; ++i)
+			ASSERT(buf[i] == (uint8_t)(offset + i));
+		offset += len;
+	}
+	ASSERT(f->m_read_ahead_blocks > 1 && f->m_read_ahead_blocks <= 8);
+
+	// Random reads still return the right data
+	state int i;
+	for(i = 0; i < 20; ++i) {
+		state int64_t randomOffset = deterministicRandom()->randomInt64(0, fileSize);
+		int len = wait(f->read(mutateString(buf), blockSize, randomOffset));
+		ASSERT(len == std::min<int64_t>(blockSize, fileSize - randomOffset));
+		for(int j = 0; j < len; ++j)
+			ASSERT(buf[j] == (uint8_t)(randomOffset + j));
+	}
+
+	return Void();
+}
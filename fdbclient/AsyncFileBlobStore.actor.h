@@ -35,8 +35,6 @@
 #include "flow/Net2Packet.h"
 #include "fdbrpc/IRateControl.h"
 #include "fdbclient/BlobStore.h"
-#include "fdbclient/md5/md5.h"
-#include "fdbclient/libb64/encode.h"
 #include "flow/actorcompiler.h"  // This must be the last #include.
 
 ACTOR template<typename T> static Future<T> joinErrorGroup(Future<T> f, Promise<Void> p) {
@@ -53,18 +51,20 @@ ACTOR template<typename T> static Future<T> joinErrorGroup(Future<T> f, Promise<
 // using multi-part upload and beginning to transfer each part as soon as it is large enough.
 // All write operations file operations must be sequential and contiguous.
 // Limits on part sizes, upload speed, and concurrent uploads are taken from the BlobStoreEndpoint being used.
+// Each part's MD5 sum is computed off of the network thread once the part is full, and a part's buffers are released as
+// soon as it has been uploaded, so memory use is bounded by concurrent_writes_per_file + 1 parts.
 class AsyncFileBlobStoreWrite : public IAsyncFile, public ReferenceCounted<AsyncFileBlobStoreWrite> {
 public:
 	virtual void addref() { ReferenceCounted<AsyncFileBlobStoreWrite>::addref(); }
 	virtual void delref() { ReferenceCounted<AsyncFileBlobStoreWrite>::delref(); }
 
 	struct Part : ReferenceCounted<Part> {
-		Part(int n) : number(n), writer(content.getWriteBuffer(), NULL, Unversioned()), length(0) {
+		Part(int n) : number(n), writer(content.getWriteBuffer(), NULL, Unversioned()), length(0), buffered(0) {
 			etag = std::string();
-			::MD5_Init(&content_md5_buf);
 		}
 		virtual ~Part() {
 			etag.cancel();
+			releaseContent();
 		}
 		Future<std::string> etag;
 		int number;
@@ -72,26 +72,31 @@ public:
 		std::string md5string;
 		PacketWriter writer;
 		int length;
+		int buffered;  // Bytes of content still held in memory
 		void write(const uint8_t *buf, int len) {
 			writer.serializeBytes(buf, len);
-			::MD5_Update(&content_md5_buf, buf, len);
 			length += len;
+			buffered += len;
+			BlobStoreEndpoint::s_stats.upload_buffer_bytes += len;
 		}
-		// MD5 sum can only be finalized once, further calls will do nothing so new writes will be reflected in the sum.
-		void finalizeMD5() {
-			if(md5string.empty()) {
-				std::string sumBytes;
-				sumBytes.resize(16);
-				::MD5_Final((unsigned char *)sumBytes.data(), &content_md5_buf);
-				md5string = base64::encoder::from_string(sumBytes);
-				md5string.resize(md5string.size() - 1);
-			}
+		// Once the part has been uploaded its content is no longer needed
+		void releaseContent() {
+			content.discardAll();
+			BlobStoreEndpoint::s_stats.upload_buffer_bytes -= buffered;
+			buffered = 0;
 		}
-
-	private:
-		MD5_CTX content_md5_buf;
 	};
 
+	// MD5 sum can only be computed once the part is complete.  The part is kept alive until the sum is done, even if the
+	// caller is cancelled, because the checksum thread reads its buffers.
+	ACTOR static Future<Void> finalizeMD5(Reference<Part> p) {
+		if(p->md5string.empty()) {
+			std::string md5 = wait(uncancellable(holdWhile(p, computeContentMD5(&p->content))));
+			p->md5string = md5;
+		}
+		return Void();
+	}
+
 	virtual Future<int> read( void *data, int length, int64_t offset ) { throw file_not_readable(); }
 
 	ACTOR static Future<Void> write_impl(Reference<AsyncFileBlobStoreWrite> f, const uint8_t *data, int length) {
@@ -129,19 +134,23 @@ public:
 		return Void();
 	}
 
-	ACTOR static Future<std::string> doPartUpload(AsyncFileBlobStoreWrite *f, Part *p) {
-		p->finalizeMD5();
-		std::string upload_id = wait(f->getUploadID());
+	ACTOR static Future<std::string> doPartUpload(AsyncFileBlobStoreWrite *f, Reference<Part> p) {
+		// Get the upload ID while the sum is being computed
+		state Future<std::string> uploadID = f->getUploadID();
+		wait(finalizeMD5(p));
+		std::string upload_id = wait(uploadID);
 		std::string etag = wait(f->m_bstore->uploadPart(f->m_bucket, f->m_object, upload_id, p->number, &p->content, p->length, p->md5string));
+		p->releaseContent();
 		return etag;
 	}
 
 	ACTOR static Future<Void> doFinishUpload(AsyncFileBlobStoreWrite* f) {
 		// If there is only 1 part then it has not yet been uploaded so just write the whole file at once.
 		if(f->m_parts.size() == 1) {
-			Reference<Part> part = f->m_parts.back();
-			part->finalizeMD5();
+			state Reference<Part> part = f->m_parts.back();
+			wait(finalizeMD5(part));
 			wait(f->m_bstore->writeEntireFileFromBuffer(f->m_bucket, f->m_object, &part->content, part->length, part->md5string));
+			part->releaseContent();
 			return Void();
 		}
 
@@ -226,7 +235,7 @@ private:
 		// Do the upload, and if it fails forward errors to m_error and also stop if anything else sends an error to m_error
 		// Also, hold a releaser for the concurrent upload slot while all that is going on.
 		f->m_parts.back()->etag = holdWhile(std::shared_ptr<FlowLock::Releaser>(new FlowLock::Releaser(f->m_concurrentUploads, 1)),
-									joinErrorGroup(doPartUpload(f, f->m_parts.back().getPtr()), f->m_error)
+									joinErrorGroup(doPartUpload(f, f->m_parts.back()), f->m_error)
 								  );
 
 		// Make a new part to write to
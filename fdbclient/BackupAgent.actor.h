@@ -504,6 +504,22 @@ ACTOR Future<Void> applyMutations(Database cx, Key uid, Key addPrefix, Key remov
                                   Version* endVersion, RequestStream<CommitTransactionRequest> commit,
                                   NotifiedVersion* committedVersion, Reference<KeyRangeMap<Version>> keyVersion);
 
+namespace fileBackup {
+// Decodes the range file block at [offset, offset+len).  The first and last keys of the result are the begin and
+// end of the key range covered by the block and carry no values.
+ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<IAsyncFile> file, int64_t offset,
+                                                                      int len);
+
+// Decodes the log file block at [offset, offset+len) into its backup mutation log key-value pairs.
+ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeLogFileBlock(Reference<IAsyncFile> file, int64_t offset,
+                                                                    int len);
+
+// Writes the sorted key-value pairs in data, which must lie within range, as a range file covering range and
+// finishes the file.
+ACTOR Future<Void> writeRangeFile(Reference<IBackupFile> file, int blockSize, KeyRange range,
+                                  Standalone<VectorRef<KeyValueRef>> data);
+}
+
 typedef BackupAgentBase::enumState EBackupState;
 template<> inline Tuple Codec<EBackupState>::pack(EBackupState const &val) { return Tuple().append(val); }
 template<> inline EBackupState Codec<EBackupState>::unpack(Tuple const &val) { return (EBackupState)val.getInt(0); }
@@ -1403,7 +1403,8 @@ public:
 					m_bstore->knobs.read_block_size,
 					m_bstore->knobs.read_ahead_blocks,
 					m_bstore->knobs.concurrent_reads_per_file,
-					m_bstore->knobs.read_cache_blocks_per_file
+					m_bstore->knobs.read_cache_blocks_per_file,
+					m_bstore->knobs.read_ahead_max_blocks
 				)
 			);
 	}
@@ -27,6 +27,7 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include "fdbrpc/IAsyncFile.h"
+#include "flow/IThreadPool.h"
 #include "rapidxml/rapidxml.hpp"
 #include "flow/actorcompiler.h" // has to be last include
 
@@ -38,6 +39,9 @@ json_spirit::mObject BlobStoreEndpoint::Stats::getJSON() {
 	o["requests_failed"] = requests_failed;
 	o["requests_successful"] = requests_successful;
 	o["bytes_sent"] = bytes_sent;
+	o["parts_uploaded"] = parts_uploaded;
+	o["bytes_uploaded"] = bytes_uploaded;
+	o["upload_buffer_bytes"] = upload_buffer_bytes;
 
 	return o;
 }
@@ -47,6 +51,9 @@ BlobStoreEndpoint::Stats BlobStoreEndpoint::Stats::operator-(const Stats &rhs) {
 	r.requests_failed = requests_failed - rhs.requests_failed;
 	r.requests_successful = requests_successful - rhs.requests_successful;
 	r.bytes_sent = bytes_sent - rhs.bytes_sent;
+	r.parts_uploaded = parts_uploaded - rhs.parts_uploaded;
+	r.bytes_uploaded = bytes_uploaded - rhs.bytes_uploaded;
+	r.upload_buffer_bytes = upload_buffer_bytes;
 	return r;
 }
 
@@ -74,6 +81,7 @@ BlobStoreEndpoint::BlobKnobs::BlobKnobs() {
 	read_block_size = CLIENT_KNOBS->BLOBSTORE_READ_BLOCK_SIZE;
 	read_ahead_blocks = CLIENT_KNOBS->BLOBSTORE_READ_AHEAD_BLOCKS;
 	read_cache_blocks_per_file = CLIENT_KNOBS->BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE;
+	read_ahead_max_blocks = CLIENT_KNOBS->BLOBSTORE_READ_AHEAD_MAX_BLOCKS;
 	max_send_bytes_per_second = CLIENT_KNOBS->BLOBSTORE_MAX_SEND_BYTES_PER_SECOND;
 	max_recv_bytes_per_second = CLIENT_KNOBS->BLOBSTORE_MAX_RECV_BYTES_PER_SECOND;
 }
@@ -101,6 +109,7 @@ bool BlobStoreEndpoint::BlobKnobs::set(StringRef name, int value) {
 	TRY_PARAM(read_block_size, rbs);
 	TRY_PARAM(read_ahead_blocks, rab);
 	TRY_PARAM(read_cache_blocks_per_file, rcb);
+	TRY_PARAM(read_ahead_max_blocks, ramb);
 	TRY_PARAM(max_send_bytes_per_second, sbps);
 	TRY_PARAM(max_recv_bytes_per_second, rbps);
 	#undef TRY_PARAM
@@ -133,6 +142,7 @@ std::string BlobStoreEndpoint::BlobKnobs::getURLParameters() const {
 	_CHECK_PARAM(read_block_size, rbs);
 	_CHECK_PARAM(read_ahead_blocks, rab);
 	_CHECK_PARAM(read_cache_blocks_per_file, rcb);
+	_CHECK_PARAM(read_ahead_max_blocks, ramb);
 	_CHECK_PARAM(max_send_bytes_per_second, sbps);
 	_CHECK_PARAM(max_recv_bytes_per_second, rbps);
 	#undef _CHECK_PARAM
@@ -974,6 +984,7 @@ ACTOR Future<Void> writeEntireFileFromBuffer_impl(Reference<BlobStoreEndpoint> b
 	if (!r->verifyMD5(false, contentMD5))
 		throw checksum_failed();
 
+	bstore->s_stats.bytes_uploaded += contentLen;
 	return Void();
 }
 
@@ -1084,6 +1095,8 @@ ACTOR Future<std::string> uploadPart_impl(Reference<BlobStoreEndpoint> bstore, s
 	if(etag.empty())
 		throw http_bad_response();
 
+	bstore->s_stats.parts_uploaded++;
+	bstore->s_stats.bytes_uploaded += contentLen;
 	return etag;
 }
 
@@ -1114,3 +1127,52 @@ ACTOR Future<Void> finishMultiPartUpload_impl(Reference<BlobStoreEndpoint> bstor
 Future<Void> BlobStoreEndpoint::finishMultiPartUpload(std::string const &bucket, std::string const &object, std::string const &uploadID, MultiPartSetT const &parts) {
 	return finishMultiPartUpload_impl(Reference<BlobStoreEndpoint>::addRef(this), bucket, object, uploadID, parts);
 }
+
+static std::string md5Base64(PacketBuffer *first) {
+	MD5_CTX sum;
+	::MD5_Init(&sum);
+	for(PacketBuffer *b = first; b != nullptr; b = b->nextPacketBuffer())
+		::MD5_Update(&sum, b->data + b->bytes_sent, b->bytes_written - b->bytes_sent);
+	std::string sumBytes;
+	sumBytes.resize(16);
+	::MD5_Final((unsigned char *)sumBytes.data(), &sum);
+	std::string md5 = base64::encoder::from_string(sumBytes);
+	md5.resize(md5.size() - 1);
+	return md5;
+}
+
+struct ChecksumThread : IThreadPoolReceiver {
+	virtual void init() {}
+
+	struct ContentMD5 : TypedAction<ChecksumThread, ContentMD5> {
+		PacketBuffer *first;
+		ThreadReturnPromise<std::string> result;
+		ContentMD5(PacketBuffer *first) : first(first) {}
+		virtual double getTimeEstimate() { return 0; }
+	};
+
+	void action(ContentMD5 &a) {
+		a.result.send(md5Base64(a.first));
+	}
+};
+
+static Reference<IThreadPool> getChecksumThreads() {
+	static Reference<IThreadPool> pool;
+	if(!pool) {
+		pool = createGenericThreadPool();
+		for(int i = 0; i < std::max(1, CLIENT_KNOBS->BLOBSTORE_CHECKSUM_THREADS); ++i)
+			pool->addThread(new ChecksumThread());
+	}
+	return pool;
+}
+
+Future<std::string> computeContentMD5(UnsentPacketQueue *pContent) {
+	// Simulation must stay single threaded and deterministic
+	if(g_network->isSimulated() || CLIENT_KNOBS->BLOBSTORE_CHECKSUM_THREADS <= 0)
+		return md5Base64(pContent->getUnsent());
+
+	auto *a = new ChecksumThread::ContentMD5(pContent->getUnsent());
+	Future<std::string> result = a->result.getFuture();
+	getChecksumThreads()->post(a);
+	return result;
+}
@@ -34,7 +34,7 @@
 class BlobStoreEndpoint : public ReferenceCounted<BlobStoreEndpoint> {
 public:
 	struct Stats {
-		Stats() : requests_successful(0), requests_failed(0), bytes_sent(0) {}
+		Stats() : requests_successful(0), requests_failed(0), bytes_sent(0), parts_uploaded(0), bytes_uploaded(0), upload_buffer_bytes(0) {}
 		Stats operator-(const Stats &rhs);
 		void clear() { memset(this, 0, sizeof(*this)); }
 		json_spirit::mObject getJSON();
@@ -42,6 +42,9 @@ public:
 		int64_t requests_successful;
 		int64_t requests_failed;
 		int64_t bytes_sent;
+		int64_t parts_uploaded;
+		int64_t bytes_uploaded;
+		int64_t upload_buffer_bytes;  // Current bytes buffered by files being written, not a counter
 	};
 
 	static Stats s_stats;
@@ -69,6 +72,7 @@ public:
 			read_block_size,
 			read_ahead_blocks,
 			read_cache_blocks_per_file,
+			read_ahead_max_blocks,
 			max_send_bytes_per_second,
 			max_recv_bytes_per_second;
 		bool set(StringRef name, int value);
@@ -96,6 +100,7 @@ public:
 				"read_block_size (or rbs)              Block size in bytes to be used for reads.",
 				"read_ahead_blocks (or rab)            Number of blocks to read ahead of requested offset.",
 				"read_cache_blocks_per_file (or rcb)   Size of the read cache for a file in blocks.",
+				"read_ahead_max_blocks (or ramb)       Max blocks to read ahead of sequential reads, tuned by throughput. 0 uses a fixed read_ahead_blocks.",
 				"max_send_bytes_per_second (or sbps)   Max send bytes per second for all requests combined.",
 				"max_recv_bytes_per_second (or rbps)   Max receive bytes per second for all requests combined (NOT YET USED)."
 			};
@@ -237,3 +242,7 @@ public:
 	Future<Void> finishMultiPartUpload(std::string const &bucket, std::string const &object, std::string const &uploadID, MultiPartSetT const &parts);
 };
 
+// Returns the base64 encoded MD5 sum of the unsent bytes in pContent.  Outside of simulation the sum is computed on a
+// checksum thread, so the queue must not be changed or destroyed until the result is ready even if it is cancelled.
+Future<std::string> computeContentMD5(UnsentPacketQueue *pContent);
+
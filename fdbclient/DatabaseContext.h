@@ -132,6 +132,48 @@ public:
 
 	std::map< UID, StorageServerInfo* > server_interf;
 
+	// Cross-transaction cache of the values of keys under the read cache prefixes.  All entries were read under the same
+	// value of \xff/metadataVersion and are only served to transactions whose read version sees that same value, so
+	// clients writing cached keys must change the metadata version in the same transaction.
+	struct ReadCache {
+		std::vector<Key> prefixes;
+		Optional<Value> metadataVersion;
+		Version version;  // Newest read version at which metadataVersion was seen
+		std::map<Key, Optional<Value>> values;
+
+		ReadCache() : version(invalidVersion) {}
+
+		bool covers(KeyRef const& key) const {
+			for(auto &p : prefixes)
+				if(key.startsWith(p))
+					return true;
+			return false;
+		}
+
+		// Returns true if the cached values are valid for a transaction that saw mv at readVersion.  A newer metadata
+		// version replaces the cached one and empties the cache.
+		bool validFor(Version readVersion, Optional<Value> const& mv) {
+			if(mv == metadataVersion) {
+				version = std::max(version, readVersion);
+				return true;
+			}
+			if(readVersion > version) {
+				values.clear();
+				metadataVersion = mv;
+				version = readVersion;
+				return true;
+			}
+			return false;
+		}
+
+		void insert(Key const& key, Optional<Value> const& value, int maxEntries) {
+			if(values.size() >= maxEntries && !values.count(key))
+				values.erase(values.begin());
+			values[key] = value;
+		}
+	};
+	ReadCache readCache;
+
 	UID dbId;
 	bool internal; // Only contexts created through the C client and fdbcli are non-internal
 
@@ -151,6 +193,9 @@ public:
 	Counter transactionsResourceConstrained;
 	Counter transactionsProcessBehind;
 	Counter transactionWaitsForFullRecovery;
+	Counter transactionReadCacheHits;
+	Counter transactionReadCacheMisses;
+	Counter transactionReadVersionsReused;
 
 	ContinuousSample<double> latencies, readLatencies, commitLatencies, GRVLatencies, mutationsPerCommit, bytesPerCommit;
 
@@ -176,6 +221,13 @@ public:
 	int mvCacheInsertLocation;
 	std::vector<std::pair<Version, Optional<Value>>> metadataVersionCache;
 
+	// The most recent read version obtained from a proxy, for transactions that accept a slightly stale read version.
+	// cachedReadVersionTime is when that version was requested, so the version includes every commit acknowledged
+	// before then.
+	Version cachedReadVersion;
+	double cachedReadVersionTime;
+	Optional<Value> cachedMetadataVersion;
+
 	HealthMetrics healthMetrics;
 	double healthMetricsLastUpdated;
 	double detailedHealthMetricsLastUpdated;
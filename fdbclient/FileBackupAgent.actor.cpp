@@ -545,6 +545,20 @@ namespace fileBackup {
 		Key lastValue;
 	};
 
+	ACTOR Future<Void> writeRangeFile(Reference<IBackupFile> file, int blockSize, KeyRange range, Standalone<VectorRef<KeyValueRef>> data) {
+		state RangeFileWriter rangeFile(file, blockSize);
+		wait(rangeFile.writeKey(range.begin));
+
+		state int i = 0;
+		for (; i < data.size(); ++i) {
+			wait(rangeFile.writeKV(data[i].key, data[i].value));
+		}
+
+		wait(rangeFile.writeKey(range.end));
+		wait(file->finish());
+		return Void();
+	}
+
 	// Helper class for reading restore data from a buffer and throwing the right errors.
 	struct StringRefReader {
 		StringRefReader(StringRef s = StringRef(), Error e = Error()) : rptr(s.begin()), end(s.end()), failure_error(e) {}
@@ -1010,7 +1024,12 @@ namespace fileBackup {
 		// Returns whether or not the caller should continue executing the task.
 		ACTOR static Future<bool> finishRangeFile(Reference<IBackupFile> file, Database cx, Reference<Task> task, Reference<TaskBucket> taskBucket, KeyRange range, Version version) {
 			wait(file->finish());
+			bool usedFile = wait(recordRangeFile(cx, task, taskBucket, range, version, file->getFileName(), file->size()));
+			return usedFile;
+		}
 
+		// Makes the range file fileName, which has already been finished, part of the backup as described in finishRangeFile().
+		ACTOR static Future<bool> recordRangeFile(Database cx, Reference<Task> task, Reference<TaskBucket> taskBucket, KeyRange range, Version version, std::string fileName, int64_t fileSize) {
 			// Ignore empty ranges.
 			if(range.empty())
 				return false;
@@ -1037,13 +1056,13 @@ namespace fileBackup {
 					state Version newTimeout = wait(taskBucket->extendTimeout(tr, task, true));
 
 					// Update the range bytes written in the backup config
-					backup.rangeBytesWritten().atomicOp(tr, file->size(), MutationRef::AddValue);
+					backup.rangeBytesWritten().atomicOp(tr, fileSize, MutationRef::AddValue);
 					backup.snapshotRangeFileCount().atomicOp(tr, 1, MutationRef::AddValue);
 
 					// See if there is already a file for this key which has an earlier begin, update the map if not.
 					Optional<BackupConfig::RangeSlice> s = wait(backup.snapshotRangeFileMap().get(tr, range.end));
 					if(!s.present() || s.get().begin >= range.begin) {
-						backup.snapshotRangeFileMap().set(tr, range.end, {range.begin, version, file->getFileName(), file->size()});
+						backup.snapshotRangeFileMap().set(tr, range.end, {range.begin, version, fileName, fileSize});
 						usedFile = true;
 					}
 
@@ -1075,6 +1094,98 @@ namespace fileBackup {
 			return key;
 		}
 
+		// Has a storage server holding [beginKey, endKey), which lies within one shard, write the range files for it
+		// directly to the backup container, so that the data does not pass through this agent.  The container must be
+		// reachable from the storage servers, so the caller only uses this for blob store containers.  Returns the key up to
+		// which the range has been backed up.  That is endKey unless a storage server could not export the rest, e.g.
+		// because the shard moved, in which case the caller reads the remainder itself.
+		ACTOR static Future<Key> exportRangeFromStorageServer(Database cx, Reference<TaskBucket> taskBucket, Reference<Task> task, Reference<IBackupContainer> bc, Key beginKey, Key endKey) {
+			state BackupConfig backup(task);
+
+			while(beginKey < endKey) {
+				state Reference<ReadYourWritesTransaction> tr(new ReadYourWritesTransaction(cx));
+				state Version snapshotBeginVersion;
+				state int64_t snapshotRangeFileCount;
+				state Version readVersion;
+				state Standalone<RangeResultRef> shards;
+				state std::vector<StorageServerInterface> servers;
+				loop {
+					try {
+						tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+						tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+
+						wait(taskBucket->keepRunning(tr, task)
+							&& storeOrThrow(snapshotBeginVersion, backup.snapshotBeginVersion().get(tr))
+							&& store(snapshotRangeFileCount, backup.snapshotRangeFileCount().getD(tr))
+							&& store(readVersion, tr->getReadVersion())
+							&& store(shards, krmGetRanges(tr, keyServersPrefix, KeyRangeRef(beginKey, endKey), 3))
+						);
+
+						std::vector<UID> src, dest;
+						decodeKeyServersValue(shards[0].value, src, dest);
+						state std::vector<Future<Optional<Value>>> serverListEntries;
+						for(auto& id : src) {
+							serverListEntries.push_back(tr->get(serverListKeyFor(id)));
+						}
+						wait(waitForAll(serverListEntries));
+
+						servers.clear();
+						for(auto& entry : serverListEntries) {
+							if(entry.get().present()) {
+								servers.push_back(decodeServerListValue(entry.get().get()));
+							}
+						}
+						break;
+					} catch(Error &e) {
+						wait(tr->onError(e));
+					}
+				}
+
+				if(servers.empty() || shards.size() != 2 || shards[1].key != endKey) {
+					// The range is no longer within one shard
+					return beginKey;
+				}
+
+				state BackupShardRequest req;
+				req.keys = KeyRangeRef(req.arena, KeyRangeRef(beginKey, endKey));
+				req.version = readVersion;
+				req.containerURL = bc->getURL();
+				req.snapshotBeginVersion = snapshotBeginVersion;
+				req.snapshotFileCount = snapshotRangeFileCount;
+				req.blockSize = BUGGIFY ? deterministicRandom()->randomInt(250e3, 4e6) : CLIENT_KNOBS->BACKUP_RANGEFILE_BLOCK_SIZE;
+
+				state StorageServerInterface server = deterministicRandom()->randomChoice(servers);
+				state ErrorOr<BackupShardReply> reply = wait(errorOr(timeoutError(server.backupShard.getReply(req), CLIENT_KNOBS->BACKUP_SHARD_EXPORT_TIMEOUT)));
+				if(reply.isError()) {
+					if(reply.getError().code() == error_code_actor_cancelled)
+						throw reply.getError();
+					TraceEvent(SevWarn, "FileBackupShardExportFailed")
+						.error(reply.getError())
+						.detail("BackupUID", backup.getUid())
+						.detail("StorageServer", server.id())
+						.detail("BeginKey", beginKey.printable())
+						.detail("EndKey", endKey.printable());
+					return beginKey;
+				}
+
+				bool usedFile = wait(recordRangeFile(cx, task, taskBucket, KeyRangeRef(beginKey, reply.get().end), readVersion, reply.get().fileName, reply.get().fileSize));
+				TraceEvent("FileBackupWroteRangeFile")
+					.suppressFor(60)
+					.detail("BackupUID", backup.getUid())
+					.detail("Size", reply.get().fileSize)
+					.detail("Keys", reply.get().keyCount)
+					.detail("ReadVersion", readVersion)
+					.detail("BeginKey", beginKey.printable())
+					.detail("EndKey", reply.get().end.printable())
+					.detail("AddedFileToMap", usedFile)
+					.detail("StorageServer", server.id());
+
+				beginKey = reply.get().end;
+			}
+
+			return endKey;
+		}
+
 		ACTOR static Future<Void> _execute(Database cx, Reference<TaskBucket> taskBucket, Reference<FutureBucket> futureBucket, Reference<Task> task) {
 			state Reference<FlowLock> lock(new FlowLock(CLIENT_KNOBS->BACKUP_LOCK_BYTES));
 
@@ -1102,6 +1213,32 @@ namespace fileBackup {
 				return Void();
 			}
 
+			state BackupConfig backup(task);
+
+			// Don't need to check keepRunning(task) here because we will do that while finishing each output file, but if bc
+			// is false then clearly the backup is no longer in progress
+			state Reference<IBackupContainer> bc = wait(backup.backupContainer().getD(cx));
+			if(!bc) {
+				return Void();
+			}
+
+			// A file:// container names a directory on this agent's machine, which a storage server may not see.  In
+			// simulation all processes share one file system.
+			if(CLIENT_KNOBS->BACKUP_SNAPSHOT_FROM_STORAGE_SERVERS && (bc->getURL().find("blobstore://") == 0 || g_network->isSimulated())) {
+				Key exportedEnd = wait(exportRangeFromStorageServer(cx, taskBucket, task, bc, beginKey, endKey));
+				TEST(exportedEnd != endKey); // Backup range task reads the rest of a range a storage server did not export
+				if(exportedEnd != endKey) {
+					TraceEvent(SevWarn, "FileBackupRangeExportFallback")
+						.suppressFor(60)
+						.detail("BackupUID", backup.getUid())
+						.detail("BeginKey", exportedEnd.printable())
+						.detail("EndKey", endKey.printable());
+				}
+				beginKey = exportedEnd;
+				if(beginKey == endKey)
+					return Void();
+			}
+
 			// Read everything from beginKey to endKey, write it to an output file, run the output file processor, and
 			// then set on_done. If we are still writing after X seconds, end the output file and insert a new backup_range
 			// task for the remainder.
@@ -1114,14 +1251,6 @@ namespace fileBackup {
 
 			state Future<Void> rc = readCommitted(cx, results, lock, KeyRangeRef(beginKey, endKey), true, true, true);
 			state RangeFileWriter rangeFile;
-			state BackupConfig backup(task);
-
-			// Don't need to check keepRunning(task) here because we will do that while finishing each output file, but if bc
-			// is false then clearly the backup is no longer in progress
-			state Reference<IBackupContainer> bc = wait(backup.backupContainer().getD(cx));
-			if(!bc) {
-				return Void();
-			}
 
 			state bool done = false;
 			state int64_t nrKeys = 0;
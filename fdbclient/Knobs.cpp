@@ -59,9 +59,13 @@ ClientKnobs::ClientKnobs(bool randomize) {
 	init( VALUE_SIZE_LIMIT,                        1e5 );
 	init( SPLIT_KEY_SIZE_LIMIT,                    KEY_SIZE_LIMIT/2 ); if( randomize && BUGGIFY ) SPLIT_KEY_SIZE_LIMIT = KEY_SIZE_LIMIT - 31;//serverKeysPrefixFor(UID()).size() - 1;
 	init( METADATA_VERSION_CACHE_SIZE,            1000 );
+	init( READ_CACHE_MAX_ENTRIES,                10000 ); if( randomize && BUGGIFY ) READ_CACHE_MAX_ENTRIES = 2;
 
 	init( MAX_BATCH_SIZE,                         1000 ); if( randomize && BUGGIFY ) MAX_BATCH_SIZE = 1;
 	init( GRV_BATCH_TIMEOUT,                     0.005 ); if( randomize && BUGGIFY ) GRV_BATCH_TIMEOUT = 0.1;
+	init( GRV_BATCH_LATENCY_FRACTION,              0.5 );
+	init( GRV_BATCH_LATENCY_SMOOTHING,             0.1 );
+	init( MAX_READ_VERSION_STALENESS,              1.0 ); if( randomize && BUGGIFY ) MAX_READ_VERSION_STALENESS = 0.01;
 	init( BROADCAST_BATCH_SIZE,                     20 ); if( randomize && BUGGIFY ) BROADCAST_BATCH_SIZE = 1;
 
 	init( LOCATION_CACHE_EVICTION_SIZE,         300000 );
@@ -100,6 +104,8 @@ ClientKnobs::ClientKnobs(bool randomize) {
 	init( TASKBUCKET_CHECK_ACTIVE_AMOUNT,           10 );
 	init( TASKBUCKET_TIMEOUT_VERSIONS,     60*CORE_VERSIONSPERSECOND ); if( randomize && BUGGIFY ) TASKBUCKET_TIMEOUT_VERSIONS = 30*CORE_VERSIONSPERSECOND;
 	init( TASKBUCKET_MAX_TASK_KEYS,               1000 ); if( randomize && BUGGIFY ) TASKBUCKET_MAX_TASK_KEYS = 20;
+	init( TASKBUCKET_MAX_TASKS_PER_CLAIM,            8 ); if( randomize && BUGGIFY ) TASKBUCKET_MAX_TASKS_PER_CLAIM = deterministicRandom()->randomInt(1, 4);
+	init( TASKBUCKET_CLAIM_PROBES_PER_TASK,          2 ); if( randomize && BUGGIFY ) TASKBUCKET_CLAIM_PROBES_PER_TASK = 1;
 
 	//Backup
 	init( BACKUP_CONCURRENT_DELETES,               100 );
@@ -111,6 +117,8 @@ ClientKnobs::ClientKnobs(bool randomize) {
 	init( BACKUP_SNAPSHOT_DISPATCH_INTERVAL_SEC,  10 * 60 );  // 10 minutes
 	init( BACKUP_DEFAULT_SNAPSHOT_INTERVAL_SEC,   3600 * 24 * 10); // 10 days
 	init( BACKUP_SHARD_TASK_LIMIT,                1000 ); if( randomize && BUGGIFY ) BACKUP_SHARD_TASK_LIMIT = 4;
+	init( BACKUP_SNAPSHOT_FROM_STORAGE_SERVERS,  false ); if( randomize && BUGGIFY ) BACKUP_SNAPSHOT_FROM_STORAGE_SERVERS = true;
+	init( BACKUP_SHARD_EXPORT_TIMEOUT,            60.0 );
 	init( BACKUP_AGGREGATE_POLL_RATE_UPDATE_INTERVAL, 60);
 	init( BACKUP_AGGREGATE_POLL_RATE,              2.0 ); // polls per second target for all agents on the cluster
 	init( BACKUP_LOG_WRITE_BATCH_MAX_SIZE,         1e6 ); //Must be much smaller than TRANSACTION_SIZE_LIMIT
@@ -164,10 +172,12 @@ ClientKnobs::ClientKnobs(bool randomize) {
 	init( BLOBSTORE_CONCURRENT_REQUESTS, BLOBSTORE_CONCURRENT_UPLOADS + BLOBSTORE_CONCURRENT_LISTS + 5);
 
 	init( BLOBSTORE_CONCURRENT_WRITES_PER_FILE,      5 );
-	init( BLOBSTORE_CONCURRENT_READS_PER_FILE,       3 );
+	init( BLOBSTORE_CHECKSUM_THREADS,                1 );
+	init( BLOBSTORE_CONCURRENT_READS_PER_FILE,       8 );
 	init( BLOBSTORE_READ_BLOCK_SIZE,       1024 * 1024 );
 	init( BLOBSTORE_READ_AHEAD_BLOCKS,               0 );
 	init( BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE,      2 );
+	init( BLOBSTORE_READ_AHEAD_MAX_BLOCKS,           8 );
 	init( BLOBSTORE_MULTIPART_MAX_PART_SIZE,  20000000 );
 	init( BLOBSTORE_MULTIPART_MIN_PART_SIZE,   5242880 );
 
@@ -57,9 +57,13 @@ public:
 	int64_t VALUE_SIZE_LIMIT;
 	int64_t SPLIT_KEY_SIZE_LIMIT;
 	int METADATA_VERSION_CACHE_SIZE;
+	int READ_CACHE_MAX_ENTRIES;
 
 	int MAX_BATCH_SIZE;
 	double GRV_BATCH_TIMEOUT;
+	double GRV_BATCH_LATENCY_FRACTION; // The batch window targets this fraction of the observed GRV latency
+	double GRV_BATCH_LATENCY_SMOOTHING;
+	double MAX_READ_VERSION_STALENESS; // Upper bound on the read_version_max_staleness transaction option
 	int BROADCAST_BATCH_SIZE;
 
 	// When locationCache in DatabaseContext gets to be this size, items will be evicted
@@ -102,6 +106,8 @@ public:
 	int TASKBUCKET_CHECK_ACTIVE_AMOUNT;
 	int TASKBUCKET_TIMEOUT_VERSIONS;
 	int TASKBUCKET_MAX_TASK_KEYS;
+	int TASKBUCKET_MAX_TASKS_PER_CLAIM;
+	int TASKBUCKET_CLAIM_PROBES_PER_TASK;
 
 	// Backup
 	int BACKUP_CONCURRENT_DELETES;
@@ -113,6 +119,8 @@ public:
 	int BACKUP_SNAPSHOT_DISPATCH_INTERVAL_SEC;
 	int BACKUP_DEFAULT_SNAPSHOT_INTERVAL_SEC;
 	int BACKUP_SHARD_TASK_LIMIT;
+	bool BACKUP_SNAPSHOT_FROM_STORAGE_SERVERS; // Storage servers write snapshot range files to the backup container
+	double BACKUP_SHARD_EXPORT_TIMEOUT;
 	double BACKUP_AGGREGATE_POLL_RATE;
 	double BACKUP_AGGREGATE_POLL_RATE_UPDATE_INTERVAL;
 	int BACKUP_LOG_WRITE_BATCH_MAX_SIZE;
@@ -173,10 +181,12 @@ public:
 	int BLOBSTORE_CONCURRENT_UPLOADS;
 	int BLOBSTORE_CONCURRENT_LISTS;
 	int BLOBSTORE_CONCURRENT_WRITES_PER_FILE;
+	int BLOBSTORE_CHECKSUM_THREADS;
 	int BLOBSTORE_CONCURRENT_READS_PER_FILE;
 	int BLOBSTORE_READ_BLOCK_SIZE;
 	int BLOBSTORE_READ_AHEAD_BLOCKS;
 	int BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE;
+	int BLOBSTORE_READ_AHEAD_MAX_BLOCKS;
 	int BLOBSTORE_MAX_SEND_BYTES_PER_SECOND;
 	int BLOBSTORE_MAX_RECV_BYTES_PER_SECOND;
 
@@ -26,6 +26,9 @@
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/CoordinationInterface.h"
 #include "fdbclient/DatabaseContext.h"
+#include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/BackupContainer.h"
+#include "fdbclient/BackupAgent.actor.h"
 #include "fdbrpc/simulator.h"
 #include "fdbclient/StatusClient.h"
 #include "flow/UnitTest.h"
@@ -1714,6 +1717,107 @@ ACTOR Future<Void> waitForPrimaryDC( Database cx, StringRef dcId ) {
 	}
 }
 
+// Returns the key range covered by a range file, which is bounded by the first key of its first block and the last key
+// of its last block
+ACTOR Future<KeyRange> getRangeFileKeys( Reference<IBackupContainer> bc, RangeFile f ) {
+	state Reference<IAsyncFile> file = wait( bc->readFile(f.fileName) );
+	state int64_t lastBlock = ((f.fileSize - 1) / f.blockSize) * f.blockSize;
+	state Standalone<VectorRef<KeyValueRef>> first = wait( fileBackup::decodeRangeFileBlock(file, 0, std::min<int64_t>(f.blockSize, f.fileSize)) );
+	Standalone<VectorRef<KeyValueRef>> last = wait( fileBackup::decodeRangeFileBlock(file, lastBlock, std::min<int64_t>(f.blockSize, f.fileSize - lastBlock)) );
+	return KeyRangeRef(first.front().key, last.back().key);
+}
+
+ACTOR Future<Void> bulkLoad( Database cx, std::string containerUrl, KeyRange keys ) {
+	state Reference<IBackupContainer> bc = IBackupContainer::openContainer(containerUrl);
+	BackupDescription desc = wait( bc->describeBackup() );
+
+	// Only a single-version snapshot is consistent without replaying mutation logs on top of it
+	state Optional<Version> snapshotVersion;
+	for(auto& s : desc.snapshots) {
+		if( s.isSingleVersion() && (!snapshotVersion.present() || s.endVersion > snapshotVersion.get()) ) {
+			snapshotVersion = s.endVersion;
+		}
+	}
+	if( !snapshotVersion.present() ) {
+		throw restore_missing_data();
+	}
+
+	Optional<RestorableFileSet> restoreSet = wait( bc->getRestoreSet(snapshotVersion.get()) );
+	if( !restoreSet.present() ) {
+		throw restore_missing_data();
+	}
+
+	state std::vector<RangeFile> files;
+	state std::vector<Future<KeyRange>> fileKeys;
+	for(auto& f : restoreSet.get().ranges) {
+		if( f.fileSize > 0 ) {
+			files.push_back(f);
+			fileKeys.push_back( getRangeFileKeys(bc, f) );
+		}
+	}
+	wait( waitForAll(fileKeys) );
+	state DatabaseConfiguration config = wait( getDatabaseConfiguration(cx) );
+
+	state Transaction tr(cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			// Data distribution can only publish the files by moving each range to a team disjoint from its current one
+			Standalone<RangeResultRef> servers = wait( tr.getRange(serverListKeys, CLIENT_KNOBS->TOO_MANY) );
+			ASSERT( !servers.more && servers.size() < CLIENT_KNOBS->TOO_MANY );
+			if( servers.size() < 2 * config.storageTeamSize ) {
+				TraceEvent(SevWarnAlways, "BulkLoadNoDestination").detail("StorageServers", servers.size()).detail("StorageTeamSize", config.storageTeamSize);
+				throw bulk_load_no_destination();
+			}
+
+			state Future<Standalone<RangeResultRef>> registered = krmGetRanges(&tr, bulkLoadPrefix, keys);
+			Standalone<RangeResultRef> existing = wait( tr.getRange(keys, 1) );
+			if( existing.size() ) {
+				throw restore_destination_not_empty();
+			}
+			wait( success(registered) );
+			for(auto& r : registered.get()) {
+				if( r.value.size() ) {
+					throw restore_destination_not_empty();
+				}
+			}
+
+			state int i;
+			for(i = 0; i < files.size(); i++) {
+				KeyRange range = fileKeys[i].get() & keys;
+				if( !range.empty() ) {
+					wait( krmSetRange(&tr, bulkLoadPrefix, range, bulkLoadValue(containerUrl, files[i].fileName, files[i].fileSize, files[i].blockSize)) );
+				}
+			}
+			wait( tr.commit() );
+			TraceEvent("BulkLoadRegistered").detail("Container", containerUrl).detail("Version", snapshotVersion.get()).detail("Files", files.size())
+				.detail("Begin", printable(keys.begin)).detail("End", printable(keys.end));
+			break;
+		} catch( Error &e ) {
+			wait( tr.onError(e) );
+		}
+	}
+
+	// Data distribution clears each registration in the same transaction which makes its range visible
+	loop {
+		tr.reset();
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			Standalone<RangeResultRef> registered = wait( krmGetRanges(&tr, bulkLoadPrefix, keys) );
+			bool pending = registered.more;
+			for(auto& r : registered) {
+				pending = pending || r.value.size();
+			}
+			if( !pending ) {
+				return Void();
+			}
+			wait( delay(1.0) );
+		} catch( Error &e ) {
+			wait( tr.onError(e) );
+		}
+	}
+}
+
 json_spirit::Value_type normJSONType(json_spirit::Value_type type) {
 	if (type == json_spirit::int_type)
 		return json_spirit::real_type;
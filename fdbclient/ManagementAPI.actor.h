@@ -185,6 +185,14 @@ ACTOR Future<Void> setHealthyZone( Database cx, StringRef zoneId, double seconds
 
 ACTOR Future<Void> waitForPrimaryDC( Database  cx, StringRef  dcId );
 
+// Loads the latest single-version snapshot in the given backup container into keys, which must be empty, by having
+// storage servers ingest its range files directly.  Returns once all of the data is visible.
+// Each range is ingested by a team disjoint from the one currently holding it, so this throws bulk_load_no_destination
+// if there are fewer than twice storageTeamSize storage servers.  With enough servers it waits for data distribution,
+// which keeps retrying while exclusions or the replication policy leave no such team.  Keys must not be written to until
+// this returns: data distribution does not load a range which has been written to, and moves it as usual instead.
+ACTOR Future<Void> bulkLoad( Database cx, std::string containerUrl, KeyRange keys );
+
 // Gets the cluster connection string
 ACTOR Future<std::vector<NetworkAddress>> getCoordinators( Database  cx );
 
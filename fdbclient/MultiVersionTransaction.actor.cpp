@@ -25,6 +25,14 @@
 #include "flow/Platform.h"
 #include "flow/UnitTest.h"
 
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#endif
+
 #include "flow/actorcompiler.h"  // This must be the last #include.
 
 void throwIfError(FdbCApi::fdb_error_t e) {
@@ -247,7 +255,7 @@ void loadClientFunction(T *fp, void *lib, std::string libPath, const char *funct
 	}
 }
 
-DLApi::DLApi(std::string fdbCPath) : api(new FdbCApi()), fdbCPath(fdbCPath), networkSetup(false) {}
+DLApi::DLApi(std::string fdbCPath, bool unlinkOnLoad) : api(new FdbCApi()), fdbCPath(fdbCPath), unlinkOnLoad(unlinkOnLoad), networkSetup(false) {}
 
 void DLApi::init() {
 	if(isLibraryLoaded(fdbCPath.c_str())) {
@@ -257,9 +265,17 @@ void DLApi::init() {
 	void* lib = loadLibrary(fdbCPath.c_str());
 	if(lib == NULL) {
 		TraceEvent(SevError, "ErrorLoadingExternalClientLibrary").detail("LibraryPath", fdbCPath);
+		if(unlinkOnLoad) {
+			deleteFile(fdbCPath);
+		}
 		throw platform_error();
 	}
 
+	if(unlinkOnLoad) {
+		// The library is a private copy that stays mapped until the process exits
+		deleteFile(fdbCPath);
+	}
+
 	loadClientFunction(&api->selectApiVersion, lib, fdbCPath, "fdb_select_api_version_impl");
 	loadClientFunction(&api->getClientVersion, lib, fdbCPath, "fdb_get_client_version", headerVersion >= 410);
 	loadClientFunction(&api->setNetworkOption, lib, fdbCPath, "fdb_network_set_option");
@@ -643,7 +659,7 @@ void MultiVersionTransaction::reset() {
 }
 
 // MultiVersionDatabase
-MultiVersionDatabase::MultiVersionDatabase(MultiVersionApi *api, std::string clusterFilePath, Reference<IDatabase> db, bool openConnectors) : dbState(new DatabaseState()) {
+MultiVersionDatabase::MultiVersionDatabase(MultiVersionApi *api, int threadIdx, std::string clusterFilePath, Reference<IDatabase> db, bool openConnectors) : dbState(new DatabaseState()) {
 	dbState->db = db;
 	dbState->dbVar->set(db);
 
@@ -659,8 +675,10 @@ MultiVersionDatabase::MultiVersionDatabase(MultiVersionApi *api, std::string clu
 			dbState->currentClientIndex = -1;
 		}
 
-		api->runOnExternalClients([this, clusterFilePath](Reference<ClientInfo> client) {
-			dbState->addConnection(client, clusterFilePath);
+		api->runOnExternalClients([this, threadIdx, clusterFilePath](Reference<ClientInfo> client) {
+			if(client->threadIndex == threadIdx) {
+				dbState->addConnection(client, clusterFilePath);
+			}
 		});
 
 		dbState->startConnections();
@@ -672,7 +690,7 @@ MultiVersionDatabase::~MultiVersionDatabase() {
 }
 
 Reference<IDatabase> MultiVersionDatabase::debugCreateFromExistingDatabase(Reference<IDatabase> db) {
-	return Reference<IDatabase>(new MultiVersionDatabase(MultiVersionApi::api, "", db, false));
+	return Reference<IDatabase>(new MultiVersionDatabase(MultiVersionApi::api, 0, "", db, false));
 }
 
 Reference<ITransaction> MultiVersionDatabase::createTransaction() {
@@ -993,6 +1011,68 @@ void MultiVersionApi::disableLocalClient() {
 	localClientDisabled = true;
 }
 
+void MultiVersionApi::setClientThreadsPerVersion(int64_t threadCount) {
+	MutexHolder holder(lock);
+	if(networkStartSetup || bypassMultiClientApi) {
+		throw invalid_option();
+	}
+	this->threadCount = threadCount;
+}
+
+// Loading the same path twice returns the handle that is already loaded, so each additional network thread gets a
+// private copy of the library in the temporary directory. The copy is unlinked as soon as it has been loaded.
+static std::string copyExternalLibrary(std::string const& libPath, int threadIndex) {
+	std::string tempDir;
+#ifdef _WIN32
+	if(!platform::getEnvironmentVar("TEMP", tempDir)) {
+		tempDir = ".";
+	}
+#else
+	if(!platform::getEnvironmentVar("TMPDIR", tempDir)) {
+		tempDir = "/tmp";
+	}
+#endif
+
+	std::string contents = readFileBytes(libPath, std::numeric_limits<int>::max());
+
+	// The copy is created exclusively under an unpredictable name, so that no other user can have put a file or symlink
+	// of their own in its place before it is loaded
+#ifdef _WIN32
+	std::string copyPath = joinPath(tempDir, format("%s-%d-%08x", basename(libPath).c_str(), threadIndex, uint32_t(platform::getRandomSeed())));
+	int fd = _open(copyPath.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+	FILE* f = fd < 0 ? NULL : _fdopen(fd, "wb");
+#else
+	std::string copyPath = joinPath(tempDir, format("%s-%d-XXXXXX", basename(libPath).c_str(), threadIndex));
+	int fd = mkstemp(&copyPath[0]);
+	FILE* f = fd < 0 ? NULL : fdopen(fd, "wb");
+#endif
+	if(f == NULL) {
+		TraceEvent(SevError, "ErrorCopyingExternalClientLibrary").detail("LibraryPath", libPath).detail("CopyPath", copyPath).GetLastError();
+		throw platform_error();
+	}
+
+	bool written = fwrite(contents.data(), 1, contents.size(), f) == contents.size();
+	if(fclose(f) != 0 || !written) {
+		TraceEvent(SevError, "ErrorCopyingExternalClientLibrary").detail("LibraryPath", libPath).detail("CopyPath", copyPath).GetLastError();
+		deleteFile(copyPath);
+		throw platform_error();
+	}
+	return copyPath;
+}
+
+void MultiVersionApi::addExternalClientThreads() {
+	ASSERT(threadCount > 1);
+
+	std::vector<std::pair<std::string, Reference<ClientInfo>>> originals(externalClients.begin(), externalClients.end());
+	for(auto &it : originals) {
+		for(int i = 1; i < threadCount; i++) {
+			TraceEvent("AddingExternalClientThread").detail("LibraryPath", it.first).detail("ThreadIndex", i);
+			std::string copyPath = copyExternalLibrary(it.second->libPath, i);
+			externalClients[format("%s/%d", it.first.c_str(), i)] = Reference<ClientInfo>(new ClientInfo(new DLApi(copyPath, true), it.second->libPath, i));
+		}
+	}
+}
+
 void MultiVersionApi::setSupportedClientVersions(Standalone<StringRef> versions) {
 	MutexHolder holder(lock);
 	ASSERT(networkSetup);
@@ -1047,6 +1127,10 @@ void MultiVersionApi::setNetworkOptionInternal(FDBNetworkOptions::Option option,
 		validateOption(value, false, true);
 		disableLocalClient();
 	}
+	else if(option == FDBNetworkOptions::CLIENT_THREADS_PER_VERSION) {
+		validateOption(value, true, false, false);
+		setClientThreadsPerVersion(extractIntOption(value, 1, std::numeric_limits<int>::max()));
+	}
 	else if(option == FDBNetworkOptions::SUPPORTED_CLIENT_VERSIONS) {
 		ASSERT(value.present());
 		setSupportedClientVersions(value.get());
@@ -1088,6 +1172,18 @@ void MultiVersionApi::setupNetwork() {
 
 		networkStartSetup = true;
 
+		if(threadCount > 1) {
+			if(externalClients.empty()) {
+				TraceEvent(SevWarnAlways, "ClientThreadsPerVersionIgnored").detail("ThreadCount", threadCount).detail("Reason", "No external client libraries");
+				threadCount = 1;
+			}
+			else {
+				// The local client has a single network thread, so it cannot serve databases assigned to other threads
+				localClientDisabled = true;
+				addExternalClientThreads();
+			}
+		}
+
 		if(externalClients.empty()) {
 			bypassMultiClientApi = true; // SOMEDAY: we won't be able to set this option once it becomes possible to add clients after setupNetwork is called
 		}
@@ -1209,7 +1305,13 @@ Reference<IDatabase> MultiVersionApi::createDatabase(const char *clusterFilePath
 
 	std::string clusterFile(clusterFilePath);
 	if(localClientDisabled) {
-		return Reference<IDatabase>(new MultiVersionDatabase(this, clusterFile, Reference<IDatabase>()));
+		int threadIdx = 0;
+		if(threadCount > 1) {
+			MutexHolder holder(lock);
+			threadIdx = nextThread;
+			nextThread = (nextThread + 1) % threadCount;
+		}
+		return Reference<IDatabase>(new MultiVersionDatabase(this, threadIdx, clusterFile, Reference<IDatabase>()));
 	}
 
 	auto db = localClient->api->createDatabase(clusterFilePath);
@@ -1220,7 +1322,7 @@ Reference<IDatabase> MultiVersionApi::createDatabase(const char *clusterFilePath
 		for(auto it : externalClients) {
 			TraceEvent("CreatingDatabaseOnExternalClient").detail("LibraryPath", it.second->libPath).detail("Failed", it.second->failed);
 		}
-		return Reference<IDatabase>(new MultiVersionDatabase(this, clusterFile, db));
+		return Reference<IDatabase>(new MultiVersionDatabase(this, 0, clusterFile, db));
 	}
 }
 
@@ -1229,6 +1331,9 @@ void MultiVersionApi::updateSupportedVersions() {
 		Standalone<VectorRef<uint8_t>> versionStr;
 
 		runOnExternalClients([&versionStr](Reference<ClientInfo> client){
+			if(client->threadIndex != 0) {
+				return;
+			}
 			const char *ver = client->api->getClientVersion();
 			versionStr.append(versionStr.arena(), (uint8_t*)ver, (int)strlen(ver));
 			versionStr.append(versionStr.arena(), (uint8_t*)";", 1);
@@ -1323,7 +1428,7 @@ void MultiVersionApi::loadEnvironmentVariableNetworkOptions() {
 	envOptionsLoaded = true;
 }
 
-MultiVersionApi::MultiVersionApi() : bypassMultiClientApi(false), networkStartSetup(false), networkSetup(false), callbackOnMainThread(true), externalClient(false), localClientDisabled(false), apiVersion(0), envOptionsLoaded(false) {}
+MultiVersionApi::MultiVersionApi() : bypassMultiClientApi(false), networkStartSetup(false), networkSetup(false), callbackOnMainThread(true), externalClient(false), localClientDisabled(false), threadCount(1), nextThread(0), apiVersion(0), envOptionsLoaded(false) {}
 
 MultiVersionApi* MultiVersionApi::api = new MultiVersionApi();
 
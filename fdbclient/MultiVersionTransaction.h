@@ -179,7 +179,7 @@ private:
 
 class DLApi : public IClientApi {
 public:
-	DLApi(std::string fdbCPath);
+	DLApi(std::string fdbCPath, bool unlinkOnLoad = false);
 
 	void selectApiVersion(int apiVersion);
 	const char* getClientVersion();
@@ -197,6 +197,7 @@ public:
 private:
 	const std::string fdbCPath;
 	const Reference<FdbCApi> api;
+	const bool unlinkOnLoad;
 	int headerVersion;
 	bool networkSetup;
 
@@ -272,11 +273,12 @@ struct ClientInfo : ThreadSafeReferenceCounted<ClientInfo> {
 	std::string libPath;
 	bool external;
 	bool failed;
+	int threadIndex; // Which of the network threads for this library version the client runs
 	std::vector<std::pair<void (*)(void*), void*>> threadCompletionHooks;
 
-	ClientInfo() : protocolVersion(0), api(NULL), external(false), failed(true) {}
-	ClientInfo(IClientApi *api) : protocolVersion(0), api(api), libPath("internal"), external(false), failed(false) {}
-	ClientInfo(IClientApi *api, std::string libPath) : protocolVersion(0), api(api), libPath(libPath), external(true), failed(false) {}
+	ClientInfo() : protocolVersion(0), api(NULL), external(false), failed(true), threadIndex(0) {}
+	ClientInfo(IClientApi *api) : protocolVersion(0), api(api), libPath("internal"), external(false), failed(false), threadIndex(0) {}
+	ClientInfo(IClientApi *api, std::string libPath, int threadIndex = 0) : protocolVersion(0), api(api), libPath(libPath), external(true), failed(false), threadIndex(threadIndex) {}
 
 	void loadProtocolVersion();
 	bool canReplace(Reference<ClientInfo> other) const;
@@ -286,7 +288,7 @@ class MultiVersionApi;
 
 class MultiVersionDatabase : public IDatabase, ThreadSafeReferenceCounted<MultiVersionDatabase> {
 public:
-	MultiVersionDatabase(MultiVersionApi *api, std::string clusterFilePath, Reference<IDatabase> db, bool openConnectors=true);
+	MultiVersionDatabase(MultiVersionApi *api, int threadIdx, std::string clusterFilePath, Reference<IDatabase> db, bool openConnectors=true);
 	~MultiVersionDatabase();
 
 	Reference<ITransaction> createTransaction();
@@ -386,6 +388,8 @@ private:
 	void addExternalLibrary(std::string path);
 	void addExternalLibraryDirectory(std::string path);
 	void disableLocalClient();
+	void setClientThreadsPerVersion(int64_t threadCount);
+	void addExternalClientThreads();
 	void setSupportedClientVersions(Standalone<StringRef> versions);
 
 	void setNetworkOptionInternal(FDBNetworkOptions::Option option, Optional<StringRef> value);
@@ -393,6 +397,9 @@ private:
 	Reference<ClientInfo> localClient;
 	std::map<std::string, Reference<ClientInfo>> externalClients;
 
+	int threadCount; // Number of network threads started for each external client library
+	int nextThread; // The thread that the next database will be assigned to
+
 	bool networkStartSetup;
 	volatile bool networkSetup;
 	volatile bool bypassMultiClientApi;
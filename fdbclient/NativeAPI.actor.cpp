@@ -238,7 +238,8 @@ ACTOR Future<Void> databaseLogger( DatabaseContext *cx ) {
 			.detail("MaxMutationsPerCommit", cx->mutationsPerCommit.max())
 			.detail("MeanBytesPerCommit", cx->bytesPerCommit.mean())
 			.detail("MedianBytesPerCommit", cx->bytesPerCommit.median())
-			.detail("MaxBytesPerCommit", cx->bytesPerCommit.max());
+			.detail("MaxBytesPerCommit", cx->bytesPerCommit.max())
+			.detail("ReadCacheEntries", cx->readCache.values.size());
 
 		cx->latencies.clear();
 		cx->readLatencies.clear();
@@ -514,8 +515,9 @@ DatabaseContext::DatabaseContext(
 	transactionCommittedMutations("CommittedMutations", cc), transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionsCommitStarted("CommitStarted", cc), 
 	transactionsCommitCompleted("CommitCompleted", cc), transactionsTooOld("TooOld", cc), transactionsFutureVersions("FutureVersions", cc), 
 	transactionsNotCommitted("NotCommitted", cc), transactionsMaybeCommitted("MaybeCommitted", cc), transactionsResourceConstrained("ResourceConstrained", cc), 
-	transactionsProcessBehind("ProcessBehind", cc), transactionWaitsForFullRecovery("WaitsForFullRecovery", cc), outstandingWatches(0),
+	transactionsProcessBehind("ProcessBehind", cc), transactionWaitsForFullRecovery("WaitsForFullRecovery", cc), transactionReadCacheHits("ReadCacheHits", cc), transactionReadCacheMisses("ReadCacheMisses", cc), transactionReadVersionsReused("ReadVersionsReused", cc), outstandingWatches(0),
 	latencies(1000), readLatencies(1000), commitLatencies(1000), GRVLatencies(1000), mutationsPerCommit(1000), bytesPerCommit(1000), mvCacheInsertLocation(0),
+	cachedReadVersion(invalidVersion), cachedReadVersionTime(0),
 	healthMetricsLastUpdated(0), detailedHealthMetricsLastUpdated(0), internal(internal)
 {
 	dbId = deterministicRandom()->randomUniqueID();
@@ -542,8 +544,8 @@ DatabaseContext::DatabaseContext( const Error &err ) : deferredError(err), cc("T
 	transactionCommittedMutations("CommittedMutations", cc), transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionsCommitStarted("CommitStarted", cc), 
 	transactionsCommitCompleted("CommitCompleted", cc), transactionsTooOld("TooOld", cc), transactionsFutureVersions("FutureVersions", cc), 
 	transactionsNotCommitted("NotCommitted", cc), transactionsMaybeCommitted("MaybeCommitted", cc), transactionsResourceConstrained("ResourceConstrained", cc), 
-	transactionsProcessBehind("ProcessBehind", cc), transactionWaitsForFullRecovery("WaitsForFullRecovery", cc), latencies(1000), readLatencies(1000), commitLatencies(1000), 
-	GRVLatencies(1000), mutationsPerCommit(1000), bytesPerCommit(1000), 
+	transactionsProcessBehind("ProcessBehind", cc), transactionWaitsForFullRecovery("WaitsForFullRecovery", cc), transactionReadCacheHits("ReadCacheHits", cc), transactionReadCacheMisses("ReadCacheMisses", cc), transactionReadVersionsReused("ReadVersionsReused", cc), latencies(1000), readLatencies(1000), commitLatencies(1000), 
+	GRVLatencies(1000), mutationsPerCommit(1000), bytesPerCommit(1000), cachedReadVersion(invalidVersion), cachedReadVersionTime(0),
 	internal(false) {}
 
 ACTOR static Future<Void> monitorClientInfo( Reference<AsyncVar<Optional<ClusterInterface>>> clusterInterface, Reference<ClusterConnectionFile> ccf, Reference<AsyncVar<ClientDBInfo>> outInfo, Reference<AsyncVar<int>> connectedCoordinatorsNumDelayed ) {
@@ -792,6 +794,10 @@ void DatabaseContext::setOption( FDBDatabaseOptions::Option option, Optional<Str
 				validateOptionValue(value, false);
 				snapshotRywEnabled--;
 				break;
+			case FDBDatabaseOptions::READ_CACHE_PREFIX:
+				validateOptionValue(value, true);
+				readCache.prefixes.push_back(value.get());
+				break;
 			default:
 				break;
 		}
@@ -1207,6 +1213,33 @@ Future<Standalone<RangeResultRef>> getRange(
 ACTOR Future<Optional<Value>> getValue(Future<Version> version, Key key, Database cx, TransactionInfo info,
                                        Reference<TransactionLogInfo> trLogInfo);
 
+// Reads a key through the database's read cache.  The cache can only be used if the metadata version at the read version
+// is known, which is not the case if the read version was set explicitly.
+ACTOR Future<Optional<Value>> getCachedValue( Future<Version> version, Future<Optional<Value>> metadataVersion, Key key, Database cx, TransactionInfo info, Reference<TransactionLogInfo> trLogInfo )
+{
+	state Version ver = wait( version );
+	if(!metadataVersion.isReady() || metadataVersion.isError()) {
+		Optional<Value> value = wait( getValue( ver, key, cx, info, trLogInfo ) );
+		return value;
+	}
+
+	state Optional<Value> mv = metadataVersion.get();
+	if(cx->readCache.validFor(ver, mv)) {
+		auto it = cx->readCache.values.find(key);
+		if(it != cx->readCache.values.end()) {
+			++cx->transactionReadCacheHits;
+			return it->second;
+		}
+	}
+
+	++cx->transactionReadCacheMisses;
+	Optional<Value> value = wait( getValue( ver, key, cx, info, trLogInfo ) );
+	// The cache may have moved on to a newer metadata version while the read was outstanding
+	if(cx->readCache.validFor(ver, mv))
+		cx->readCache.insert(key, value, CLIENT_KNOBS->READ_CACHE_MAX_ENTRIES);
+	return value;
+}
+
 ACTOR Future<Optional<StorageServerInterface>> fetchServerInterface( Database cx, TransactionInfo info, UID id, Future<Version> ver = latestVersion ) {
 	Optional<Value> val = wait( getValue(ver, serverListKeyFor(id), cx, info, Reference<TransactionLogInfo>()) );
 	if( !val.present() ) {
@@ -2138,6 +2171,9 @@ Future<Optional<Value>> Transaction::get( const Key& key, bool snapshot ) {
 		}
 	}
 
+	if(!cx->readCache.prefixes.empty() && cx->readCache.covers(key))
+		return getCachedValue( ver, metadataVersion.getFuture(), key, cx, info, trLogInfo );
+
 	return getValue( ver, key, cx, info, trLogInfo );
 }
 
@@ -3058,6 +3094,11 @@ void Transaction::setOption( FDBTransactionOptions::Option option, Optional<Stri
 			info.useProvisionalProxies = true;
 			break;
 
+		case FDBTransactionOptions::READ_VERSION_MAX_STALENESS:
+			validateOptionValue(value, true);
+			options.maxReadVersionStaleness = std::min<double>(extractIntOption(value, 0, std::numeric_limits<int>::max()) / 1000.0, CLIENT_KNOBS->MAX_READ_VERSION_STALENESS);
+			break;
+
 		default:
 			break;
 	}
@@ -3123,8 +3164,8 @@ ACTOR Future<Void> readVersionBatcher( DatabaseContext *cx, FutureStream< std::p
 			}
 			// dynamic batching monitors reply latencies
 			when(double reply_latency = waitNext(replyTimes.getFuture())){
-				double target_latency = reply_latency * 0.5;
-				batchTime = min(0.1 * target_latency + 0.9 * batchTime, CLIENT_KNOBS->GRV_BATCH_TIMEOUT);
+				double target_latency = reply_latency * CLIENT_KNOBS->GRV_BATCH_LATENCY_FRACTION;
+				batchTime = min(CLIENT_KNOBS->GRV_BATCH_LATENCY_SMOOTHING * target_latency + (1 - CLIENT_KNOBS->GRV_BATCH_LATENCY_SMOOTHING) * batchTime, CLIENT_KNOBS->GRV_BATCH_TIMEOUT);
 			}
 			when(wait(collection)){} // for errors
 		}
@@ -3149,7 +3190,7 @@ ACTOR Future<Void> readVersionBatcher( DatabaseContext *cx, FutureStream< std::p
 	}
 }
 
-ACTOR Future<Version> extractReadVersion(DatabaseContext* cx, Reference<TransactionLogInfo> trLogInfo, Future<GetReadVersionReply> f, bool lockAware, double startTime, Promise<Optional<Value>> metadataVersion) {
+ACTOR Future<Version> extractReadVersion(DatabaseContext* cx, Reference<TransactionLogInfo> trLogInfo, Future<GetReadVersionReply> f, uint32_t flags, bool lockAware, double startTime, Promise<Optional<Value>> metadataVersion) {
 	GetReadVersionReply rep = wait(f);
 	double latency = now() - startTime;
 	cx->GRVLatencies.addSample(latency);
@@ -3158,6 +3199,14 @@ ACTOR Future<Version> extractReadVersion(DatabaseContext* cx, Reference<Transact
 	if(rep.locked && !lockAware)
 		throw database_locked();
 
+	// Versions that might not be committed, or that come from a locked database, are not shared with other transactions
+	if(!rep.locked && !(flags & (GetReadVersionRequest::FLAG_CAUSAL_READ_RISKY | GetReadVersionRequest::FLAG_USE_PROVISIONAL_PROXIES)) &&
+	   startTime > cx->cachedReadVersionTime && rep.version >= cx->cachedReadVersion) {
+		cx->cachedReadVersion = rep.version;
+		cx->cachedReadVersionTime = startTime;
+		cx->cachedMetadataVersion = rep.metadataVersion;
+	}
+
 	if(rep.version > cx->metadataVersionCache[cx->mvCacheInsertLocation].first) {
 		cx->mvCacheInsertLocation = (cx->mvCacheInsertLocation + 1)%cx->metadataVersionCache.size();
 		cx->metadataVersionCache[cx->mvCacheInsertLocation] = std::make_pair(rep.version, rep.metadataVersion);
@@ -3176,10 +3225,18 @@ Future<Version> Transaction::getReadVersion(uint32_t flags) {
 		batcher.actor = readVersionBatcher( cx.getPtr(), batcher.stream.getFuture(), flags );
 	}
 	if (!readVersion.isValid()) {
+		startTime = now();
+		if(options.maxReadVersionStaleness > 0 && cx->cachedReadVersion != invalidVersion &&
+		   startTime - cx->cachedReadVersionTime <= options.maxReadVersionStaleness) {
+			++cx->transactionReadVersionsReused;
+			metadataVersion.send(cx->cachedMetadataVersion);
+			readVersion = cx->cachedReadVersion;
+			return readVersion;
+		}
+
 		Promise<GetReadVersionReply> p;
 		batcher.stream.send( std::make_pair( p, info.debugID ) );
-		startTime = now();
-		readVersion = extractReadVersion( cx.getPtr(), trLogInfo, p.getFuture(), options.lockAware, startTime, metadataVersion);
+		readVersion = extractReadVersion( cx.getPtr(), trLogInfo, p.getFuture(), flags, options.lockAware, startTime, metadataVersion);
 	}
 	return readVersion;
 }
@@ -3195,6 +3252,10 @@ Future<Void> Transaction::onError( Error const& e ) {
 	if (e.code() == error_code_success) {
 		return client_invalid_operation();
 	}
+	if (e.code() == error_code_not_committed || e.code() == error_code_transaction_too_old) {
+		// Retrying with the same stale read version would likely fail the same way
+		options.maxReadVersionStaleness = 0;
+	}
 	if (e.code() == error_code_not_committed ||
 		e.code() == error_code_commit_unknown_result ||
 		e.code() == error_code_database_locked ||
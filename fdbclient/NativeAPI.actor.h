@@ -147,6 +147,8 @@ struct StorageMetrics;
 
 struct TransactionOptions {
 	double maxBackoff;
+	double maxReadVersionStaleness; // Seconds; a cached read version at most this old may be reused
+
 	uint32_t getReadVersionFlags;
 	uint32_t sizeLimit;
 	int maxTransactionLoggingFieldLength;
@@ -138,6 +138,28 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
                   },
                   "commit_latency_bands":{
                      "$map": 1
+                  },
+                  "commit_stage_latency":{
+                     "$map":{
+                        "count":0,
+                        "mean":0.0,
+                        "median":0.0,
+                        "p90":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0,
+                        "max":0.0
+                     }
+                  },
+                  "grv_stage_latency":{
+                     "$map":{
+                        "count":0,
+                        "mean":0.0,
+                        "median":0.0,
+                        "p90":0.0,
+                        "p99":0.0,
+                        "p99.9":0.0,
+                        "max":0.0
+                     }
                   }
                }
             ],
@@ -466,6 +488,11 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
                "counter":0,
                "roughness":0.0
             }
+         },
+         "resolution":{
+            "resolvers":1,
+            "load_skew":1.0,
+            "ranges_moved":0
          }
       },
       "cluster_controller_timestamp":1415650089,
@@ -574,6 +601,13 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
          "total_disk_used_bytes":0,
          "total_kv_size_bytes":0,
          "partitions_count":2,
+         "read_hot_partitions":[
+            {
+               "begin":"",
+               "end":"",
+               "read_bytes_per_second":0
+            }
+         ],
          "moving_data":{
             "total_written_bytes":0,
             "in_flight_bytes":0,
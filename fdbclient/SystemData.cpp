@@ -111,6 +111,21 @@ bool serverHasKey( ValueRef storedValue ) {
 	return storedValue == serverKeysTrue;
 }
 
+const KeyRangeRef bulkLoadKeys(
+	LiteralStringRef("\xff/bulkLoad/"),
+	LiteralStringRef("\xff/bulkLoad0") );
+const KeyRef bulkLoadPrefix = bulkLoadKeys.begin;
+
+const Value bulkLoadValue( std::string const& containerUrl, std::string const& fileName, int64_t fileSize, uint32_t blockSize ) {
+	BinaryWriter wr((IncludeVersion())); wr << containerUrl << fileName << fileSize << blockSize;
+	return wr.toValue();
+}
+void decodeBulkLoadValue( const ValueRef& value,
+	std::string& containerUrl, std::string& fileName, int64_t& fileSize, uint32_t& blockSize ) {
+	BinaryReader rd(value, IncludeVersion());
+	rd >> containerUrl >> fileName >> fileSize >> blockSize;
+}
+
 const KeyRangeRef serverTagKeys(
 	LiteralStringRef("\xff/serverTag/"),
 	LiteralStringRef("\xff/serverTag0") );
@@ -617,6 +632,20 @@ const Key restoreWorkerKeyFor( UID const& agentID ) {
 	return wr.toValue();
 }
 
+const KeyRef restoreRequestKey = LiteralStringRef("\xff\x02/restoreRequest");
+const KeyRef restoreRequestDoneKey = LiteralStringRef("\xff\x02/restoreRequestDone");
+const KeyRangeRef restoreApplierKeys(
+	LiteralStringRef("\xff\x02/restoreApplier/"),
+	LiteralStringRef("\xff\x02/restoreApplier0")
+);
+
+const Key restoreApplierKeyFor( UID const& applierID ) {
+	BinaryWriter wr(Unversioned());
+	wr.serializeBytes( restoreApplierKeys.begin );
+	wr << applierID;
+	return wr.toValue();
+}
+
 const KeyRef healthyZoneKey = LiteralStringRef("\xff\x02/healthyZone");
 
 const Value healthyZoneValue( StringRef const& zoneId, Version version ) {
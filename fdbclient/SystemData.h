@@ -52,6 +52,15 @@ const Key serverKeysPrefixFor( UID serverID );
 UID serverKeysDecodeServer( const KeyRef& key );
 bool serverHasKey( ValueRef storedValue );
 
+//    "\xff/bulkLoad/[[begin]]" := "[[containerURL, fileName, fileSize, blockSize]]" | ""
+// A range registered here is ingested from the given pre-sorted range file by any storage server it is moved to,
+//    rather than fetched from its source servers.  The registration is cleared by the move that completes it.
+extern const KeyRangeRef bulkLoadKeys;
+extern const KeyRef bulkLoadPrefix;
+const Value bulkLoadValue( std::string const& containerUrl, std::string const& fileName, int64_t fileSize, uint32_t blockSize );
+void decodeBulkLoadValue( const ValueRef& value,
+	std::string& containerUrl, std::string& fileName, int64_t& fileSize, uint32_t& blockSize );
+
 extern const KeyRangeRef serverTagKeys;
 extern const KeyRef serverTagPrefix;
 extern const KeyRangeRef serverTagMaxKeys;
@@ -278,6 +287,15 @@ extern const KeyRangeRef restoreWorkersKeys;
 
 const Key restoreWorkerKeyFor( UID const& agentID );
 
+// Parallel restore requests are submitted through restoreRequestKey; the restore leader clears it and records the
+// outcome in restoreRequestDoneKey.  Appliers track their committed transactions under restoreApplierKeys so that a
+// retried commit is never applied twice.
+extern const KeyRef restoreRequestKey;
+extern const KeyRef restoreRequestDoneKey;
+extern const KeyRangeRef restoreApplierKeys;
+
+const Key restoreApplierKeyFor( UID const& applierID );
+
 extern const KeyRef healthyZoneKey;
 
 const Value healthyZoneValue( StringRef const& zoneId, Version version );
@@ -204,7 +204,13 @@ public:
 		}
 
 		// Now we know the task key is present and we have the available space for the task's priority
-		state Tuple t = availableSpace.unpack(taskKey.get());
+		Reference<Task> task = wait(claimTask(tr, taskBucket, availableSpace, taskKey.get()));
+		return task;
+	}
+
+	// Claims the task that taskKey, a key in availableSpace, belongs to by moving its parameters to the timeouts subspace
+	ACTOR static Future<Reference<Task>> claimTask(Reference<ReadYourWritesTransaction> tr, Reference<TaskBucket> taskBucket, Subspace availableSpace, Key taskKey) {
+		state Tuple t = availableSpace.unpack(taskKey);
 		state Key taskUID = t.getString(0);
 		state Subspace taskAvailableSpace = availableSpace.get(taskUID);
 
@@ -230,6 +236,57 @@ public:
 		return task;
 	}
 
+	ACTOR static Future<std::vector<Reference<Task>>> getTasks(Reference<ReadYourWritesTransaction> tr, Reference<TaskBucket> taskBucket, int maxTasks) {
+		if (taskBucket->priority_batch)
+			tr->setOption( FDBTransactionOptions::PRIORITY_BATCH );
+
+		taskBucket->setOptions(tr);
+
+		if (deterministicRandom()->random01() < CLIENT_KNOBS->TASKBUCKET_CHECK_TIMEOUT_CHANCE) {
+			bool anyTimeouts = wait(requeueTimedOutTasks(tr, taskBucket));
+			TEST(anyTimeouts); // Found a task that timed out while claiming several
+		}
+
+		state std::vector<Reference<Task>> tasks;
+		state std::set<Key> taskUIDs;
+		state int pri;
+
+		// Task keys are random UIDs, so probes at random UIDs spread the claims of many agents across the available
+		// space.  Probes are snapshot reads; only the claimed tasks' parameters are read with conflicts, so two agents
+		// conflict only if they claim the same task.  As in getOne, tasks are only claimed from the highest priority at which
+		// any are found, so lower priority tasks never run in place of higher priority ones.
+		for(pri = CLIENT_KNOBS->TASKBUCKET_MAX_PRIORITY; pri >= 0 && tasks.empty(); --pri) {
+			state Subspace availableSpace = taskBucket->getAvailableSpace(pri);
+			state std::vector<Future<Optional<Key>>> taskKeyFutures;
+			for(int i = 0; i < (maxTasks - tasks.size()) * CLIENT_KNOBS->TASKBUCKET_CLAIM_PROBES_PER_TASK; ++i)
+				taskKeyFutures.push_back(getTaskKey(tr, taskBucket, pri));
+			wait(waitForAll(taskKeyFutures));
+
+			state std::vector<Future<Reference<Task>>> claims;
+			for(auto &f : taskKeyFutures) {
+				if(f.get().present() && tasks.size() + claims.size() < maxTasks && taskUIDs.insert(availableSpace.unpack(f.get().get()).getString(0)).second) {
+					claims.push_back(claimTask(tr, taskBucket, availableSpace, f.get().get()));
+				}
+			}
+			TEST(claims.size() > 1); // Claimed several tasks in one transaction
+
+			wait(waitForAll(claims));
+			for(auto &c : claims)
+				tasks.push_back(c.get());
+		}
+
+		if(tasks.empty()) {
+			bool anyTimeouts = wait(requeueTimedOutTasks(tr, taskBucket));
+			if(anyTimeouts) {
+				TEST(true); // Try to claim tasks from timeouts subspace
+				std::vector<Reference<Task>> timedOutTasks = wait(getTasks(tr, taskBucket, maxTasks));
+				return timedOutTasks;
+			}
+		}
+
+		return tasks;
+	}
+
 	// Verify that the user configured task verification key still has the user specificied value
 	ACTOR static Future<bool> taskVerify(Reference<TaskBucket> tb, Reference<ReadYourWritesTransaction> tr, Reference<Task> task) {
 
@@ -425,15 +482,16 @@ public:
 		for(int i = 0; i < tasks.size(); ++i)
 			availableSlots.push_back(i);
 
-		state std::vector<Future<Reference<Task>>> getTasks;
+		state std::vector<Future<std::vector<Reference<Task>>>> getTasks;
 		state unsigned int getBatchSize = 1;
 
 		loop {
 			// Start running tasks while slots are available and we keep finding work to do
 			while(!availableSlots.empty()) {
+				// Each claim transaction takes several tasks, so fewer transactions compete for the available space
 				getTasks.clear();
-				for(int i = 0, imax = std::min<unsigned int>(getBatchSize, availableSlots.size()); i < imax; ++i)
-					getTasks.push_back(taskBucket->getOne(cx));
+				for(int i = 0, imax = std::min<unsigned int>(getBatchSize, availableSlots.size()); i < imax; i += CLIENT_KNOBS->TASKBUCKET_MAX_TASKS_PER_CLAIM)
+					getTasks.push_back(taskBucket->getTasks(cx, std::min(imax - i, CLIENT_KNOBS->TASKBUCKET_MAX_TASKS_PER_CLAIM)));
 				wait(waitForAllReady(getTasks));
 
 				bool done = false;
@@ -442,14 +500,15 @@ public:
 						done = true;
 						continue;
 					}
-					Reference<Task> task = getTasks[i].get();
-					if(task) {
+					for(auto &task : getTasks[i].get()) {
 						// Start the task
 						int slot = availableSlots.back();
 						availableSlots.pop_back();
 						tasks[slot] = taskBucket->doTask(cx, futureBucket, task);
 					}
-					else
+					// A claim can come back short because its probes collided or its priority ran out of tasks, so only
+					// an empty claim means that there is no more work to find
+					if(getTasks[i].get().empty())
 						done = true;
 				}
 
@@ -871,6 +930,10 @@ Future<Reference<Task>> TaskBucket::getOne(Reference<ReadYourWritesTransaction>
 	return TaskBucketImpl::getOne(tr, Reference<TaskBucket>::addRef(this));
 }
 
+Future<std::vector<Reference<Task>>> TaskBucket::getTasks(Reference<ReadYourWritesTransaction> tr, int maxTasks) {
+	return TaskBucketImpl::getTasks(tr, Reference<TaskBucket>::addRef(this), maxTasks);
+}
+
 Future<bool> TaskBucket::doOne(Database cx, Reference<FutureBucket> futureBucket) {
 	return TaskBucketImpl::doOne(cx, Reference<TaskBucket>::addRef(this), futureBucket);
 }
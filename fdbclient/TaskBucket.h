@@ -153,6 +153,14 @@ public:
 		return runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr){ return getOne(tr); });
 	}
 
+	// Claims up to maxTasks tasks in one transaction.  All of the claimed tasks have the same priority, the highest one at
+	// which any task was found; fewer than maxTasks may be returned even if more are available.  Returns an empty vector
+	// if no tasks were found.
+	Future<std::vector<Reference<Task>>> getTasks(Reference<ReadYourWritesTransaction> tr, int maxTasks);
+	Future<std::vector<Reference<Task>>> getTasks(Database cx, int maxTasks) {
+		return runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr){ return getTasks(tr, maxTasks); });
+	}
+
 	Future<bool> doTask(Database cx, Reference<FutureBucket> futureBucket, Reference<Task> task);
 
 	Future<bool> doOne(Database cx, Reference<FutureBucket> futureBucket);
@@ -18,36 +18,138 @@
  * limitations under the License.
  */
 
+#include <cinttypes>
+
 #include "fdbclient/Tuple.h"
+#include "flow/UnitTest.h"
 
+// The string scans below use memchr to find each \x00, since it is vectorized by the platform's C library and strings
+// rarely contain escaped nulls.
 static size_t find_string_terminator(const StringRef data, size_t offset) {
 	size_t i = offset;
-	while (i < data.size() - 1 && !(data[i] == '\x00' && data[i+1] != (uint8_t)'\xff')) {
-		i += (data[i] == '\x00' ? 2 : 1);
+	while (i < data.size() - 1) {
+		const uint8_t* nul = (const uint8_t*)memchr(data.begin() + i, 0, data.size() - 1 - i);
+		if(!nul) {
+			return data.size() - 1;
+		}
+		i = nul - data.begin();
+		if(data[i+1] != (uint8_t)'\xff') {
+			return i;
+		}
+		i += 2;
 	}
 
 	return i;
 }
 
+// Returns the offset following the element that starts at offset, which may be past the end of an incomplete tuple
+static size_t find_element_end(const StringRef data, size_t offset) {
+	uint8_t code = data[offset];
+	if(code == '\x01' || code == '\x02') {
+		return find_string_terminator(data, offset+1) + 1;
+	}
+	else if(code >= '\x0c' && code <= '\x1c') {
+		return offset + abs(code - '\x14') + 1;
+	}
+	else if(code == '\x00') {
+		return offset + 1;
+	}
+	else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+static Tuple::ElementType get_element_type(uint8_t code) {
+	if(code == '\x00') {
+		return Tuple::ElementType::NULL_TYPE;
+	}
+	else if(code == '\x01') {
+		return Tuple::ElementType::BYTES;
+	}
+	else if(code == '\x02') {
+		return Tuple::ElementType::UTF8;
+	}
+	else if(code >= '\x0c' && code <= '\x1c') {
+		return Tuple::ElementType::INT;
+	}
+	else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+// Decodes the escaped string in [b, e) into arena.  The terminator, if present, is the last byte of the range.
+static StringRef decode_string(const StringRef data, size_t b, size_t e, Arena& arena) {
+	VectorRef<uint8_t> staging;
+	staging.reserve(arena, e - b);
+
+	const uint8_t* p = data.begin() + b;
+	const uint8_t* end = data.begin() + e;
+	while(p < end) {
+		const uint8_t* nul = (const uint8_t*)memchr(p, 0, end - p);
+		if(!nul) {
+			staging.append(arena, p, end - p);
+			break;
+		}
+		staging.append(arena, p, nul - p);
+		if(nul + 1 < end) {
+			staging.push_back(arena, '\x00');
+		}
+		p = nul + 2;
+	}
+
+	return StringRef(staging.begin(), staging.size());
+}
+
+static int64_t decode_int(const StringRef data, size_t offset, bool allow_incomplete) {
+	int64_t swap;
+	bool neg = false;
+
+	ASSERT(offset < data.size());
+	uint8_t code = data[offset];
+	if(code < '\x0c' || code > '\x1c') {
+		throw invalid_tuple_data_type();
+	}
+
+	int8_t len = code - '\x14';
+
+	if ( len < 0 ) {
+		len = -len;
+		neg = true;
+	}
+
+	memset( &swap, neg ? '\xff' : 0, 8 - len );
+	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
+	int presentLen = std::min<size_t>(len, data.size() - offset - 1);
+	ASSERT(len == presentLen || allow_incomplete);
+	memcpy( ((uint8_t*)&swap) + 8 - len, data.begin() + offset + 1, presentLen );
+	if(presentLen < len) {
+		int suffix = len - presentLen;
+		if(presentLen == 0) {
+			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have been used.
+			// So if we don't have the first (most significant) byte in the encoded string, use 1 so that the decoded result
+			// maintains the encoded form's sort order with an encoded value of a shorter and same-signed type.
+			*( ((uint8_t*)&swap) + 8 - len) = 1;
+			--suffix;  // The suffix to clear below is now 1 byte shorter.
+		}
+		memset( ((uint8_t*)&swap) + 8 - suffix, 0, suffix );
+	}
+
+	swap = bigEndian64( swap );
+
+	if ( neg ) {
+		swap = -(~swap);
+	}
+
+	return swap;
+}
+
 Tuple::Tuple(StringRef const& str, bool exclude_incomplete) {
 	data.append(data.arena(), str.begin(), str.size());
 
 	size_t i = 0;
 	while(i < data.size()) {
 		offsets.push_back(i);
-
-		if(data[i] == '\x01' || data[i] == '\x02') {
-			i = find_string_terminator(str, i+1) + 1;
-		}
-		else if(data[i] >= '\x0c' && data[i] <= '\x1c') {
-			i += abs(data[i] - '\x14') + 1;
-		}
-		else if(data[i] == '\x00') {
-			i += 1;
-		}
-		else {
-			throw invalid_tuple_data_type();
-		}
+		i = find_element_end(str, i);
 	}
 	// If incomplete tuples are allowed, remove the last offset if i is now beyond size()
 	// Strings will never be considered incomplete due to the way the string end is found.
@@ -72,22 +174,34 @@ Tuple& Tuple::append(Tuple const& tuple) {
 Tuple& Tuple::append(StringRef const& str, bool utf8) {
 	offsets.push_back(data.size());
 
-	const uint8_t utfChar = uint8_t(utf8 ? '\x02' : '\x01');
-	data.append(data.arena(), &utfChar, 1);
-
-	size_t lastPos = 0;
-	for(size_t pos = 0; pos < str.size(); ++pos) {
-		if(str[pos] == '\x00') {
-			data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-			data.push_back(data.arena(), (uint8_t)'\x00');
-			data.push_back(data.arena(), (uint8_t)'\xff');
-			lastPos = pos + 1;
-		}
+	// Each \x00 is escaped as \x00\xff, so count them first to size the encoding exactly
+	const uint8_t* in = str.begin();
+	const uint8_t* end = str.end();
+	int nulls = 0;
+	for(const uint8_t* p = in; p < end && (p = (const uint8_t*)memchr(p, 0, end - p)) != nullptr; ++p) {
+		++nulls;
 	}
 
-	data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
-	data.push_back(data.arena(), (uint8_t)'\x00');
+	data.reserve(data.arena(), data.size() + str.size() + nulls + 2);
+	uint8_t* begin = data.begin() + data.size();
+	uint8_t* out = begin;
+
+	*out++ = uint8_t(utf8 ? '\x02' : '\x01');
+	for(; nulls > 0; --nulls) {
+		const uint8_t* nul = (const uint8_t*)memchr(in, 0, end - in);
+		memcpy(out, in, nul - in);
+		out += nul - in;
+		*out++ = (uint8_t)'\x00';
+		*out++ = (uint8_t)'\xff';
+		in = nul + 1;
+	}
+	if(end > in) {
+		memcpy(out, in, end - in);
+		out += end - in;
+	}
+	*out++ = (uint8_t)'\x00';
 
+	data.extendUnsafeNoReallocNoInit(out - begin);
 	return *this;
 }
 
@@ -127,23 +241,7 @@ Tuple::ElementType Tuple::getType(size_t index) const {
 		throw invalid_tuple_index();
 	}
 
-	uint8_t code = data[offsets[index]];
-
-	if(code == '\x00') {
-		return ElementType::NULL_TYPE;
-	}
-	else if(code == '\x01') {
-		return ElementType::BYTES;
-	}
-	else if(code == '\x02') {
-		return ElementType::UTF8;
-	}
-	else if(code >= '\x0c' && code <= '\x1c') {
-		return ElementType::INT;
-	}
-	else {
-		throw invalid_tuple_data_type();
-	}
+	return get_element_type(data[offsets[index]]);
 }
 
 Standalone<StringRef> Tuple::getString(size_t index) const {
@@ -165,25 +263,7 @@ Standalone<StringRef> Tuple::getString(size_t index) const {
 	}
 
 	Standalone<StringRef> result;
-	VectorRef<uint8_t> staging;
-
-	for (size_t i = b; i < e; ++i) {
-		if(data[i] == '\x00') {
-			staging.append(result.arena(), data.begin() + b, i - b);
-			++i;
-			b = i + 1;
-
-			if(i < e) {
-				staging.push_back(result.arena(), '\x00');
-			}
-		}
-	}
-
-	if(b < e) {
-		staging.append(result.arena(), data.begin() + b, e - b);
-	}
-
-	result.StringRef::operator=(StringRef(staging.begin(), staging.size()));
+	result.StringRef::operator=(decode_string(pack(), b, e, result.arena()));
 	return result;
 }
 
@@ -192,46 +272,7 @@ int64_t Tuple::getInt(size_t index, bool allow_incomplete) const {
 		throw invalid_tuple_index();
 	}
 
-	int64_t swap;
-	bool neg = false;
-
-	ASSERT(offsets[index] < data.size());
-	uint8_t code = data[offsets[index]];
-	if(code < '\x0c' || code > '\x1c') {
-		throw invalid_tuple_data_type();
-	}
-
-	int8_t len = code - '\x14';
-
-	if ( len < 0 ) {
-		len = -len;
-		neg = true;
-	}
-
-	memset( &swap, neg ? '\xff' : 0, 8 - len );
-	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
-	int presentLen = std::min<int8_t>(len, data.size() - offsets[index] - 1);
-	ASSERT(len == presentLen || allow_incomplete);
-	memcpy( ((uint8_t*)&swap) + 8 - len, data.begin() + offsets[index] + 1, presentLen );
-	if(presentLen < len) {
-		int suffix = len - presentLen;
-		if(presentLen == 0) {
-			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have been used.
-			// So if we don't have the first (most significant) byte in the encoded string, use 1 so that the decoded result
-			// maintains the encoded form's sort order with an encoded value of a shorter and same-signed type.
-			*( ((uint8_t*)&swap) + 8 - len) = 1;
-			--suffix;  // The suffix to clear below is now 1 byte shorter.
-		}
-		memset( ((uint8_t*)&swap) + 8 - suffix, 0, suffix );
-	}
-
-	swap = bigEndian64( swap );
-
-	if ( neg ) {
-		swap = -(~swap);
-	}
-
-	return swap;
+	return decode_int(pack(), offsets[index], allow_incomplete);
 }
 
 KeyRange Tuple::range(Tuple const& tuple) const {
@@ -262,3 +303,154 @@ Tuple Tuple::subTuple(size_t start, size_t end) const {
 	size_t endPos = end < offsets.size() ? offsets[end] : data.size();
 	return Tuple(StringRef(data.begin() + offsets[start], endPos - offsets[start]));
 }
+
+size_t TupleView::seek(size_t index) const {
+	if(index < cursorIndex) {
+		cursorIndex = 0;
+		cursorOffset = 0;
+	}
+	while(cursorIndex < index && cursorOffset < packed.size()) {
+		cursorOffset = find_element_end(packed, cursorOffset);
+		++cursorIndex;
+	}
+	if(cursorOffset >= packed.size()) {
+		throw invalid_tuple_index();
+	}
+
+	return cursorOffset;
+}
+
+size_t TupleView::size() const {
+	size_t count = 0;
+	for(size_t i = 0; i < packed.size(); i = find_element_end(packed, i)) {
+		++count;
+	}
+	return count;
+}
+
+Tuple::ElementType TupleView::getType(size_t index) const {
+	return get_element_type(packed[seek(index)]);
+}
+
+StringRef TupleView::getString(size_t index, Arena& arena) const {
+	size_t offset = seek(index);
+	uint8_t code = packed[offset];
+	if(code != '\x01' && code != '\x02') {
+		throw invalid_tuple_data_type();
+	}
+
+	size_t b = offset + 1;
+	size_t e = find_string_terminator(packed, b);
+	if(e >= packed.size() || packed[e] != '\x00') {
+		// The string runs to the end of the packed data, see find_string_terminator
+		e = packed.size();
+	}
+
+	const uint8_t* nul = (const uint8_t*)memchr(packed.begin() + b, 0, e - b);
+	if(!nul) {
+		return StringRef(packed.begin() + b, e - b);
+	}
+	return decode_string(packed, b, std::min(e + 1, (size_t)packed.size()), arena);
+}
+
+int64_t TupleView::getInt(size_t index, bool allow_incomplete) const {
+	return decode_int(packed, seek(index), allow_incomplete);
+}
+
+TEST_CASE("/fdbclient/Tuple/view") {
+	Standalone<StringRef> empty = LiteralStringRef("");
+	Standalone<StringRef> nulls = LiteralStringRef("\x00a\x00\x00");
+
+	for(int i = 0; i < 1000; i++) {
+		Tuple t;
+		int n = deterministicRandom()->randomInt(0, 10);
+		for(int j = 0; j < n; j++) {
+			switch(deterministicRandom()->randomInt(0, 4)) {
+				case 0:
+					t.append(deterministicRandom()->randomInt64(std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max()));
+					break;
+				case 1:
+					t.append(deterministicRandom()->coinflip() ? empty : nulls, deterministicRandom()->coinflip());
+					break;
+				case 2:
+					t.append(StringRef(deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 100))));
+					break;
+				default:
+					t.appendNull();
+			}
+		}
+
+		Tuple u = Tuple::unpack(t.pack());
+		TupleView v(t.pack());
+		ASSERT(u.pack() == t.pack() && u.size() == n && v.size() == n);
+
+		// Visit elements in a random order, so that the view's cursor moves both forwards and backwards
+		Arena arena;
+		for(int k = 0; k < n; k++) {
+			int j = deterministicRandom()->randomInt(0, n);
+			ASSERT(v.getType(j) == u.getType(j));
+			if(u.getType(j) == Tuple::ElementType::INT) {
+				ASSERT(v.getInt(j) == u.getInt(j));
+			}
+			else if(u.getType(j) != Tuple::ElementType::NULL_TYPE) {
+				ASSERT(v.getString(j, arena) == u.getString(j));
+			}
+		}
+		try {
+			v.getType(n);
+			ASSERT(false);
+		} catch(Error& e) {
+			ASSERT(e.code() == error_code_invalid_tuple_index);
+		}
+	}
+
+	return Void();
+}
+
+TEST_CASE("!/fdbclient/Tuple/perf") {
+	std::vector<Standalone<StringRef>> strings;
+	for(int i = 0; i < 1000; i++) {
+		std::string s = deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 64));
+		if(i % 10 == 0 && s.size()) {
+			s[deterministicRandom()->randomInt(0, s.size())] = '\x00';
+		}
+		strings.push_back(StringRef(s));
+	}
+
+	int iterations = 200000;
+	std::vector<Standalone<StringRef>> packed;
+	int64_t bytes = 0;
+
+	double start = timer();
+	for(int i = 0; i < iterations; i++) {
+		Tuple t;
+		t << strings[i % strings.size()] << (int64_t)i << strings[(i * 7) % strings.size()];
+		packed.push_back(t.getDataAsStandalone());
+		bytes += t.pack().size();
+	}
+	double pack = timer() - start;
+
+	int64_t check = 0;
+	start = timer();
+	for(auto& p : packed) {
+		Tuple t = Tuple::unpack(p);
+		check += t.getString(0).size() + t.getInt(1) + t.getString(2).size();
+	}
+	double unpack = timer() - start;
+
+	int64_t viewCheck = 0;
+	Arena arena;
+	start = timer();
+	for(auto& p : packed) {
+		TupleView v(p);
+		viewCheck += v.getString(0, arena).size() + v.getInt(1) + v.getString(2, arena).size();
+	}
+	double view = timer() - start;
+	ASSERT(check == viewCheck);
+
+	printf("Tuple pack:   %d tuples  %" PRId64 " bytes  %f seconds  %f MB/s\n", iterations, bytes, pack, bytes / pack / 1e6);
+	printf("Tuple unpack: %d tuples  %" PRId64 " bytes  %f seconds  %f MB/s\n", iterations, bytes, unpack, bytes / unpack / 1e6);
+	printf("TupleView:    %d tuples  %" PRId64 " bytes  %f seconds  %f MB/s\n", iterations, bytes, view, bytes / view / 1e6);
+
+	return Void();
+}
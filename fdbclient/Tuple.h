@@ -70,4 +70,27 @@ private:
 	std::vector<size_t> offsets;
 };
 
+// A read-only view of a packed tuple, which decodes its elements on demand rather than copying and indexing the
+// packed data up front.  Elements are found by scanning from the last one accessed, so visiting them in order costs
+// one pass over the data.  The view does not own the packed data, which must outlive it.
+struct TupleView {
+	explicit TupleView(StringRef const& packed) : packed(packed), cursorIndex(0), cursorOffset(0) {}
+
+	// this is number of elements, and requires a scan of the packed data
+	size_t size() const;
+
+	Tuple::ElementType getType(size_t index) const;
+	// Returns a reference into the packed data, unless the string contains escaped nulls and must be decoded into arena
+	StringRef getString(size_t index, Arena& arena) const;
+	int64_t getInt(size_t index, bool allow_incomplete = false) const;
+
+private:
+	// Returns the offset of the element at index
+	size_t seek(size_t index) const;
+
+	StringRef packed;
+	mutable size_t cursorIndex;
+	mutable size_t cursorOffset;
+};
+
 #endif /* FDBCLIENT_TUPLE_H */
@@ -42,37 +42,36 @@ struct RYWMutation {
 class OperationStack {
 	private:
 		RYWMutation singletonOperation;
-		Optional<std::vector<RYWMutation>> optionalOperations;
-		bool hasVector() const { return optionalOperations.present(); }
+		// Operations after the first.  This is empty unless more than one operation is stacked, so an entry with a single
+		// operation carries no more than an empty vector; keeping OperationStack small keeps WriteMap tree nodes in the
+		// smaller FastAllocator size class.
+		std::vector<RYWMutation> extraOperations;
+		bool hasVector() const { return !extraOperations.empty(); }
 		bool defaultConstructed;
 	public:
 		OperationStack () { defaultConstructed = true; } // Don't use this!
 		explicit OperationStack (RYWMutation initialEntry) { defaultConstructed = false; singletonOperation = initialEntry; }
-		void reset(RYWMutation initialEntry) { defaultConstructed = false; singletonOperation = initialEntry; optionalOperations = Optional<std::vector<RYWMutation>>(); }
-		void poppush(RYWMutation entry) { if(hasVector()) { optionalOperations.get().pop_back(); optionalOperations.get().push_back(entry); } else singletonOperation = entry; }
+		void reset(RYWMutation initialEntry) { defaultConstructed = false; singletonOperation = initialEntry; extraOperations.clear(); }
+		void poppush(RYWMutation entry) { if(hasVector()) { extraOperations.back() = entry; } else singletonOperation = entry; }
 		void push(RYWMutation entry) { 
 			if(defaultConstructed) { 
 				singletonOperation = entry; 
 				defaultConstructed = false; 
 			} 
-			else if(hasVector()) 
-				optionalOperations.get().push_back(entry); 
-			else { 
-				optionalOperations = std::vector<RYWMutation>(); 
-				optionalOperations.get().push_back(entry); 
-			} 
+			else
+				extraOperations.push_back(entry); 
 		}
 		bool isDependent() const {
 			if( !size() )
 				return false;
 			return singletonOperation.type != MutationRef::SetValue && singletonOperation.type != MutationRef::ClearRange && singletonOperation.type != MutationRef::SetVersionstampedValue && singletonOperation.type != MutationRef::SetVersionstampedKey;
 		}
-		const RYWMutation& top() const { return hasVector() ? optionalOperations.get().back() : singletonOperation; }
-		RYWMutation& operator[] (int n) { return (n==0) ? singletonOperation : optionalOperations.get()[n-1]; }
+		const RYWMutation& top() const { return hasVector() ? extraOperations.back() : singletonOperation; }
+		RYWMutation& operator[] (int n) { return (n==0) ? singletonOperation : extraOperations[n-1]; }
 
-		const RYWMutation& at(int n) const { return (n==0) ? singletonOperation : optionalOperations.get()[n-1]; }
+		const RYWMutation& at(int n) const { return (n==0) ? singletonOperation : extraOperations[n-1]; }
 
-		int size() const { return defaultConstructed ? 0 : hasVector() ? optionalOperations.get().size() + 1 : 1; }
+		int size() const { return defaultConstructed ? 0 : extraOperations.size() + 1; }
 
 		bool operator == (const OperationStack& r) const {
 			if (size() != r.size())
@@ -84,15 +83,7 @@ class OperationStack {
 			if (singletonOperation != r.singletonOperation)
 				return false;
 
-			if (size() == 1)
-				return true;
-
-			for (int i = 0; i < optionalOperations.get().size(); i++) {
-				if (optionalOperations.get()[i] != r.optionalOperations.get()[i])
-					return false;
-			}
-
-			return true;
+			return extraOperations == r.extraOperations;
 		}
 };
 
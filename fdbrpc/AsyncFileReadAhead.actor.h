@@ -31,7 +31,9 @@
 #include "fdbrpc/IAsyncFile.h"
 #include "flow/actorcompiler.h"  // This must be the last #include.
 
-// Read-only file type that wraps another file instance, reads in large blocks, and reads ahead of the actual range requested
+// Read-only file type that wraps another file instance, reads in large blocks, and reads ahead of the actual range requested.
+// If a maximum read ahead is given, the read ahead adapts: it is used only for reads that continue where the previous
+// read ended, and it moves one block at a time towards whichever size gives the best block read throughput.
 class AsyncFileReadAheadCache : public IAsyncFile, public ReferenceCounted<AsyncFileReadAheadCache> {
 public:
 	virtual void addref() { ReferenceCounted<AsyncFileReadAheadCache>::addref(); }
@@ -52,6 +54,7 @@ public:
 		try {
 			int len = wait(f->m_f->read(block->data, length, offset));
 			block->len = len;
+			f->recordBlockRead(len);
 		} catch(Error &e) {
 			f->m_max_concurrent_reads.release(1);
 			throw e;
@@ -89,7 +92,7 @@ public:
 		// Start blocks up to the read ahead size beyond the last needed block but don't go past the end of the file
 		state int lastBlockNumInFile = ((fileSize + f->m_block_size - 1) / f->m_block_size) - 1;
 		ASSERT(lastBlockNum <= lastBlockNumInFile);
-		int lastBlockToStart = std::min<int>(lastBlockNum + f->m_read_ahead_blocks, lastBlockNumInFile);
+		int lastBlockToStart = std::min<int>(lastBlockNum + f->readAheadFor(offset, length), lastBlockNumInFile);
 
 		state int blockNum;
 		for(blockNum = firstBlockNum; blockNum <= lastBlockToStart; ++blockNum) {
@@ -186,15 +189,59 @@ public:
 	Reference<IAsyncFile> m_f;
 	int m_block_size;
 	int m_read_ahead_blocks;
+	int m_max_read_ahead_blocks;  // 0 if the read ahead is fixed
 	int m_cache_block_limit;
 	FlowLock m_max_concurrent_reads;
 
 	// Map block numbers to future
 	std::map<int, Future<Reference<CacheBlock>>> m_blocks;
 
-	AsyncFileReadAheadCache(Reference<IAsyncFile> f, int blockSize, int readAheadBlocks, int maxConcurrentReads, int cacheSizeBlocks)
-		: m_f(f), m_block_size(blockSize), m_read_ahead_blocks(readAheadBlocks), m_max_concurrent_reads(maxConcurrentReads),
-		  m_cache_block_limit(std::max<int>(1, cacheSizeBlocks)) {
+	// Adaptive read ahead state
+	int64_t m_next_sequential_offset;
+	int m_step;
+	int m_window_blocks;
+	int64_t m_window_bytes;
+	double m_window_start;
+	double m_last_throughput;
+
+	AsyncFileReadAheadCache(Reference<IAsyncFile> f, int blockSize, int readAheadBlocks, int maxConcurrentReads, int cacheSizeBlocks, int maxReadAheadBlocks = 0)
+		: m_f(f), m_block_size(blockSize), m_read_ahead_blocks(readAheadBlocks), m_max_read_ahead_blocks(std::max<int>(0, maxReadAheadBlocks)),
+		  m_max_concurrent_reads(maxConcurrentReads), m_cache_block_limit(std::max<int>(1, cacheSizeBlocks)),
+		  m_next_sequential_offset(0), m_step(1), m_window_blocks(0), m_window_bytes(0), m_window_start(now()), m_last_throughput(0) {
+		if(m_max_read_ahead_blocks > 0) {
+			m_read_ahead_blocks = std::max(1, std::min(m_read_ahead_blocks, m_max_read_ahead_blocks));
+			// Blocks being read ahead must not be evicted before they are used
+			m_cache_block_limit = std::max(m_cache_block_limit, m_max_read_ahead_blocks + 1);
+		}
+	}
+
+private:
+	// Returns the number of blocks to read ahead of a read of [offset, offset + length)
+	int readAheadFor(int64_t offset, int length) {
+		if(m_max_read_ahead_blocks == 0)
+			return m_read_ahead_blocks;
+		bool sequential = offset == m_next_sequential_offset;
+		m_next_sequential_offset = offset + length;
+		return sequential ? m_read_ahead_blocks : 0;
+	}
+
+	// Hill climbs the read ahead on the throughput of block reads, measured over windows of a few times the read ahead
+	void recordBlockRead(int bytes) {
+		if(m_max_read_ahead_blocks == 0)
+			return;
+		m_window_bytes += bytes;
+		if(++m_window_blocks < 2 * (m_read_ahead_blocks + 1))
+			return;
+
+		double throughput = m_window_bytes / std::max(now() - m_window_start, 1e-6);
+		// Keep moving in the same direction unless the last move made things worse
+		if(throughput < m_last_throughput * 0.95)
+			m_step = -m_step;
+		m_read_ahead_blocks = std::max(1, std::min(m_max_read_ahead_blocks, m_read_ahead_blocks + m_step));
+		m_last_throughput = throughput;
+		m_window_blocks = 0;
+		m_window_bytes = 0;
+		m_window_start = now();
 	}
 
 };
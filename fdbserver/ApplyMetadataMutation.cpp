@@ -220,6 +220,27 @@ void applyMetadataMutations(UID const& dbgid, Arena &arena, VectorRef<MutationRe
 						.detail("LogRangeBegin", logRangeBegin).detail("LogRangeEnd", logRangeEnd);
 				}
 			}
+			else if (m.param1.startsWith(bulkLoadPrefix)) {
+				// A bulk load registration tells the servers of its range, including the destinations of a move in progress, to
+				// look for it when fetching (see fetchKeys).  startMoveKeys registers again after changing keyServers.
+				if(toCommit && keyInfo && m.param2.size()) {
+					KeyRef k = m.param1.removePrefix(bulkLoadPrefix);
+					if(k != allKeys.end) {
+						std::set<Tag> tags;
+						auto& info = keyInfo->rangeContaining(k).value();
+						for(auto& i : info.src_info)
+							tags.insert(i->tag);
+						for(auto& i : info.dest_info)
+							tags.insert(i->tag);
+						if(tags.size()) {
+							MutationRef privatized = m;
+							privatized.param1 = m.param1.withPrefix(systemKeys.begin, arena);
+							toCommit->addTags(tags);
+							toCommit->addTypedMessage(privatized);
+						}
+					}
+				}
+			}
 			else if (m.param1.startsWith(globalKeysPrefix)) {
 				if(toCommit) {
 					// Notifies all servers that a Master's server epoch ends
@@ -271,6 +292,28 @@ void applyMetadataMutations(UID const& dbgid, Arena &arena, VectorRef<MutationRe
 
 				if(!initialCommit) txnStateStore->clear(r);
 			}
+			if (bulkLoadKeys.intersects(range)) {
+				// Clearing a bulk load registration publishes the data its storage servers ingested (see fetchKeys), which
+				// they must not serve at earlier versions.  keyServers already names them, since finishMoveKeys changes it first.
+				if(toCommit && keyInfo) {
+					KeyRangeRef r = range & bulkLoadKeys;
+					KeyRangeRef clearRange(r.begin.removePrefix(bulkLoadPrefix), r.end.startsWith(bulkLoadPrefix) ? r.end.removePrefix(bulkLoadPrefix) : allKeys.end);
+					std::set<Tag> tags;
+					for(auto& it : keyInfo->intersectingRanges(clearRange)) {
+						for(auto& info : it.value().src_info)
+							tags.insert(info->tag);
+						for(auto& info : it.value().dest_info)
+							tags.insert(info->tag);
+					}
+					if(tags.size()) {
+						MutationRef privatized = m;
+						privatized.param1 = r.begin.withPrefix(systemKeys.begin, arena);
+						privatized.param2 = r.end.withPrefix(systemKeys.begin, arena);
+						toCommit->addTags(tags);
+						toCommit->addTypedMessage(privatized);
+					}
+				}
+			}
 			if (configKeys.intersects(range)) {
 				if(!initialCommit) txnStateStore->clear(range & configKeys);
 				if(!excludedServersKeys.contains(range)) {
@@ -239,6 +239,19 @@ public:
 		return (physicalBytes + (inflightPenalty*inFlightBytes)) * freeSpaceMultiplier;
 	}
 
+	// Reads are balanced across the replicas of a shard, so the team's read load is the average over its servers
+	virtual int64_t getLoadReadBandwidth() {
+		int64_t bytesReadSum = 0;
+		int added = 0;
+		for(int i=0; i<servers.size(); i++)
+			if( servers[i]->serverMetrics.present() ) {
+				added++;
+				bytesReadSum += servers[i]->serverMetrics.get().load.bytesReadPerKSecond;
+			}
+
+		return added == 0 ? 0 : bytesReadSum / added;
+	}
+
 	virtual int64_t getMinFreeSpace( bool includeInFlight = true ) {
 		int64_t minFreeSpace = std::numeric_limits<int64_t>::max();
 		for(int i=0; i<servers.size(); i++) {
@@ -525,6 +538,56 @@ Future<Void> storageServerTracker(
 
 Future<Void> teamTracker(struct DDTeamCollection* const& self, Reference<TCTeamInfo> const& team, bool const& badTeam, bool const& redundantTeam);
 
+// Tracks how many teams each of a fixed set of servers (or machines) is on while teams are being built, so that a
+// least used one can be picked without scanning all of them for every team. Items are named by their index in the
+// vector the counts were taken from. Counts only grow, which is all that team building needs.
+struct TeamCountTracker {
+	std::vector<int> counts;
+	std::vector<std::vector<int>> itemsWithCount; // itemsWithCount[c] holds the items that are on c teams
+	std::vector<int> position; // position[i] is the index of item i in itemsWithCount[counts[i]]
+	int minCount;
+
+	explicit TeamCountTracker(std::vector<int> const& initialCounts)
+	  : counts(initialCounts), position(initialCounts.size()), minCount(0) {
+		int maxCount = 0;
+		for (int c : counts) maxCount = std::max(maxCount, c);
+		itemsWithCount.resize(maxCount + 1);
+		for (int i = 0; i < counts.size(); i++) {
+			position[i] = itemsWithCount[counts[i]].size();
+			itemsWithCount[counts[i]].push_back(i);
+		}
+		advanceMinCount();
+	}
+
+	bool empty() const { return counts.empty(); }
+
+	void increment(int item) {
+		int c = counts[item];
+		std::vector<int>& from = itemsWithCount[c];
+		int moved = from.back();
+		from[position[item]] = moved;
+		position[moved] = position[item];
+		from.pop_back();
+
+		if (c + 1 == itemsWithCount.size()) itemsWithCount.emplace_back();
+		position[item] = itemsWithCount[c + 1].size();
+		itemsWithCount[c + 1].push_back(item);
+		counts[item] = c + 1;
+		advanceMinCount();
+	}
+
+	// Randomly choose one of the items that are on the fewest teams
+	int randomLeastUsed() const {
+		ASSERT(!empty());
+		return deterministicRandom()->randomChoice(itemsWithCount[minCount]);
+	}
+
+private:
+	void advanceMinCount() {
+		while (minCount + 1 < itemsWithCount.size() && itemsWithCount[minCount].empty()) minCount++;
+	}
+};
+
 struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 	enum { REQUESTING_WORKER = 0, GETTING_WORKER = 1, GETTING_STORAGE = 2 };
 
@@ -701,6 +764,11 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 		return Void();
 	}
 
+	template <class T>
+	static int64_t getTeamLoad( Reference<T> const& team, GetTeamRequest const& req ) {
+		return req.useReadLoad ? team->getLoadReadBandwidth() : team->getLoadBytes(true, req.inflightPenalty);
+	}
+
 	// SOMEDAY: Make bestTeam better about deciding to leave a shard where it is (e.g. in PRIORITY_TEAM_HEALTHY case)
 	//		    use keys, src, dest, metrics, priority, system load, etc.. to decide...
 	ACTOR static Future<Void> getTeam( DDTeamCollection* self, GetTeamRequest req ) {
@@ -750,7 +818,7 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 								}
 
 								if( (sharedMembers == teamList[j]->size()) || (!foundExact && req.wantsTrueBest) ) {
-									int64_t loadBytes = SOME_SHARED * teamList[j]->getLoadBytes(true, req.inflightPenalty);
+									int64_t loadBytes = SOME_SHARED * getTeamLoad(teamList[j], req);
 									if( !bestOption.present() || ( req.preferLowerUtilization && loadBytes < bestLoadBytes ) || ( !req.preferLowerUtilization && loadBytes > bestLoadBytes ) ) {
 										bestLoadBytes = loadBytes;
 										bestOption = teamList[j];
@@ -784,7 +852,7 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 				ASSERT( !bestOption.present() );
 				for( int i = 0; i < self->teams.size(); i++ ) {
 					if( self->teams[i]->isHealthy() && (!req.preferLowerUtilization || self->teams[i]->hasHealthyFreeSpace()) ) {
-						int64_t loadBytes = NONE_SHARED * self->teams[i]->getLoadBytes(true, req.inflightPenalty);
+						int64_t loadBytes = NONE_SHARED * getTeamLoad(self->teams[i], req);
 						if( !bestOption.present() || ( req.preferLowerUtilization && loadBytes < bestLoadBytes ) || ( !req.preferLowerUtilization && loadBytes > bestLoadBytes ) ) {
 							bestLoadBytes = loadBytes;
 							bestOption = self->teams[i];
@@ -809,7 +877,7 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 				}
 
 				for( int i = 0; i < randomTeams.size(); i++ ) {
-					int64_t loadBytes = randomTeams[i].first * randomTeams[i].second->getLoadBytes(true, req.inflightPenalty);
+					int64_t loadBytes = randomTeams[i].first * getTeamLoad(randomTeams[i].second, req);
 					if( !bestOption.present() || ( req.preferLowerUtilization && loadBytes < bestLoadBytes ) || ( !req.preferLowerUtilization && loadBytes > bestLoadBytes ) ) {
 						bestLoadBytes = loadBytes;
 						bestOption = randomTeams[i].second;
@@ -1314,46 +1382,44 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 		// Step 1: Create machineLocalityMap which will be used in building machine team
 		rebuildMachineLocalityMap();
 
+		// Step 2: Index the healthy machines by how many machine teams they are on, so that each iteration can pick a
+		// least used machine without scanning all of them. Machine health cannot change while we build teams.
+		std::vector<Reference<TCMachineInfo>> healthyMachines;
+		std::map<Standalone<StringRef>, int> healthyMachineIndex;
+		std::vector<int> machineTeamCounts;
+		for (auto& machine : machine_info) {
+			// Skip invalid machine whose representative server is not in server_info
+			ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->id) != server_info.end());
+			// Skip unhealthy machines
+			if (!isMachineHealthy(machine.second)) continue;
+
+			// Invariant: We only create correct size machine teams.
+			// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
+			// so that the invariant will not be violated.
+			healthyMachineIndex[machine.first] = healthyMachines.size();
+			healthyMachines.push_back(machine.second);
+			machineTeamCounts.push_back(machine.second->machineTeams.size());
+		}
+		TeamCountTracker machineUsage(machineTeamCounts);
+		int machineTeamBudget = getRemainingMachineTeamBudget();
+
 		int loopCount = 0;
 		// Add a team in each iteration
 		while (addedMachineTeams < machineTeamsToBuild || addedMachineTeams < remainingMachineTeamBudget) {
-			// Step 2: Get least used machines from which we choose machines as a machine team
-			std::vector<Reference<TCMachineInfo>> leastUsedMachines; // A less used machine has less number of teams
-			int minTeamCount = std::numeric_limits<int>::max();
-			for (auto& machine : machine_info) {
-				// Skip invalid machine whose representative server is not in server_info
-				ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->id) != server_info.end());
-				// Skip unhealthy machines
-				if (!isMachineHealthy(machine.second)) continue;
-
-				// Invariant: We only create correct size machine teams.
-				// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
-				// so that the invariant will not be violated.
-				int teamCount = machine.second->machineTeams.size();
-
-				if (teamCount < minTeamCount) {
-					leastUsedMachines.clear();
-					minTeamCount = teamCount;
-				}
-				if (teamCount == minTeamCount) {
-					leastUsedMachines.push_back(machine.second);
-				}
-			}
-
 			std::vector<UID*> team;
 			std::vector<LocalityEntry> forcedAttributes;
 
 			// Step 3: Create a representative process for each machine.
-			// Construct forcedAttribute from leastUsedMachines.
+			// Construct forcedAttribute from the least used machines.
 			// We will use forcedAttribute to call existing function to form a team
-			if (leastUsedMachines.size()) {
+			if (!machineUsage.empty()) {
 				// Randomly choose 1 least used machine
-				Reference<TCMachineInfo> tcMachineInfo = deterministicRandom()->randomChoice(leastUsedMachines);
+				Reference<TCMachineInfo> tcMachineInfo = healthyMachines[machineUsage.randomLeastUsed()];
 				ASSERT(!tcMachineInfo->serversOnMachine.empty());
 				LocalityEntry process = tcMachineInfo->localityEntry;
 				forcedAttributes.push_back(process);
 			} else {
-				// when leastUsedMachine is empty, we will never find a team later, so we can simply return.
+				// when there is no healthy machine, we will never find a team later, so we can simply return.
 				return addedMachineTeams;
 			}
 
@@ -1422,8 +1488,18 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 				addMachineTeam(machines);
 				addedMachineTeams++;
 				// Update the remaining machine team budget because the budget may decrease by
-				// any value between 1 and storageTeamSize
-				remainingMachineTeamBudget = getRemainingMachineTeamBudget();
+				// any value between 1 and storageTeamSize. Only the machines on the new team changed, so there is no
+				// need to recount the budget of every machine (see getRemainingMachineTeamBudget()).
+				for (auto& machine : machines) {
+					if ((int)machine->machineTeams.size() <= SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER) {
+						--machineTeamBudget;
+					}
+					auto index = healthyMachineIndex.find(machine->machineID);
+					if (index != healthyMachineIndex.end()) {
+						machineUsage.increment(index->second);
+					}
+				}
+				remainingMachineTeamBudget = machineTeamBudget;
 			} else {
 				TraceEvent(SevWarn, "DataDistributionBuildTeams", distributorId)
 				    .detail("Primary", primary)
@@ -1484,27 +1560,6 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 		return false;
 	}
 
-	// Return the healthy server with the least number of correct-size server teams
-	Reference<TCServerInfo> findOneLeastUsedServer() {
-		vector<Reference<TCServerInfo>> leastUsedServers;
-		int minTeams = std::numeric_limits<int>::max();
-		for (auto& server : server_info) {
-			// Only pick healthy server, which is not failed or excluded.
-			if (server_status.get(server.first).isUnhealthy()) continue;
-
-			int numTeams = server.second->teams.size();
-			if (numTeams < minTeams) {
-				minTeams = numTeams;
-				leastUsedServers.clear();
-			}
-			if (minTeams == numTeams) {
-				leastUsedServers.push_back(server.second);
-			}
-		}
-
-		return deterministicRandom()->randomChoice(leastUsedServers);
-	}
-
 	// Randomly choose one machine team that has chosenServer and has the correct size
 	// When configuration is changed, we may have machine teams with old storageTeamSize
 	Reference<TCMachineTeamInfo> findOneRandomMachineTeam(Reference<TCServerInfo> chosenServer) {
@@ -1725,14 +1780,32 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 			addedMachineTeams = addBestMachineTeams(machineTeamsToBuild, remainingMachineTeamBudget);
 		}
 
-		while (addedTeams < teamsToBuild || addedTeams < remainingTeamBudget) {
+		// Index the healthy servers by how many server teams they are on, and collect the healthy servers on each
+		// machine. Server health cannot change while we build teams, so this is done once instead of for every team.
+		std::vector<Reference<TCServerInfo>> healthyServers;
+		std::map<UID, int> healthyServerIndex;
+		std::vector<int> serverTeamCounts;
+		std::map<Standalone<StringRef>, std::vector<Reference<TCServerInfo>>> healthyServersOnMachine;
+		for (auto& server : server_info) {
+			// Only pick healthy server, which is not failed or excluded.
+			if (server_status.get(server.first).isUnhealthy()) continue;
+
+			healthyServerIndex[server.first] = healthyServers.size();
+			healthyServers.push_back(server.second);
+			serverTeamCounts.push_back(server.second->teams.size());
+			healthyServersOnMachine[server.second->machine->machineID].push_back(server.second);
+		}
+		TeamCountTracker serverUsage(serverTeamCounts);
+		int serverTeamBudget = getRemainingServerTeamBudget();
+
+		while ((addedTeams < teamsToBuild || addedTeams < remainingTeamBudget) && !serverUsage.empty()) {
 			// Step 1: Create 1 best machine team
 			std::vector<UID> bestServerTeam;
 			int bestScore = std::numeric_limits<int>::max();
 			int maxAttempts = SERVER_KNOBS->BEST_OF_AMT; // BEST_OF_AMT = 4
 			for (int i = 0; i < maxAttempts && i < 100; ++i) {
 				// Step 2: Choose 1 least used server and then choose 1 least used machine team from the server
-				Reference<TCServerInfo> chosenServer = findOneLeastUsedServer();
+				Reference<TCServerInfo> chosenServer = healthyServers[serverUsage.randomLeastUsed()];
 				// Note: To avoid creating correlation of picked machine teams, we simply choose a random machine team
 				// instead of choosing the least used machine team.
 				// The correlation happens, for example, when we add two new machines, we may always choose the machine
@@ -1757,13 +1830,7 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 						serverID = chosenServer->id;
 						++chosenServerCount;
 					} else {
-						std::vector<Reference<TCServerInfo>> healthyProcesses;
-						for (auto it : machine->serversOnMachine) {
-							if (!server_status.get(it->id).isUnhealthy()) {
-								healthyProcesses.push_back(it);
-							}
-						}
-						serverID = deterministicRandom()->randomChoice(healthyProcesses)->id;
+						serverID = deterministicRandom()->randomChoice(healthyServersOnMachine[machine->machineID])->id;
 					}
 					serverTeam.push_back(serverID);
 				}
@@ -1783,7 +1850,7 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 				for (auto& server : serverTeam) {
 					score += server_info[server]->teams.size();
 				}
-				TraceEvent("BuildServerTeams")
+				TraceEvent(SevDebug, "BuildServerTeams")
 				    .detail("Score", score)
 				    .detail("BestScore", bestScore)
 				    .detail("TeamSize", serverTeam.size())
@@ -1800,9 +1867,24 @@ struct DDTeamCollection : ReferenceCounted<DDTeamCollection> {
 			}
 
 			// Step 4: Add the server team
+			std::vector<int> teamCountsBefore;
+			for (auto& serverID : bestServerTeam) {
+				teamCountsBefore.push_back(server_info[serverID]->teams.size());
+			}
 			addTeam(bestServerTeam.begin(), bestServerTeam.end(), false);
 			addedTeams++;
-			remainingTeamBudget = getRemainingServerTeamBudget();
+
+			// Only the servers on the new team changed, so update the budget and the usage index from them instead of
+			// recounting every server (see getRemainingServerTeamBudget()).
+			for (int j = 0; j < bestServerTeam.size(); j++) {
+				int teamCount = server_info[bestServerTeam[j]]->teams.size();
+				if (teamCount == teamCountsBefore[j]) continue; // The team was not added to the server
+				if (teamCount <= SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER) {
+					--serverTeamBudget;
+				}
+				serverUsage.increment(healthyServerIndex[bestServerTeam[j]]);
+			}
+			remainingTeamBudget = serverTeamBudget;
 
 			if (++loopCount > 2 * teamsToBuild * (configuration.storageTeamSize + 1)) {
 				break;
@@ -3602,6 +3684,42 @@ ACTOR Future<Void> pollMoveKeysLock( Database cx, MoveKeysLock lock ) {
 	}
 }
 
+// Relocates ranges registered for bulk load, so that their new destinations ingest and publish them (see fetchKeys).
+// Each registration is relocated once, when it first appears or changes.  The relocation retries until it moves the range
+// to a team disjoint from its current one, and the move that completes it clears the registration.
+ACTOR Future<Void> pollBulkLoads( Database cx, PromiseStream<RelocateShard> output ) {
+	// The registrations already relocated, by begin key, with their end key and value
+	state std::map<Key, std::pair<Key, Value>> queued;
+	loop {
+		wait(delay(SERVER_KNOBS->DD_BULK_LOAD_POLLING_DELAY, TaskPriority::DataDistribution));
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+				Standalone<RangeResultRef> bulkLoads = wait( krmGetRanges( &tr, bulkLoadPrefix, normalKeys, CLIENT_KNOBS->TOO_MANY, CLIENT_KNOBS->TOO_MANY ) );
+				std::map<Key, std::pair<Key, Value>> pending;
+				for(int i = 0; i < bulkLoads.size() - 1; i++) {
+					if( bulkLoads[i].value.size() ) {
+						auto registration = std::make_pair( Key(bulkLoads[i+1].key), Value(bulkLoads[i].value) );
+						auto q = queued.find( bulkLoads[i].key );
+						if( q == queued.end() || q->second != registration ) {
+							TEST(true); // Relocating a range registered for bulk load
+							// A split relocation asks for a new team, which a bulk loaded range needs
+							output.send( RelocateShard( KeyRangeRef( bulkLoads[i].key, bulkLoads[i+1].key ), PRIORITY_SPLIT_SHARD ) );
+						}
+						pending[bulkLoads[i].key] = registration;
+					}
+				}
+				// Completed registrations are forgotten, so that the range is relocated again if it is registered again
+				queued = std::move(pending);
+				break;
+			} catch( Error &e ) {
+				wait( tr.onError(e) );
+			}
+		}
+	}
+}
+
 struct DataDistributorData : NonCopyable, ReferenceCounted<DataDistributorData> {
 	Reference<AsyncVar<struct ServerDBInfo>> dbInfo;
 	UID ddId;
@@ -3788,6 +3906,7 @@ ACTOR Future<Void> dataDistribution(Reference<DataDistributorData> self)
 			}
 
 			actors.push_back( pollMoveKeysLock(cx, lock) );
+			actors.push_back( pollBulkLoads(cx, output) );
 			actors.push_back( reportErrorsExcept( dataDistributionTracker( initData, cx, output, shardsAffectedByTeamFailure, getShardMetrics, getAverageShardBytes.getFuture(), readyToStart, anyZeroHealthyTeams, self->ddId ), "DDTracker", self->ddId, &normalDDQueueErrors() ) );
 			actors.push_back( reportErrorsExcept( dataDistributionQueue( cx, output, input.getFuture(), getShardMetrics, processingUnhealthy, tcis, shardsAffectedByTeamFailure, lock, getAverageShardBytes, self->ddId, storageTeamSize, &lastLimited ), "DDQueue", self->ddId, &normalDDQueueErrors() ) );
 
@@ -3905,7 +4024,8 @@ DDTeamCollection* testTeamCollection(int teamSize, Reference<IReplicationPolicy>
 	return collection;
 }
 
-DDTeamCollection* testMachineTeamCollection(int teamSize, Reference<IReplicationPolicy> policy, int processCount) {
+DDTeamCollection* testMachineTeamCollection(int teamSize, Reference<IReplicationPolicy> policy, int processCount,
+                                            int processesPerMachine = 5, bool verbose = true) {
 	Database database = DatabaseContext::create(Reference<AsyncVar<ClientDBInfo>>(new AsyncVar<ClientDBInfo>()),
 	                                            Never(), LocalityData(), false);
 
@@ -3928,10 +4048,12 @@ DDTeamCollection* testMachineTeamCollection(int teamSize, Reference<IReplication
 		int dc_id = process_id / 1000;
 		int data_hall_id = process_id / 100;
 		int zone_id = process_id / 10;
-		int machine_id = process_id / 5;
+		int machine_id = process_id / processesPerMachine;
 
-		printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n", process_id, zone_id,
-		       machine_id, interface.address().toString().c_str());
+		if (verbose) {
+			printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n", process_id,
+			       zone_id, machine_id, interface.address().toString().c_str());
+		}
 		interface.locality.set(LiteralStringRef("processid"), Standalone<StringRef>(std::to_string(process_id)));
 		interface.locality.set(LiteralStringRef("machineid"), Standalone<StringRef>(std::to_string(machine_id)));
 		interface.locality.set(LiteralStringRef("zoneid"), Standalone<StringRef>(std::to_string(zone_id)));
@@ -3944,7 +4066,9 @@ DDTeamCollection* testMachineTeamCollection(int teamSize, Reference<IReplication
 	}
 
 	int totalServerIndex = collection->constructMachinesFromServers();
-	printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+	if (verbose) {
+		printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+	}
 
 	return collection;
 }
@@ -4096,3 +4220,37 @@ TEST_CASE("/DataDistribution/AddTeamsBestOf/NotEnoughServers") {
 
 	return Void();
 }
+
+// Measures how long it takes to build the desired number of teams from scratch for clusters of various sizes
+TEST_CASE("!/DataDistribution/performance/buildTeams") {
+	state std::vector<int> clusterSizes = { 100, 500, 1000, 2000, 5000 };
+	state int i = 0;
+	for (; i < clusterSizes.size(); i++) {
+		int processCount = clusterSizes[i];
+		int desiredTeams = SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * processCount;
+		int maxTeams = SERVER_KNOBS->MAX_TEAMS_PER_SERVER * processCount;
+		Reference<IReplicationPolicy> policy = Reference<IReplicationPolicy>(
+		    new PolicyAcross(3, "zoneid", Reference<IReplicationPolicy>(new PolicyOne())));
+
+		uint64_t memoryBefore = getMemoryUsage();
+		double start = timer();
+		DDTeamCollection* collection = testMachineTeamCollection(3, policy, processCount, 10, false);
+		double built = timer();
+
+		int addedTeams = collection->addTeamsBestOf(desiredTeams, desiredTeams, maxTeams,
+		                                            collection->getRemainingServerTeamBudget());
+		double elapsed = timer() - built;
+		int64_t memoryUsed = getMemoryUsage() - memoryBefore;
+
+		printf("servers: %d machines: %d serverTeams: %d machineTeams: %d setupTime: %.3f buildTime: %.3f "
+		       "memoryUsed: %lld\n",
+		       processCount, (int)collection->machine_info.size(), addedTeams, (int)collection->machineTeams.size(),
+		       built - start, elapsed, (long long)memoryUsed);
+		ASSERT(collection->sanityCheckTeams());
+
+		delete collection;
+		wait(yield());
+	}
+
+	return Void();
+}
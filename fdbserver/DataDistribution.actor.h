@@ -47,6 +47,7 @@ enum {
 	PRIORITY_RECOVER_MOVE    = 110,
 	PRIORITY_REBALANCE_UNDERUTILIZED_TEAM  = 120,
 	PRIORITY_REBALANCE_OVERUTILIZED_TEAM  = 121,
+	PRIORITY_REBALANCE_READ_OVERUTILIZED_TEAM = 122,
 	PRIORITY_TEAM_HEALTHY    = 140,
 	PRIORITY_TEAM_CONTAINS_UNDESIRED_SERVER = 150,
 
@@ -74,6 +75,7 @@ struct IDataDistributionTeam {
 	virtual void addDataInFlightToTeam( int64_t delta ) = 0;
 	virtual int64_t getDataInFlightToTeam() = 0;
 	virtual int64_t getLoadBytes( bool includeInFlight = true, double inflightPenalty = 1.0 ) = 0;
+	virtual int64_t getLoadReadBandwidth() = 0;
 	virtual int64_t getMinFreeSpace( bool includeInFlight = true ) = 0;
 	virtual double getMinFreeSpaceRatio( bool includeInFlight = true ) = 0;
 	virtual bool hasHealthyFreeSpace() = 0;
@@ -104,13 +106,14 @@ struct GetTeamRequest {
 	bool wantsNewServers;
 	bool wantsTrueBest;
 	bool preferLowerUtilization;
+	bool useReadLoad;	// Rank teams by read bandwidth rather than by bytes stored
 	double inflightPenalty;
 	std::vector<UID> sources;
 	std::vector<UID> completeSources;
 	Promise< Optional< Reference<IDataDistributionTeam> > > reply;
 
 	GetTeamRequest() {}
-	GetTeamRequest( bool wantsNewServers, bool wantsTrueBest, bool preferLowerUtilization, double inflightPenalty = 1.0 ) : wantsNewServers( wantsNewServers ), wantsTrueBest( wantsTrueBest ), preferLowerUtilization( preferLowerUtilization ), inflightPenalty( inflightPenalty ) {}
+	GetTeamRequest( bool wantsNewServers, bool wantsTrueBest, bool preferLowerUtilization, double inflightPenalty = 1.0, bool useReadLoad = false ) : wantsNewServers( wantsNewServers ), wantsTrueBest( wantsTrueBest ), preferLowerUtilization( preferLowerUtilization ), useReadLoad( useReadLoad ), inflightPenalty( inflightPenalty ) {}
 };
 
 struct GetMetricsRequest {
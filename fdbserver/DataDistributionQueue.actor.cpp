@@ -50,6 +50,7 @@ struct RelocateData {
 		wantsNewServers(
 			rs.priority == PRIORITY_REBALANCE_SHARD ||
 			rs.priority == PRIORITY_REBALANCE_OVERUTILIZED_TEAM ||
+			rs.priority == PRIORITY_REBALANCE_READ_OVERUTILIZED_TEAM ||
 			rs.priority == PRIORITY_REBALANCE_UNDERUTILIZED_TEAM ||
 			rs.priority == PRIORITY_SPLIT_SHARD ||
 			rs.priority == PRIORITY_TEAM_REDUNDANT ), interval("QueuedRelocation") {}
@@ -159,6 +160,12 @@ public:
 		});
 	}
 
+	virtual int64_t getLoadReadBandwidth() {
+		return sum([](Reference<IDataDistributionTeam> team) {
+			return team->getLoadReadBandwidth();
+		});
+	}
+
 	virtual int64_t getMinFreeSpace(bool includeInFlight = true) {
 		int64_t result = std::numeric_limits<int64_t>::max();
 		for (auto it = teams.begin(); it != teams.end(); it++) {
@@ -894,7 +901,8 @@ ACTOR Future<Void> dataDistributionRelocator( DDQueueData *self, RelocateData rd
 					if(rd.priority >= PRIORITY_TEAM_UNHEALTHY) inflightPenalty = SERVER_KNOBS->INFLIGHT_PENALTY_UNHEALTHY;
 					if(rd.priority >= PRIORITY_TEAM_1_LEFT) inflightPenalty = SERVER_KNOBS->INFLIGHT_PENALTY_ONE_LEFT;
 
-					auto req = GetTeamRequest(rd.wantsNewServers, rd.priority == PRIORITY_REBALANCE_UNDERUTILIZED_TEAM, true, inflightPenalty);
+					bool readRebalance = rd.priority == PRIORITY_REBALANCE_READ_OVERUTILIZED_TEAM;
+					auto req = GetTeamRequest(rd.wantsNewServers, rd.priority == PRIORITY_REBALANCE_UNDERUTILIZED_TEAM || readRebalance, true, inflightPenalty, readRebalance);
 					req.sources = rd.src;
 					req.completeSources = rd.completeSources;
 					Optional<Reference<IDataDistributionTeam>> bestTeam = wait(brokenPromiseToNever(self->teamCollections[tciIndex].getTeam.getReply(req)));
@@ -1033,7 +1041,7 @@ ACTOR Future<Void> dataDistributionRelocator( DDQueueData *self, RelocateData rd
 
 			//TraceEvent("RelocateShardFinished", distributorId).detail("RelocateId", relocateShardInterval.pairID);
 
-			if( error.code() != error_code_move_to_removed_server ) {
+			if( error.code() != error_code_move_to_removed_server && error.code() != error_code_bulk_load_overlapping_team ) {
 				if( !error.code() ) {
 					try {
 						wait( healthyDestinations.updatePhysicalMetrics() ); //prevent a gap between the polling for an increase in physical metrics and decrementing data in flight
@@ -1064,7 +1072,8 @@ ACTOR Future<Void> dataDistributionRelocator( DDQueueData *self, RelocateData rd
 					throw error;
 				}
 			} else {
-				TEST(true);  // move to removed server
+				TEST(error.code() == error_code_move_to_removed_server);  // move to removed server
+				TEST(error.code() == error_code_bulk_load_overlapping_team);  // bulk loaded range moved onto one of its sources
 				healthyDestinations.addDataInFlightToTeam( -metrics.bytes );
 				wait( delay( SERVER_KNOBS->RETRY_RELOCATESHARD_DELAY, TaskPriority::DataDistributionLaunch ) );
 			}
@@ -1121,6 +1130,94 @@ ACTOR Future<bool> rebalanceTeams( DDQueueData* self, int priority, Reference<ID
 	return false;
 }
 
+// Moves the most read-hot of a sample of the source team's shards to the destination team, if that narrows the gap
+//  between the two teams' read bandwidth rather than just moving the hot spot.
+ACTOR Future<bool> rebalanceReadLoad( DDQueueData* self, Reference<IDataDistributionTeam> sourceTeam, Reference<IDataDistributionTeam> destTeam, bool primary ) {
+	if(g_network->isSimulated() && g_simulator.speedUpSimulation) {
+		return false;
+	}
+
+	state std::vector<KeyRange> shards = self->shardsAffectedByTeamFailure->getShardsFor( ShardsAffectedByTeamFailure::Team( sourceTeam->getServerIDs(), primary ) );
+
+	if( !shards.size() )
+		return false;
+
+	deterministicRandom()->randomShuffle( shards );
+	if( shards.size() > SERVER_KNOBS->DD_READ_REBALANCE_SHARD_SAMPLES )
+		shards.resize( SERVER_KNOBS->DD_READ_REBALANCE_SHARD_SAMPLES );
+
+	state std::vector<Future<StorageMetrics>> sampled;
+	for( auto& shard : shards )
+		sampled.push_back( brokenPromiseToNever( self->getShardMetrics.getReply(GetMetricsRequest(shard)) ) );
+	wait( waitForAll( sampled ) );
+
+	int hottest = 0;
+	for( int i = 1; i < sampled.size(); i++ ) {
+		if( sampled[i].get().bytesReadPerKSecond > sampled[hottest].get().bytesReadPerKSecond )
+			hottest = i;
+	}
+	KeyRange moveShard = shards[hottest];
+	StorageMetrics metrics = sampled[hottest].get();
+
+	int64_t sourceRead = sourceTeam->getLoadReadBandwidth();
+	int64_t destRead = destTeam->getLoadReadBandwidth();
+	if( metrics.bytesReadPerKSecond < SERVER_KNOBS->SHARD_MIN_BYTES_READ_PER_KSEC || sourceRead - destRead <= 2 * metrics.bytesReadPerKSecond )
+		return false;
+
+	//verify the shard is still in sabtf
+	std::vector<KeyRange> current = self->shardsAffectedByTeamFailure->getShardsFor( ShardsAffectedByTeamFailure::Team( sourceTeam->getServerIDs(), primary ) );
+	for( int i = 0; i < current.size(); i++ ) {
+		if( moveShard == current[i] ) {
+			TraceEvent("BgDDReadHotChopper", self->distributorId)
+				.detail("SourceBytesReadPerKSec", sourceRead)
+				.detail("DestBytesReadPerKSec", destRead)
+				.detail("ShardBytesReadPerKSec", metrics.bytesReadPerKSecond)
+				.detail("ShardBegin", moveShard.begin)
+				.detail("ShardEnd", moveShard.end)
+				.detail("SourceTeam", sourceTeam->getDesc())
+				.detail("DestTeam", destTeam->getDesc());
+
+			self->output.send( RelocateShard( moveShard, PRIORITY_REBALANCE_READ_OVERUTILIZED_TEAM ) );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+ACTOR Future<Void> BgDDReadHotChopper( DDQueueData* self, int teamCollectionIndex ) {
+	state double checkDelay = SERVER_KNOBS->BG_DD_POLLING_INTERVAL;
+	state int resetCount = SERVER_KNOBS->DD_REBALANCE_RESET_AMOUNT;
+	loop {
+		wait( delay(checkDelay, TaskPriority::DataDistributionLaunch) );
+		if (self->priority_relocations[PRIORITY_REBALANCE_READ_OVERUTILIZED_TEAM] < SERVER_KNOBS->DD_REBALANCE_PARALLELISM) {
+			state Optional<Reference<IDataDistributionTeam>> coldTeam = wait( brokenPromiseToNever( self->teamCollections[teamCollectionIndex].getTeam.getReply( GetTeamRequest( true, true, true, 1.0, true ) ) ) );
+			if( coldTeam.present() && coldTeam.get()->getMinFreeSpaceRatio() > SERVER_KNOBS->FREE_SPACE_RATIO_DD_CUTOFF ) {
+				state Optional<Reference<IDataDistributionTeam>> hotTeam = wait( brokenPromiseToNever( self->teamCollections[teamCollectionIndex].getTeam.getReply( GetTeamRequest( true, true, false, 1.0, true ) ) ) );
+				if( hotTeam.present() ) {
+					bool moved = wait( rebalanceReadLoad( self, hotTeam.get(), coldTeam.get(), teamCollectionIndex == 0 ) );
+					if(moved) {
+						resetCount = 0;
+					} else {
+						resetCount++;
+					}
+				}
+			}
+		}
+
+		if( now() - (*self->lastLimited) < SERVER_KNOBS->BG_DD_SATURATION_DELAY ) {
+			checkDelay = std::min(SERVER_KNOBS->BG_DD_MAX_WAIT, checkDelay * SERVER_KNOBS->BG_DD_INCREASE_RATE);
+		} else {
+			checkDelay = std::max(SERVER_KNOBS->BG_DD_MIN_WAIT, checkDelay / SERVER_KNOBS->BG_DD_DECREASE_RATE);
+		}
+
+		if(resetCount >= SERVER_KNOBS->DD_REBALANCE_RESET_AMOUNT && checkDelay < SERVER_KNOBS->BG_DD_POLLING_INTERVAL) {
+			checkDelay = SERVER_KNOBS->BG_DD_POLLING_INTERVAL;
+			resetCount = SERVER_KNOBS->DD_REBALANCE_RESET_AMOUNT;
+		}
+	}
+}
+
 ACTOR Future<Void> BgDDMountainChopper( DDQueueData* self, int teamCollectionIndex ) {
 	state double checkDelay = SERVER_KNOBS->BG_DD_POLLING_INTERVAL;
 	state int resetCount = SERVER_KNOBS->DD_REBALANCE_RESET_AMOUNT;
@@ -1220,6 +1317,7 @@ ACTOR Future<Void> dataDistributionQueue(
 	for (int i = 0; i < teamCollections.size(); i++) {
 		balancingFutures.push_back(BgDDMountainChopper(&self, i));
 		balancingFutures.push_back(BgDDValleyFiller(&self, i));
+		balancingFutures.push_back(BgDDReadHotChopper(&self, i));
 	}
 	balancingFutures.push_back(delayedAsyncVar(self.rawProcessingUnhealthy, processingUnhealthy, 0));
 
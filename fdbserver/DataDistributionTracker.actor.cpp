@@ -41,6 +41,19 @@ BandwidthStatus getBandwidthStatus( StorageMetrics const& metrics ) {
 	return BandwidthStatusNormal;
 }
 
+BandwidthStatus getReadBandwidthStatus( StorageMetrics const& metrics ) {
+	if( metrics.bytesReadPerKSecond > SERVER_KNOBS->SHARD_MAX_BYTES_READ_PER_KSEC )
+		return BandwidthStatusHigh;
+	else if( metrics.bytesReadPerKSecond < SERVER_KNOBS->SHARD_MIN_BYTES_READ_PER_KSEC )
+		return BandwidthStatusLow;
+
+	return BandwidthStatusNormal;
+}
+
+const char* bandwidthStatusName( BandwidthStatus status ) {
+	return status == BandwidthStatusHigh ? "High" : status == BandwidthStatusNormal ? "Normal" : "Low";
+}
+
 ACTOR Future<Void> updateMaxShardSize( Reference<AsyncVar<int64_t>> dbSizeEstimate, Reference<AsyncVar<Optional<int64_t>>> maxShardSize ) {
 	state int64_t lastDbSize = 0;
 	state int64_t granularity = g_network->isSimulated() ?
@@ -79,6 +92,9 @@ struct DataDistributionTracker {
 	Promise<Void> readyToStart;
 	Reference<AsyncVar<bool>> anyZeroHealthyTeams;
 
+	// Shards whose last reported read bandwidth was above SHARD_MAX_BYTES_READ_PER_KSEC, with that bandwidth
+	std::map<KeyRange, int64_t> readHotShards;
+
 	DataDistributionTracker(Database cx, UID distributorId, Promise<Void> const& readyToStart, PromiseStream<RelocateShard> const& output, Reference<ShardsAffectedByTeamFailure> shardsAffectedByTeamFailure, Reference<AsyncVar<bool>> anyZeroHealthyTeams)
 		: cx(cx), distributorId( distributorId ), dbSizeEstimate( new AsyncVar<int64_t>() ),
 			maxShardSize( new AsyncVar<Optional<int64_t>>() ),
@@ -110,6 +126,7 @@ ShardSizeBounds getShardSizeBounds(KeyRangeRef shard, int64_t maxShardSize) {
 
 	bounds.max.bytesPerKSecond = bounds.max.infinity;
 	bounds.max.iosPerKSecond = bounds.max.infinity;
+	bounds.max.bytesReadPerKSecond = bounds.max.infinity;
 
 	//The first shard can have arbitrarily small size
 	if(shard.begin == allKeys.begin) {
@@ -120,11 +137,13 @@ ShardSizeBounds getShardSizeBounds(KeyRangeRef shard, int64_t maxShardSize) {
 
 	bounds.min.bytesPerKSecond = 0;
 	bounds.min.iosPerKSecond = 0;
+	bounds.min.bytesReadPerKSecond = 0;
 
 	//The permitted error is 1/3 of the general-case minimum bytes (even in the special case where this is the last shard)
 	bounds.permittedError.bytes = bounds.max.bytes / SERVER_KNOBS->SHARD_BYTES_RATIO / 3;
 	bounds.permittedError.bytesPerKSecond = bounds.permittedError.infinity;
 	bounds.permittedError.iosPerKSecond = bounds.permittedError.infinity;
+	bounds.permittedError.bytesReadPerKSecond = bounds.permittedError.infinity;
 
 	return bounds;
 }
@@ -173,6 +192,20 @@ ACTOR Future<Void> trackShardBytes(
 				} else
 					ASSERT( false );
 
+				auto readBandwidthStatus = getReadBandwidthStatus( shardSize->get().get() );
+				if( readBandwidthStatus == BandwidthStatusNormal ) {
+					bounds.max.bytesReadPerKSecond = SERVER_KNOBS->SHARD_MAX_BYTES_READ_PER_KSEC;
+					bounds.min.bytesReadPerKSecond = SERVER_KNOBS->SHARD_MIN_BYTES_READ_PER_KSEC;
+					bounds.permittedError.bytesReadPerKSecond = bounds.min.bytesReadPerKSecond / 4;
+				} else if( readBandwidthStatus == BandwidthStatusHigh ) {
+					bounds.max.bytesReadPerKSecond = bounds.max.infinity;
+					bounds.min.bytesReadPerKSecond = SERVER_KNOBS->SHARD_MAX_BYTES_READ_PER_KSEC;
+					bounds.permittedError.bytesReadPerKSecond = bounds.min.bytesReadPerKSecond / 4;
+				} else {
+					bounds.max.bytesReadPerKSecond = SERVER_KNOBS->SHARD_MIN_BYTES_READ_PER_KSEC;
+					bounds.min.bytesReadPerKSecond = 0;
+					bounds.permittedError.bytesReadPerKSecond = bounds.max.bytesReadPerKSecond / 4;
+				}
 			} else {
 				bounds.max.bytes = -1;
 				bounds.min.bytes = -1;
@@ -180,6 +213,9 @@ ACTOR Future<Void> trackShardBytes(
 				bounds.max.bytesPerKSecond = bounds.max.infinity;
 				bounds.min.bytesPerKSecond = 0;
 				bounds.permittedError.bytesPerKSecond = bounds.permittedError.infinity;
+				bounds.max.bytesReadPerKSecond = bounds.max.infinity;
+				bounds.min.bytesReadPerKSecond = 0;
+				bounds.permittedError.bytesReadPerKSecond = bounds.permittedError.infinity;
 			}
 
 			bounds.max.iosPerKSecond = bounds.max.infinity;
@@ -205,9 +241,15 @@ ACTOR Future<Void> trackShardBytes(
 			if( shardSize->get().present() && addToSizeEstimate )
 				self->dbSizeEstimate->set( self->dbSizeEstimate->get() + metrics.bytes - shardSize->get().get().bytes );
 
+			if( getReadBandwidthStatus( metrics ) == BandwidthStatusHigh )
+				self->readHotShards[keys] = metrics.bytesReadPerKSecond;
+			else
+				self->readHotShards.erase( keys );
+
 			shardSize->set( metrics );
 		}
 	} catch( Error &e ) {
+		self->readHotShards.erase( keys );
 		if (e.code() != error_code_actor_cancelled)
 			self->output.sendError(e);		// Propagate failure to dataDistributionTracker
 		throw e;
@@ -311,6 +353,7 @@ ACTOR Future<Void> shardSplitter(
 {
 	state StorageMetrics metrics = shardSize->get().get();
 	state BandwidthStatus bandwidthStatus = getBandwidthStatus( shardSize->get().get() );
+	state BandwidthStatus readBandwidthStatus = getReadBandwidthStatus( shardSize->get().get() );
 
 	//Split
 	TEST(true);  // shard to be split
@@ -319,6 +362,7 @@ ACTOR Future<Void> shardSplitter(
 	splitMetrics.bytes = shardBounds.max.bytes / 2;
 	splitMetrics.bytesPerKSecond = keys.begin >= keyServersKeys.begin ? splitMetrics.infinity : SERVER_KNOBS->SHARD_SPLIT_BYTES_PER_KSEC;
 	splitMetrics.iosPerKSecond = splitMetrics.infinity;
+	splitMetrics.bytesReadPerKSecond = keys.begin >= keyServersKeys.begin ? splitMetrics.infinity : SERVER_KNOBS->SHARD_SPLIT_BYTES_READ_PER_KSEC;
 
 	state Standalone<VectorRef<KeyRef>> splitKeys = wait( getSplitKeys(self, keys, splitMetrics, metrics ) );
 	//fprintf(stderr, "split keys:\n");
@@ -333,8 +377,10 @@ ACTOR Future<Void> shardSplitter(
 			.detail("End", keys.end)
 			.detail("MaxBytes", shardBounds.max.bytes)
 			.detail("MetricsBytes", metrics.bytes)
-			.detail("Bandwidth", bandwidthStatus == BandwidthStatusHigh ? "High" : bandwidthStatus == BandwidthStatusNormal ? "Normal" : "Low")
+			.detail("Bandwidth", bandwidthStatusName( bandwidthStatus ))
 			.detail("BytesPerKSec", metrics.bytesPerKSecond)
+			.detail("ReadBandwidth", bandwidthStatusName( readBandwidthStatus ))
+			.detail("BytesReadPerKSec", metrics.bytesReadPerKSecond)
 			.detail("NumShards", numShards);
 	}
 
@@ -361,6 +407,7 @@ ACTOR Future<Void> shardSplitter(
 
 		self->sizeChanges.add( changeSizes( self, keys, shardSize->get().get().bytes ) );
 	} else {
+		TEST( readBandwidthStatus == BandwidthStatusHigh ); // Read-hot shard could not be split
 		wait( delay(1.0, TaskPriority::DataDistribution) ); //In case the reason the split point was off was due to a discrepancy between storage servers
 	}
 	return Void();
@@ -426,6 +473,7 @@ Future<Void> shardMerger(
 		auto shardBounds = getShardSizeBounds( merged, maxShardSize );
 		if( endingStats.bytes >= shardBounds.min.bytes ||
 				getBandwidthStatus( endingStats ) != BandwidthStatusLow ||
+				getReadBandwidthStatus( endingStats ) != BandwidthStatusLow ||
 				shardsMerged >= SERVER_KNOBS->DD_MERGE_LIMIT ) {
 			// The merged range is larger than the min bounds se we cannot continue merging in this direction.
 			//  This means that:
@@ -478,9 +526,11 @@ ACTOR Future<Void> shardEvaluator(
 	StorageMetrics const& stats = shardSize->get().get();
 
 	bool shouldSplit = stats.bytes > shardBounds.max.bytes ||
-							( getBandwidthStatus( stats ) == BandwidthStatusHigh && keys.begin < keyServersKeys.begin );
+							( getBandwidthStatus( stats ) == BandwidthStatusHigh && keys.begin < keyServersKeys.begin ) ||
+							( getReadBandwidthStatus( stats ) == BandwidthStatusHigh && keys.begin < keyServersKeys.begin );
 	bool shouldMerge = stats.bytes < shardBounds.min.bytes &&
-							getBandwidthStatus( stats ) == BandwidthStatusLow;
+							getBandwidthStatus( stats ) == BandwidthStatusLow &&
+							getReadBandwidthStatus( stats ) == BandwidthStatusLow;
 
 	// Every invocation must set this or clear it
 	if(shouldMerge && !self->anyZeroHealthyTeams->get()) {
@@ -650,6 +700,28 @@ ACTOR Future<Void> fetchShardMetrics( DataDistributionTracker* self, GetMetricsR
 	return Void();
 }
 
+// Logs the shards with the highest read bandwidth, which status reports as the cluster's read hot spots
+void logReadHotShards( DataDistributionTracker* self ) {
+	std::vector<std::pair<int64_t, KeyRange>> hottest;
+	hottest.reserve( self->readHotShards.size() );
+	for( auto& it : self->readHotShards )
+		hottest.push_back( std::make_pair( it.second, it.first ) );
+
+	int count = std::min<int>( hottest.size(), SERVER_KNOBS->DD_READ_HOT_SHARDS_LOGGED );
+	std::partial_sort( hottest.begin(), hottest.begin() + count, hottest.end(),
+		[]( std::pair<int64_t, KeyRange> const& a, std::pair<int64_t, KeyRange> const& b ) { return a.first > b.first; } );
+
+	TraceEvent e("DDTrackerReadHotShards", self->distributorId);
+	e.detail("ReadHotShards", self->readHotShards.size());
+	e.detail("Logged", count);
+	for( int i = 0; i < count; i++ ) {
+		e.detail(format("Shard%dBegin", i), hottest[i].second.begin);
+		e.detail(format("Shard%dEnd", i), hottest[i].second.end);
+		e.detail(format("Shard%dBytesReadPerKSec", i), hottest[i].first);
+	}
+	e.trackLatest( "DDTrackerReadHotShards" );
+}
+
 ACTOR Future<Void> dataDistributionTracker(
 	Reference<InitialDataDistribution> initData,
 	Database cx,
@@ -677,6 +749,8 @@ ACTOR Future<Void> dataDistributionTracker(
 					.detail("TotalSizeBytes", self.dbSizeEstimate->get())
 					.trackLatest( "DDTrackerStats" );
 
+				logReadHotShards( &self );
+
 				loggingTrigger = delay(SERVER_KNOBS->DATA_DISTRIBUTION_LOGGING_INTERVAL);
 			}
 			when( GetMetricsRequest req = waitNext( getShardMetrics.getFuture() ) ) {
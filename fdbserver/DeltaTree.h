@@ -35,13 +35,17 @@
 // available prefix bytes from the ancestor T which shares the most prefix bytes with
 // the item T being encoded.
 //
+// The user of a tree may pass a sharedPrefixLen when building and reading it, which is a number of
+// prefix bytes that every item and both bounds are known to have in common.  Deltas can then encode
+// prefix lengths relative to it.
+//
 // T requirements
 //
 //    Must be compatible with Standalone<T> and must implement the following additional methods:
 //
 //    // Writes to d a delta which can create *this from base
 //    // commonPrefix can be passed in if known
-//    void writeDelta(dT &d, const T &base, int commonPrefix = -1) const;
+//    void writeDelta(dT &d, const T &base, int commonPrefix = -1, int sharedPrefixLen = 0) const;
 //
 //    // Compare *this to t, returns < 0 for less than, 0 for equal, > 0 for greater than
 //    int compare(const T &rhs) const;
@@ -61,7 +65,7 @@
 //    int size();
 //
 //    // Returns the T created by applying the delta to prev or next
-//    T apply(const T &base, Arena &localStorage) const;
+//    T apply(const T &base, int sharedPrefixLen, Arena &localStorage) const;
 //
 //    // Stores a boolean which DeltaTree will later use to determine the base node for a node's delta
 //    void setPrefixSource(bool val);
@@ -129,9 +133,9 @@ public:
 	}
 
 	struct DecodedNode {
-		DecodedNode(Node *raw, const T *prev, const T *next, Arena &arena)
-		  : raw(raw), parent(nullptr), left(nullptr), right(nullptr), prev(prev), next(next),
-		    item(raw->delta().apply(raw->delta().getPrefixSource() ? *prev : *next, arena))
+		DecodedNode(Node *raw, const T *prev, const T *next, int sharedPrefixLen, Arena &arena)
+		  : raw(raw), parent(nullptr), left(nullptr), right(nullptr), prev(prev), next(next), sharedPrefixLen(sharedPrefixLen),
+		    item(raw->delta().apply(raw->delta().getPrefixSource() ? *prev : *next, sharedPrefixLen, arena))
 		{
 			//printf("DecodedNode1 raw=%p delta=%s\n", raw, raw->delta().toString().c_str());
 		}
@@ -140,7 +144,8 @@ public:
 		  : parent(parent), raw(raw), left(nullptr), right(nullptr),
 		    prev(left ? parent->prev : &parent->item),
 		    next(left ? &parent->item : parent->next),
-		    item(raw->delta().apply(raw->delta().getPrefixSource() ? *prev : *next, arena))
+		    sharedPrefixLen(parent->sharedPrefixLen),
+		    item(raw->delta().apply(raw->delta().getPrefixSource() ? *prev : *next, sharedPrefixLen, arena))
 		{
 			//printf("DecodedNode2 raw=%p delta=%s\n", raw, raw->delta().toString().c_str());
 		}
@@ -151,6 +156,7 @@ public:
 		DecodedNode *right;
 		const T *prev;  // greatest ancestor to the left
 		const T *next;  // least ancestor to the right
+		int sharedPrefixLen;
 		T item;
 
 		DecodedNode *getRight(Arena &arena) {
@@ -180,14 +186,14 @@ public:
 	// Any node decoded by any cursor is placed in cache for use
 	// by other cursors.
 	struct Reader : FastAllocated<Reader> {
-		Reader(const void *treePtr = nullptr, const T *lowerBound = nullptr, const T *upperBound = nullptr)
+		Reader(const void *treePtr = nullptr, const T *lowerBound = nullptr, const T *upperBound = nullptr, int sharedPrefixLen = 0)
 			: tree((DeltaTree *)treePtr), lower(lowerBound), upper(upperBound)  {
 
 			// TODO: Remove these copies into arena and require users of Reader to keep prev and next alive during its lifetime
 			lower = new(arena) T(arena, *lower);
 			upper = new(arena) T(arena, *upper);
 
-			root = (tree->nodeBytes == 0) ? nullptr : new (arena) DecodedNode(&tree->root(), lower, upper, arena);
+			root = (tree->nodeBytes == 0) ? nullptr : new (arena) DecodedNode(&tree->root(), lower, upper, sharedPrefixLen, arena);
 		}
 
 		const T *lowerBound() const {
@@ -335,14 +341,14 @@ public:
 	};
 
 	// Returns number of bytes written
-	int build(const T *begin, const T *end, const T *prev, const T *next) {
+	int build(const T *begin, const T *end, const T *prev, const T *next, int sharedPrefixLen = 0) {
 		//printf("tree size: %d   node size: %d\n", sizeof(DeltaTree), sizeof(Node));
 		int count = end - begin;
 		initialDepth = (uint8_t)log2(count) + 1;
 
 		// The boundary leading to the new page acts as the last time we branched right
 		if(begin != end) {
-			nodeBytes = build(root(), begin, end, prev, next);
+			nodeBytes = build(root(), begin, end, prev, next, sharedPrefixLen);
 		}
 		else {
 			nodeBytes = 0;
@@ -351,7 +357,7 @@ public:
 	}
 
 private:
-	static OffsetT build(Node &root, const T *begin, const T *end, const T *prev, const T *next) {
+	static OffsetT build(Node &root, const T *begin, const T *end, const T *prev, const T *next, int sharedPrefixLen) {
 		//printf("build: %s to %s\n", begin->toString().c_str(), (end - 1)->toString().c_str());
 		//printf("build: root at %p  sizeof(Node) %d  delta at %p  \n", &root, sizeof(Node), &root.delta());
 		ASSERT(end != begin);
@@ -382,7 +388,7 @@ private:
 			base = next;
 		}
 
-		int deltaSize = item.writeDelta(root.delta(), *base, commonPrefix);
+		int deltaSize = item.writeDelta(root.delta(), *base, commonPrefix, sharedPrefixLen);
 		root.delta().setPrefixSource(prefixSourcePrev);
 		//printf("Serialized %s to %p\n", item.toString().c_str(), &root.delta());
 
@@ -391,7 +397,7 @@ private:
 
 		// Serialize left child
 		if(count > 1) {
-			wptr += build(*(Node *)wptr, begin, begin + mid, prev, &item);
+			wptr += build(*(Node *)wptr, begin, begin + mid, prev, &item, sharedPrefixLen);
 			root.leftChildOffset = deltaSize;
 		}
 		else {
@@ -401,7 +407,7 @@ private:
 		// Serialize right child
 		if(count > 2) {
 			root.rightChildOffset = wptr - (uint8_t *)&root.delta();
-			wptr += build(*(Node *)wptr, begin + mid + 1, end, &item, next);
+			wptr += build(*(Node *)wptr, begin + mid + 1, end, &item, next, sharedPrefixLen);
 		}
 		else {
 			root.rightChildOffset = 0;
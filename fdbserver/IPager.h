@@ -51,7 +51,7 @@ static const int invalidLogicalPageID = LogicalPageID(-1);
 
 class IPage {
 public:
-	IPage() : userData(nullptr) {}
+	IPage() : userData(nullptr), level(0) {}
 
 	virtual uint8_t const* begin() const = 0;
 	virtual uint8_t* mutate() = 0;
@@ -74,6 +74,10 @@ public:
 
 	mutable void *userData;
 	mutable void (*userDataDestructor)(void *);
+
+	// Set by the pager's user to the page's height in its index structure, 0 for leaf pages.  Pagers that cache pages
+	// may keep pages with a nonzero level in preference to leaf pages.
+	mutable int level;
 };
 
 class IPagerSnapshot {
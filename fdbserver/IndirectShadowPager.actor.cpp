@@ -25,6 +25,13 @@
 #include "flow/actorcompiler.h"
 #include "fdbrpc/crc32c.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 struct SumType {
 	bool operator==(const SumType &rhs) const { return crc == rhs.crc; }
 	uint32_t crc;
@@ -75,6 +82,51 @@ inline void checksumWrite(IAsyncFile *file, uint8_t *page, int pageSize, Logical
 	checksum(file, page, pageSize, logical, physical, true);
 }
 
+Reference<MappedPageFile> MappedPageFile::open(std::string const& filename, int64_t bytes) {
+#ifdef _WIN32
+	return Reference<MappedPageFile>();
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) {
+		TraceEvent(SevWarn, "PagerMapFileOpenFailed").GetLastError().detail("Filename", filename);
+		return Reference<MappedPageFile>();
+	}
+
+	// Never map past the end of the file, since touching such a page would fault
+	struct stat st;
+	if(fstat(fd, &st) == 0) {
+		bytes = std::min<int64_t>(bytes, st.st_size);
+	}
+	bytes -= bytes % IndirectShadowPage::PAGE_BYTES;
+
+	void *base = nullptr;
+	if(bytes > 0) {
+		base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+		if(base == MAP_FAILED) {
+			TraceEvent(SevWarn, "PagerMapFileFailed").GetLastError().detail("Filename", filename).detail("Bytes", bytes);
+			base = nullptr;
+		}
+	}
+	::close(fd);
+
+	if(base == nullptr) {
+		return Reference<MappedPageFile>();
+	}
+	return Reference<MappedPageFile>(new MappedPageFile((uint8_t *)base, bytes));
+#endif
+}
+
+MappedPageFile::~MappedPageFile() {
+#ifndef _WIN32
+	munmap(base, bytes);
+#endif
+}
+
+uint8_t *MappedPageFile::pageData(PhysicalPageID pageID) const {
+	ASSERT((int64_t)(pageID + 1) * IndirectShadowPage::PAGE_BYTES <= bytes);
+	return base + (int64_t)pageID * IndirectShadowPage::PAGE_BYTES;
+}
+
 IndirectShadowPage::IndirectShadowPage() : fastAllocated(true) {
 	data = (uint8_t*)FastAllocator<4096>::allocate();
 }
@@ -86,6 +138,9 @@ IndirectShadowPage::~IndirectShadowPage() {
 	else if(file) {
 		file->releaseZeroCopy(data, PAGE_BYTES, (int64_t) physicalPageID * PAGE_BYTES);
 	}
+	else if(tracker) {
+		tracker->releasePage(physicalPageID);
+	}
 }
 
 uint8_t const* IndirectShadowPage::begin() const {
@@ -103,6 +158,107 @@ int IndirectShadowPage::size() const {
 const int IndirectShadowPage::PAGE_BYTES = 4096;
 const int IndirectShadowPage::PAGE_OVERHEAD_BYTES = sizeof(SumType);
 
+PageCache::PageCache()
+	: hits(0), internalHits(0), misses(0), evictions(0), internalCapacity(0), leafCapacity(0), protectedCapacity(0), epoch(0)
+{
+}
+
+void PageCache::setSizes(int internalPages, int leafPages, double protectedFraction) {
+	internalCapacity = std::max(internalPages, 0);
+	leafCapacity = std::max(leafPages, 0);
+	protectedCapacity = std::max(0, std::min(leafCapacity, (int)(leafCapacity * protectedFraction)));
+	evict();
+}
+
+Reference<const IPage> PageCache::get(PhysicalPageID pageID) {
+	auto itr = entries.find(pageID);
+	if(itr == entries.end()) {
+		++misses;
+		return Reference<const IPage>();
+	}
+
+	++hits;
+	Entry &entry = itr->second;
+	Reference<const IPage> page = entry.page;
+	if(page->level > 0 && internalCapacity > 0) {
+		++internalHits;
+		moveTo(pageID, entry, INTERNAL);
+	}
+	else {
+		// A leaf page that is read again leaves the probationary segment
+		moveTo(pageID, entry, PROTECTED);
+	}
+	evict();
+	return page;
+}
+
+void PageCache::insert(PhysicalPageID pageID, Reference<const IPage> page, uint64_t readEpoch) {
+	if(readEpoch != epoch || !enabled() || entries.count(pageID)) {
+		return;
+	}
+
+	Segment segment = (page->level > 0 && internalCapacity > 0) ? INTERNAL : PROBATION;
+	segments[segment].push_front(pageID);
+	Entry &entry = entries[pageID];
+	entry.page = page;
+	entry.segment = segment;
+	entry.position = segments[segment].begin();
+	evict();
+}
+
+void PageCache::erase(PhysicalPageID pageID) {
+	++epoch;
+	auto itr = entries.find(pageID);
+	if(itr != entries.end()) {
+		segments[itr->second.segment].erase(itr->second.position);
+		entries.erase(itr);
+	}
+}
+
+void PageCache::clear() {
+	++epoch;
+	entries.clear();
+	for(auto &s : segments) {
+		s.clear();
+	}
+}
+
+void PageCache::moveTo(PhysicalPageID pageID, Entry &entry, Segment segment) {
+	std::list<PhysicalPageID> &to = segments[segment];
+	to.splice(to.begin(), segments[entry.segment], entry.position);
+	entry.segment = segment;
+}
+
+void PageCache::evict() {
+	// The least recently used protected pages go back to the probationary segment rather than out of the cache
+	while((int)segments[PROTECTED].size() > protectedCapacity) {
+		PhysicalPageID pageID = segments[PROTECTED].back();
+		moveTo(pageID, entries[pageID], PROBATION);
+	}
+
+	// Pages are usually cached before their user sets their level, so internal pages found at the end of the
+	// probationary segment are kept, and the most recently cached page is kept even if leaf pages are not cached
+	int keepPages = internalCapacity > 0 ? 1 : 0;
+	while((int)(segments[PROTECTED].size() + segments[PROBATION].size()) > leafCapacity && (int)segments[PROBATION].size() > keepPages) {
+		PhysicalPageID pageID = segments[PROBATION].back();
+		auto itr = entries.find(pageID);
+		if(itr->second.page->level > 0 && internalCapacity > 0) {
+			moveTo(pageID, itr->second, INTERNAL);
+		}
+		else {
+			segments[PROBATION].pop_back();
+			entries.erase(itr);
+			++evictions;
+		}
+	}
+
+	while((int)segments[INTERNAL].size() > internalCapacity) {
+		entries.erase(segments[INTERNAL].back());
+		segments[INTERNAL].pop_back();
+		++evictions;
+	}
+}
+
 IndirectShadowPagerSnapshot::IndirectShadowPagerSnapshot(IndirectShadowPager *pager, Version version)
 	: pager(pager), version(version), pagerError(pager->getError())
 {
@@ -258,6 +414,7 @@ ACTOR Future<Void> recover(IndirectShadowPager *pager) {
 
 		pager->pagerFile.finishedMarkingPages();
 		pager->pagerFile.startVacuuming();
+		pager->remapDataFile();
 
 		debug_printf("%s: Finished recovery at v%lld\n", pager->pageFileName.c_str(), pager->latestVersion);
 		TraceEvent("PagerFinishedRecovery").detail("LatestVersion", pager->latestVersion).detail("OldestVersion", pager->oldestVersion).detail("Filename", pager->pageFileName);
@@ -344,10 +501,12 @@ ACTOR Future<Void> forwardError(Future<Void> f, Promise<Void> target) {
 	return Void();
 }
 
-IndirectShadowPager::IndirectShadowPager(std::string basename) 
-	: basename(basename), latestVersion(0), committedVersion(0), committing(Void()), oldestVersion(0), pagerFile(this)
+IndirectShadowPager::IndirectShadowPager(std::string basename, bool mmapReads)
+	: basename(basename), mmapReads(mmapReads && !g_network->isSimulated()), mappedPages(new MappedPageTracker()),
+	  latestVersion(0), committedVersion(0), committing(Void()), oldestVersion(0), pagerFile(this)
 {
 	pageFileName = basename;
+	pageCache.setSizes(SERVER_KNOBS->PAGER_INTERNAL_PAGE_CACHE_PAGES, SERVER_KNOBS->PAGER_LEAF_PAGE_CACHE_PAGES, SERVER_KNOBS->PAGER_LEAF_PAGE_CACHE_PROTECTED_FRACTION);
 	recovery = forwardError(recover(this), errorPromise);
 	housekeeping = forwardError(housekeeper(this), errorPromise);
 }
@@ -489,6 +648,9 @@ void IndirectShadowPager::writePage(LogicalPageID pageID, Reference<IPage> conte
 	}
 
 	logPageTableUpdate(pageID, updateVersion, physicalPageID);
+	if(mmapReads) {
+		uncommittedPages.insert(physicalPageID);
+	}
 
 	checksumWrite(dataFile.getPtr(), contents->mutate(), IndirectShadowPage::PAGE_BYTES, pageID, physicalPageID);
 
@@ -533,6 +695,7 @@ ACTOR Future<Void> commitImpl(IndirectShadowPager *pager, Future<Void> previousC
 	wait(pager->pageTableLog->commit());
 	
 	pager->committedVersion = std::max(pager->committedVersion, commitVersion);
+	pager->remapDataFile();
 
 	return Void();
 }
@@ -579,6 +742,7 @@ ACTOR void shutdown(IndirectShadowPager *pager, bool dispose) {
 		(i++)->second.read.cancel();
 	}
 	ASSERT(pager->busyPages.empty());
+	pager->pageCache.clear();
 
 	wait(ready(pager->writeActors.signal()));
 	wait(ready(pager->operations.signal()));
@@ -614,6 +778,7 @@ ACTOR Future<Reference<const IPage>> rawRead(IndirectShadowPager *pager, Logical
 	state void *data;
 	state int len = IndirectShadowPage::PAGE_BYTES;
 	state bool readSuccess = false;
+	state uint64_t cacheEpoch = pager->pageCache.getEpoch();
 
 	try {
 		wait(pager->dataFile->readZeroCopy(&data, &len, (int64_t) physicalPageID * IndirectShadowPage::PAGE_BYTES));
@@ -624,6 +789,16 @@ ACTOR Future<Reference<const IPage>> rawRead(IndirectShadowPager *pager, Logical
 		}
 
 		pager->busyPages.erase(physicalPageID);
+		if(pager->pageCache.enabled()) {
+			// Cached pages are copied so that they do not pin pages of the file's own cache
+			IndirectShadowPage *copy = new IndirectShadowPage();
+			memcpy(copy->mutate(), data, len);
+			pager->dataFile->releaseZeroCopy(data, len, (int64_t) physicalPageID * IndirectShadowPage::PAGE_BYTES);
+
+			Reference<const IPage> page(copy);
+			pager->pageCache.insert(physicalPageID, page, cacheEpoch);
+			return page;
+		}
 		return Reference<const IPage>(new IndirectShadowPage((uint8_t *)data, pager->dataFile, physicalPageID));
 	}
 	catch(Error &e) {
@@ -635,6 +810,22 @@ ACTOR Future<Reference<const IPage>> rawRead(IndirectShadowPager *pager, Logical
 	}
 }
 
+// Returns a view of a committed page in the page file mapping, or an invalid reference if the page must be read through
+// the page file
+Reference<const IPage> mappedRead(IndirectShadowPager *pager, LogicalPageID logicalPageID, PhysicalPageID physicalPageID) {
+	if(!pager->mappedFile || (int64_t)(physicalPageID + 1) * IndirectShadowPage::PAGE_BYTES > pager->mappedFile->size()
+		|| pager->uncommittedPages.count(physicalPageID))
+	{
+		return Reference<const IPage>();
+	}
+
+	if(!checksumRead(pager->dataFile.getPtr(), pager->mappedFile->pageData(physicalPageID), IndirectShadowPage::PAGE_BYTES, logicalPageID, physicalPageID)) {
+		throw checksum_failed();
+	}
+
+	return Reference<const IPage>(new IndirectShadowPage(pager->mappedFile, pager->mappedPages, physicalPageID));
+}
+
 Future<Reference<const IPage>> getPageImpl(IndirectShadowPager *pager, Reference<IndirectShadowPagerSnapshot> snapshot, LogicalPageID logicalPageID, Version version) {
 	ASSERT(logicalPageID < pager->pageTable.size());
 	PageVersionMap &pageVersionMap = pager->pageTable[logicalPageID];
@@ -650,6 +841,24 @@ Future<Reference<const IPage>> getPageImpl(IndirectShadowPager *pager, Reference
 
 	debug_printf("%s: Reading logical %d v%lld physical %d mapSize %lu\n", pager->pageFileName.c_str(), logicalPageID, version, physicalPageID, pageVersionMap.size());
 
+	Reference<const IPage> cached = pager->pageCache.get(physicalPageID);
+	if(cached) {
+		return cached;
+	}
+
+	if(pager->mappedFile) {
+		try {
+			Reference<const IPage> page = mappedRead(pager, logicalPageID, physicalPageID);
+			if(page) {
+				pager->pageCache.insert(physicalPageID, page, pager->pageCache.getEpoch());
+				return page;
+			}
+		}
+		catch(Error &e) {
+			return Future<Reference<const IPage>>(e);
+		}
+	}
+
 	IndirectShadowPager::BusyPage &bp = pager->busyPages[physicalPageID];
 	if(!bp.read.isValid()) {
 		Future<Reference<const IPage>> get = rawRead(pager, logicalPageID, physicalPageID);
@@ -672,6 +881,10 @@ Future<Reference<const IPage>> IndirectShadowPager::getPage(Reference<IndirectSh
 	return f;
 }
 
+void IndirectShadowPager::setPageCacheSizes(int internalPages, int leafPages) {
+	pageCache.setSizes(internalPages, leafPages, SERVER_KNOBS->PAGER_LEAF_PAGE_CACHE_PROTECTED_FRACTION);
+}
+
 PageVersionMap::iterator IndirectShadowPager::pageVersionMapLowerBound(PageVersionMap &pageVersionMap, Version version) {
 	return std::lower_bound(pageVersionMap.begin(), pageVersionMap.end(), version, [](std::pair<Version, PhysicalPageID> p, Version v) {
 		return p.first < v;
@@ -691,6 +904,23 @@ void IndirectShadowPager::freeLogicalPageID(LogicalPageID pageID) {
 	}
 }
 
+void IndirectShadowPager::remapDataFile() {
+	if(!mmapReads) {
+		return;
+	}
+
+	uncommittedPages.clear();
+
+	int64_t bytes = (int64_t)pagerFile.getPagesAllocated() * IndirectShadowPage::PAGE_BYTES;
+	if(mappedFile && mappedFile->size() == bytes) {
+		return;
+	}
+
+	// Pages read through the old mapping keep it alive until they are released
+	mappedFile = MappedPageFile::open(pageFileName, bytes);
+	debug_printf("%s: Mapped %lld bytes of the page file\n", pageFileName.c_str(), mappedFile ? mappedFile->size() : 0);
+}
+
 void IndirectShadowPager::logVersion(StringRef versionKey, Version version) {
 	BinaryWriter v(Unversioned());
 	v << version;
@@ -758,6 +988,9 @@ ACTOR Future<Void> copyPage(IndirectShadowPager *pager, Reference<IPage> page, L
 
 		ASSERT(bytes == IndirectShadowPage::PAGE_BYTES);
 		checksumWrite(pager->dataFile.getPtr(), page->mutate(), bytes, logical, to);
+		if(pager->mmapReads) {
+			pager->uncommittedPages.insert(to);
+		}
 		wait(pager->dataFile->write(data, bytes, (int64_t)to * IndirectShadowPage::PAGE_BYTES));
 		if(zeroCopied) {
 			pager->dataFile->releaseZeroCopy(data, bytes, (int64_t)from * IndirectShadowPage::PAGE_BYTES);
@@ -839,6 +1072,8 @@ ACTOR Future<Void> vacuumer(IndirectShadowPager *pager, PagerFile *pagerFile) {
 			pagerFile->freePages.erase(freePageItr, pagerFile->freePages.end());
 			ASSERT(pagerFile->vacuumQueue.empty() || pagerFile->vacuumQueue.rbegin()->first < eraseStartPage);
 
+			// Stop reading through the mapping until the next commit maps the truncated file
+			pager->mappedFile.clear();
 			wait(pager->dataFile->truncate((int64_t)pagerFile->pagesAllocated * IndirectShadowPage::PAGE_BYTES));
 		}
 
@@ -852,6 +1087,8 @@ PhysicalPageID PagerFile::allocatePage(LogicalPageID logicalPageID, Version vers
 	ASSERT((int64_t)pagesAllocated * IndirectShadowPage::PAGE_BYTES <= fileSize);
 	ASSERT(fileSize % IndirectShadowPage::PAGE_BYTES == 0);
 
+	freeReleasedPages();
+
 	PhysicalPageID allocatedPage;
 	if(!freePages.empty()) {
 		allocatedPage = *freePages.begin();
@@ -875,11 +1112,26 @@ PhysicalPageID PagerFile::allocatePage(LogicalPageID logicalPageID, Version vers
 }
 
 void PagerFile::freePage(PhysicalPageID pageID) {
-	freePages.insert(pageID);
-
 	if(pageID >= minVacuumQueuePage) {
 		vacuumQueue.erase(pageID);
 	}
+
+	// The page's contents will change once it is reused.  This also drops the cache's mapped page, if any.
+	pager->pageCache.erase(pageID);
+
+	// A page that is still being read through the page file mapping must not be rewritten
+	if(pager->mappedPages->deferFree(pageID)) {
+		debug_printf("%s: Deferring free of physical %u with live mapped pages\n", pager->pageFileName.c_str(), pageID);
+		return;
+	}
+
+	freePages.insert(pageID);
+}
+
+void PagerFile::freeReleasedPages() {
+	for(PhysicalPageID pageID : pager->mappedPages->takeReleasedFrees()) {
+		freePages.insert(pageID);
+	}
 }
 
 void PagerFile::markPageAllocated(LogicalPageID logicalPageID, Version version, PhysicalPageID physicalPageID) {
@@ -932,7 +1184,10 @@ void PagerFile::shutdown() {
 }
 
 bool PagerFile::canVacuum() {
-	if(freePages.size() < SERVER_KNOBS->FREE_PAGE_VACUUM_THRESHOLD // Not enough free pages
+	freeReleasedPages();
+
+	if(pager->mappedPages->hasDeferredFrees() // Truncation assumes all pages past the vacuum queue are free
+		|| freePages.size() < SERVER_KNOBS->FREE_PAGE_VACUUM_THRESHOLD // Not enough free pages
 		|| minVacuumQueuePage >= pagesAllocated // We finished processing all pages in the vacuum queue
 		|| !vacuumQueueReady) // Populating vacuum queue
 	{
@@ -958,3 +1213,36 @@ TEST_CASE("/fdbserver/indirectshadowpager/simple") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbserver/indirectshadowpager/pageCache") {
+	state PageCache cache;
+	cache.setSizes(2, 4, 0.5);
+
+	// An internal page and a leaf page that is read twice
+	Reference<const IPage> root(new IndirectShadowPage());
+	cache.insert(0, root, cache.getEpoch());
+	root->level = 1;
+	cache.insert(1, Reference<const IPage>(new IndirectShadowPage()), cache.getEpoch());
+	ASSERT(cache.get(1).isValid());
+
+	// A scan over many leaf pages evicts neither of them
+	for(PhysicalPageID pageID = 100; pageID < 200; ++pageID) {
+		cache.insert(pageID, Reference<const IPage>(new IndirectShadowPage()), cache.getEpoch());
+	}
+	ASSERT(cache.get(0) == root);
+	ASSERT(cache.get(1).isValid());
+	ASSERT(!cache.get(100).isValid());
+	ASSERT(cache.get(199).isValid());
+
+	// Pages read before an erase are not cached
+	uint64_t epoch = cache.getEpoch();
+	cache.erase(1);
+	ASSERT(!cache.get(1).isValid());
+	cache.insert(1, Reference<const IPage>(new IndirectShadowPage()), epoch);
+	ASSERT(!cache.get(1).isValid());
+
+	cache.setSizes(0, 0, 0.5);
+	ASSERT(!cache.get(0).isValid());
+
+	return Void();
+}
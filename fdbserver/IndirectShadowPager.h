@@ -30,17 +30,87 @@
 
 #include "fdbrpc/IAsyncFile.h"
 
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
 typedef uint32_t PhysicalPageID;
 typedef std::vector<std::pair<Version, PhysicalPageID>> PageVersionMap;
 typedef std::vector<PageVersionMap> LogicalPageTable;
 
 class IndirectShadowPager;
 
+// A read-only mapping of the start of the page file.  Pages read through the mapping keep a reference to it, so it is
+// unmapped once the pager and all of those pages have released it.
+class MappedPageFile : public ReferenceCounted<MappedPageFile>, NonCopyable {
+public:
+	// Maps at most the first bytes of the file.  Returns an invalid reference if the file cannot be mapped.
+	static Reference<MappedPageFile> open(std::string const& filename, int64_t bytes);
+	~MappedPageFile();
+
+	int64_t size() const { return bytes; }
+	uint8_t *pageData(PhysicalPageID pageID) const;
+
+private:
+	MappedPageFile(uint8_t *base, int64_t bytes) : base(base), bytes(bytes) {}
+
+	uint8_t *base;
+	int64_t bytes;
+};
+
+// Counts the live pages read through a mapping for each physical page.  A physical page that is freed while it has
+// live mapped pages is not reused until they are released, since rewriting it would change them.  The pager's mapped
+// pages share this with it and may outlive it.
+class MappedPageTracker : public ReferenceCounted<MappedPageTracker>, NonCopyable {
+public:
+	void addPage(PhysicalPageID pageID) {
+		++livePages[pageID];
+	}
+
+	void releasePage(PhysicalPageID pageID) {
+		auto itr = livePages.find(pageID);
+		ASSERT(itr != livePages.end());
+		if(--itr->second == 0) {
+			livePages.erase(itr);
+			if(deferredFrees.erase(pageID)) {
+				releasedFrees.push_back(pageID);
+			}
+		}
+	}
+
+	// Returns true if the page has live mapped pages, in which case it will be returned by takeReleasedFrees() once
+	// they are released
+	bool deferFree(PhysicalPageID pageID) {
+		if(livePages.count(pageID)) {
+			deferredFrees.insert(pageID);
+			return true;
+		}
+		return false;
+	}
+
+	bool hasDeferredFrees() const {
+		return !deferredFrees.empty() || !releasedFrees.empty();
+	}
+
+	std::vector<PhysicalPageID> takeReleasedFrees() {
+		return std::move(releasedFrees);
+	}
+
+private:
+	std::unordered_map<PhysicalPageID, int> livePages;
+	std::unordered_set<PhysicalPageID> deferredFrees;
+	std::vector<PhysicalPageID> releasedFrees;
+};
+
 class IndirectShadowPage : public IPage, ReferenceCounted<IndirectShadowPage> {
 public:
 	IndirectShadowPage();
 	IndirectShadowPage(uint8_t *data, Reference<IAsyncFile> file, PhysicalPageID pageID)
 	 : file(file), physicalPageID(pageID), fastAllocated(false), data(data) {}
+	IndirectShadowPage(Reference<MappedPageFile> mappedFile, Reference<MappedPageTracker> tracker, PhysicalPageID pageID)
+	 : mappedFile(mappedFile), tracker(tracker), physicalPageID(pageID), fastAllocated(false), data(mappedFile->pageData(pageID)) {
+		tracker->addPage(pageID);
+	}
 	virtual ~IndirectShadowPage();
 
 	virtual void addref() const {
@@ -61,11 +131,62 @@ public:
 
 private:
 	Reference<IAsyncFile> file;
+	Reference<MappedPageFile> mappedFile;
+	Reference<MappedPageTracker> tracker;
 	PhysicalPageID physicalPageID;
 	bool fastAllocated;
 	uint8_t *data;
 };
 
+// Caches pages read from the page file by physical page ID.  Pages that the pager's user has marked as internal
+// (IPage::level > 0) are kept in their own LRU list, so reading many leaf pages cannot evict them.  Leaf pages use a
+// segmented LRU: a page enters a probationary segment and moves to a protected segment only when it is read again, so
+// a scan displaces other pages that were read once rather than the working set.
+class PageCache : NonCopyable {
+public:
+	PageCache();
+
+	// A size of 0 disables caching of that kind of page
+	void setSizes(int internalPages, int leafPages, double protectedFraction);
+
+	// Returns an invalid reference on a miss
+	Reference<const IPage> get(PhysicalPageID pageID);
+
+	// Pages are only inserted if no page has been erased since getEpoch() returned epoch, since a read that started
+	// before the erase may have returned the erased page's contents
+	void insert(PhysicalPageID pageID, Reference<const IPage> page, uint64_t epoch);
+	void erase(PhysicalPageID pageID);
+	void clear();
+
+	uint64_t getEpoch() const { return epoch; }
+	bool enabled() const { return internalCapacity > 0 || leafCapacity > 0; }
+
+	int64_t hits;
+	int64_t internalHits;
+	int64_t misses;
+	int64_t evictions;
+
+private:
+	enum Segment { INTERNAL, PROTECTED, PROBATION, SEGMENT_COUNT };
+
+	struct Entry {
+		Reference<const IPage> page;
+		Segment segment;
+		std::list<PhysicalPageID>::iterator position;
+	};
+
+	void moveTo(PhysicalPageID pageID, Entry &entry, Segment segment);
+	void evict();
+
+	std::unordered_map<PhysicalPageID, Entry> entries;
+	std::list<PhysicalPageID> segments[SEGMENT_COUNT];
+
+	int internalCapacity;
+	int leafCapacity;
+	int protectedCapacity;
+	uint64_t epoch;
+};
+
 class IndirectShadowPagerSnapshot : public IPagerSnapshot, ReferenceCounted<IndirectShadowPagerSnapshot> {
 public:
 	IndirectShadowPagerSnapshot(IndirectShadowPager *pager, Version version);
@@ -103,6 +224,9 @@ public:
 
 	void finishedMarkingPages();
 
+	// Frees the pages whose freeing was deferred while they had live mapped pages and which have since been released
+	void freeReleasedPages();
+
 	uint64_t size();
 	uint32_t getPagesAllocated();
 	uint32_t getFreePages();
@@ -131,7 +255,9 @@ public:
 
 class IndirectShadowPager : public IPager {
 public:
-	IndirectShadowPager(std::string basename);
+	// If mmapReads is set, committed pages are read through a read-only mapping of the page file instead of being
+	// copied into page buffers.  It is ignored in simulation and on platforms without mmap.
+	IndirectShadowPager(std::string basename, bool mmapReads = false);
 	virtual ~IndirectShadowPager() {
 	}
 
@@ -158,6 +284,9 @@ public:
 
 	Future<Reference<const IPage>> getPage(Reference<IndirectShadowPagerSnapshot> snapshot, LogicalPageID pageID, Version version);
 
+	// Overrides the page cache sizes given by SERVER_KNOBS
+	void setPageCacheSizes(int internalPages, int leafPages);
+
 //private:
 	std::string basename;
 	std::string pageFileName;
@@ -171,6 +300,14 @@ public:
 	Reference<IAsyncFile> dataFile;
 	Future<Void> recovery;
 
+	bool mmapReads;
+	Reference<MappedPageFile> mappedFile;
+	Reference<MappedPageTracker> mappedPages;
+	// Pages written since the last commit, which may not have reached the file and so are not read through the mapping
+	std::unordered_set<PhysicalPageID> uncommittedPages;
+
+	PageCache pageCache;
+
 	Future<Void> housekeeping;
 	Future<Void> vacuuming;
 	Version oldestVersion;
@@ -199,6 +336,9 @@ public:
 	void freeLogicalPageID(LogicalPageID pageID);
 	void freePhysicalPageID(PhysicalPageID pageID);
 
+	// Maps the allocated pages of the page file, after a commit has made them durable
+	void remapDataFile();
+
 	void logVersion(StringRef versionKey, Version version);
 	void logPagesAllocated();
 	void logPageTableUpdate(LogicalPageID logicalPageID, Version version, PhysicalPageID physicalPageID);
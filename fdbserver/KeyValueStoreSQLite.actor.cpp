@@ -61,8 +61,12 @@ struct SpringCleaningStats {
 	double springCleaningTime;
 	double vacuumTime;
 	double lazyDeleteTime;
+	int64_t yieldsToCommits; // Spring cleanings ended early because a commit was waiting
+	int64_t commitsDelayed; // Commits which waited for spring cleaning to finish, and for how long in total
+	double commitDelayTime;
 
-	SpringCleaningStats() : springCleaningCount(0), lazyDeletePages(0), vacuumedPages(0), springCleaningTime(0.0), vacuumTime(0.0), lazyDeleteTime(0.0) {}
+	SpringCleaningStats() : springCleaningCount(0), lazyDeletePages(0), vacuumedPages(0), springCleaningTime(0.0), vacuumTime(0.0), lazyDeleteTime(0.0),
+		yieldsToCommits(0), commitsDelayed(0), commitDelayTime(0.0) {}
 };
 
 struct PageChecksumCodec {
@@ -1463,6 +1467,9 @@ public:
 	Future<SpringCleaningWorkPerformed> doClean();
 	void startReadThreads();
 
+	// A moving average of the time the writer takes to commit and checkpoint
+	double getSmoothedCommitTime() const { return smoothedCommitTime; }
+
 private:
 	KeyValueStoreType type;
 	UID logID;
@@ -1472,8 +1479,10 @@ private:
 	Future<Void> cleaning, logging, starting, stopOnErr;
 
 	int64_t readsRequested, writesRequested;
+	volatile int64_t commitsRequested;
 	ThreadSafeCounter readsComplete;
 	volatile int64_t writesComplete;
+	volatile double smoothedCommitTime;
 	volatile SpringCleaningStats springCleaningStats;
 	volatile int64_t diskBytesUsed;
 	volatile int64_t freeListPages;
@@ -1569,12 +1578,15 @@ private:
 		volatile SpringCleaningStats& springCleaningStats;
 		volatile int64_t& diskBytesUsed;
 		volatile int64_t& freeListPages;
+		volatile int64_t& commitsRequested;
+		volatile double& smoothedCommitTime;
+		double lastCleaningStart, lastCleaningEnd;
 		UID dbgid;
 		vector<Reference<ReadCursor>>& readThreads;
 		bool checkAllChecksumsOnOpen;
 		bool checkIntegrityOnOpen;
 
-		explicit Writer( std::string const& filename, bool isBtreeV2, bool checkAllChecksumsOnOpen, bool checkIntegrityOnOpen, volatile int64_t& writesComplete, volatile SpringCleaningStats& springCleaningStats, volatile int64_t& diskBytesUsed, volatile int64_t& freeListPages, UID dbgid, vector<Reference<ReadCursor>>* pReadThreads )
+		explicit Writer( std::string const& filename, bool isBtreeV2, bool checkAllChecksumsOnOpen, bool checkIntegrityOnOpen, volatile int64_t& writesComplete, volatile SpringCleaningStats& springCleaningStats, volatile int64_t& diskBytesUsed, volatile int64_t& freeListPages, volatile int64_t& commitsRequested, volatile double& smoothedCommitTime, UID dbgid, vector<Reference<ReadCursor>>* pReadThreads )
 			: conn( filename, isBtreeV2, isBtreeV2 ),
 			  commits(), setsThisCommit(),
 			  freeTableEmpty(false),
@@ -1582,6 +1594,9 @@ private:
 			  springCleaningStats(springCleaningStats),
 			  diskBytesUsed(diskBytesUsed),
 			  freeListPages(freeListPages),
+			  commitsRequested(commitsRequested),
+			  smoothedCommitTime(smoothedCommitTime),
+			  lastCleaningStart(0), lastCleaningEnd(0),
 			  cursor(NULL),
 			  dbgid(dbgid),
 			  readThreads(*pReadThreads),
@@ -1671,6 +1686,11 @@ private:
 		};
 		void action(CommitAction& a) {
 			double t1 = now();
+			if (lastCleaningEnd > a.issuedTime) {
+				// Actions run in order, so spring cleaning which finished after this commit was issued was ahead of it
+				++springCleaningStats.commitsDelayed;
+				springCleaningStats.commitDelayTime += lastCleaningEnd - std::max(a.issuedTime, lastCleaningStart);
+			}
 			cursor->commit();
 			delete cursor;
 			cursor = NULL;
@@ -1682,6 +1702,7 @@ private:
 			double t3 = now();
 
 			++commits;
+			smoothedCommitTime = smoothedCommitTime * (1 - SERVER_KNOBS->SPRING_CLEANING_COMMIT_TIME_SMOOTHING) + (t3 - t1) * SERVER_KNOBS->SPRING_CLEANING_COMMIT_TIME_SMOOTHING;
 			//if ( !(commits % 100) )
 			//printf("dbf=%lld bytes, wal=%lld bytes\n", getFileSize((kv->filename+".fdb").c_str()), getFileSize((kv->filename+".fdb-wal").c_str()));
 
@@ -1751,17 +1772,39 @@ private:
 			const double lazyDeleteBatchProbability = 1.0 / (1 + SERVER_KNOBS->SPRING_CLEANING_VACUUMS_PER_LAZY_DELETE_PAGE * std::max(1, SERVER_KNOBS->SPRING_CLEANING_LAZY_DELETE_BATCH_SIZE));
 			bool vacuumFinished = false;
 
+			lastCleaningStart = s;
+
 			loop {
 				double begin = now();
+
+				// A commit waiting behind this action ends it early.  Within its time budget it first does a batch of lazy
+				// deletion and a page of vacuuming, so that cleaning still makes progress while commits arrive
+				// continuously, but once the budget is spent it stops right away.
+				bool commitWaiting = SERVER_KNOBS->SPRING_CLEANING_YIELD_TO_COMMITS && commitsRequested > commits;
+				bool inLazyDeleteTime = now() < lazyDeleteEnd;
+				bool inVacuumTime = now() < vacuumEnd;
+				int minLazyDeletePages = !commitWaiting ? SERVER_KNOBS->SPRING_CLEANING_MIN_LAZY_DELETE_PAGES
+				                         : inLazyDeleteTime ? std::max(SERVER_KNOBS->SPRING_CLEANING_MIN_LAZY_DELETE_PAGES, SERVER_KNOBS->SPRING_CLEANING_LAZY_DELETE_BATCH_SIZE)
+				                         : 0;
+				int minVacuumPages = !commitWaiting ? SERVER_KNOBS->SPRING_CLEANING_MIN_VACUUM_PAGES
+				                     : inVacuumTime ? std::max(SERVER_KNOBS->SPRING_CLEANING_MIN_VACUUM_PAGES, 1)
+				                     : 0;
+
 				bool canDelete = !freeTableEmpty 
-				                 && (now() < lazyDeleteEnd || workPerformed.lazyDeletePages < SERVER_KNOBS->SPRING_CLEANING_MIN_LAZY_DELETE_PAGES) 
+				                 && ((inLazyDeleteTime && !commitWaiting) || workPerformed.lazyDeletePages < minLazyDeletePages) 
 				                 && workPerformed.lazyDeletePages < SERVER_KNOBS->SPRING_CLEANING_MAX_LAZY_DELETE_PAGES;
 
 				bool canVacuum = !vacuumFinished 
-				                 && (now() < vacuumEnd || workPerformed.vacuumedPages < SERVER_KNOBS->SPRING_CLEANING_MIN_VACUUM_PAGES) 
+				                 && ((inVacuumTime && !commitWaiting) || workPerformed.vacuumedPages < minVacuumPages) 
 				                 && workPerformed.vacuumedPages < SERVER_KNOBS->SPRING_CLEANING_MAX_VACUUM_PAGES;
 
 				if(!canDelete && !canVacuum) {
+					if(commitWaiting && ((!freeTableEmpty && inLazyDeleteTime) || (!vacuumFinished && inVacuumTime))) {
+						TEST(true); // SQLite spring cleaning yielded to a commit
+						TEST(workPerformed.lazyDeletePages > 0); // SQLite spring cleaning lazily deleted pages before yielding to a commit
+						TEST(workPerformed.vacuumedPages > 0); // SQLite spring cleaning vacuumed before yielding to a commit
+						++springCleaningStats.yieldsToCommits;
+					}
 					break;
 				}
 
@@ -1805,6 +1848,7 @@ private:
 			springCleaningStats.springCleaningTime += now() - s;
 			springCleaningStats.vacuumTime += vacuumTime;
 			springCleaningStats.lazyDeleteTime += lazyDeleteTime;
+			lastCleaningEnd = now();
 
 			a.result.send(workPerformed);
 			++writesComplete;
@@ -1834,7 +1878,12 @@ private:
 				.detail("VacuumedPages", self->springCleaningStats.vacuumedPages)
 				.detail("SpringCleaningTime", self->springCleaningStats.springCleaningTime)
 				.detail("LazyDeleteTime", self->springCleaningStats.lazyDeleteTime)
-				.detail("VacuumTime", self->springCleaningStats.vacuumTime);
+				.detail("VacuumTime", self->springCleaningStats.vacuumTime)
+				.detail("YieldsToCommits", self->springCleaningStats.yieldsToCommits)
+				.detail("CommitsDelayed", self->springCleaningStats.commitsDelayed)
+				.detail("CommitDelayTime", self->springCleaningStats.commitDelayTime)
+				.detail("SmoothedCommitTime", self->smoothedCommitTime)
+				.detail("FreeListPages", self->freeListPages);
 
 			lastReadsComplete = self->readsComplete;
 			lastWritesComplete = self->writesComplete;
@@ -1900,6 +1949,12 @@ ACTOR Future<Void> cleanPeriodically( KeyValueStoreSQLite* self ) {
 			duration = SERVER_KNOBS->SPRING_CLEANING_NO_ACTION_INTERVAL;
 		}
 
+		// Clean less often while commits are slower than the target, but at least as often as when there is nothing to do
+		if (self->getSmoothedCommitTime() > SERVER_KNOBS->SPRING_CLEANING_TARGET_COMMIT_TIME && duration < SERVER_KNOBS->SPRING_CLEANING_NO_ACTION_INTERVAL) {
+			TEST(true); // SQLite spring cleaning slowed by commit time
+			duration = std::min(SERVER_KNOBS->SPRING_CLEANING_NO_ACTION_INTERVAL, duration * self->getSmoothedCommitTime() / SERVER_KNOBS->SPRING_CLEANING_TARGET_COMMIT_TIME);
+		}
+
 		wait(delayJittered(duration));
 	}
 }
@@ -1919,7 +1974,7 @@ KeyValueStoreSQLite::KeyValueStoreSQLite(std::string const& filename, UID id, Ke
 	  logID(id),
 	  readThreads(CoroThreadPool::createThreadPool()),
 	  writeThread(CoroThreadPool::createThreadPool()),
-	  readsRequested(0), writesRequested(0), writesComplete(0), diskBytesUsed(0), freeListPages(0)
+	  readsRequested(0), writesRequested(0), commitsRequested(0), writesComplete(0), smoothedCommitTime(0), diskBytesUsed(0), freeListPages(0)
 {
 	stopOnErr = stopOnError(this);
 
@@ -1939,7 +1994,7 @@ KeyValueStoreSQLite::KeyValueStoreSQLite(std::string const& filename, UID id, Ke
 	sqlite3_soft_heap_limit64( SERVER_KNOBS->SOFT_HEAP_LIMIT );  // SOMEDAY: Is this a performance issue?  Should we drop the cache sizes for individual threads?
 	TaskPriority taskId = g_network->getCurrentTask();
 	g_network->setCurrentTask(TaskPriority::DiskWrite);
-	writeThread->addThread( new Writer(filename, type==KeyValueStoreType::SSD_BTREE_V2, checkChecksums, checkIntegrity, writesComplete, springCleaningStats, diskBytesUsed, freeListPages, id, &readCursors) );
+	writeThread->addThread( new Writer(filename, type==KeyValueStoreType::SSD_BTREE_V2, checkChecksums, checkIntegrity, writesComplete, springCleaningStats, diskBytesUsed, freeListPages, commitsRequested, smoothedCommitTime, id, &readCursors) );
 	g_network->setCurrentTask(taskId);
 	auto p = new Writer::InitAction();
 	auto f = p->result.getFuture();
@@ -1980,6 +2035,7 @@ void KeyValueStoreSQLite::clear( KeyRangeRef range, const Arena* arena ) {
 }
 Future<Void> KeyValueStoreSQLite::commit(bool sequential) {
 	++writesRequested;
+	++commitsRequested;
 	auto p = new Writer::CommitAction;
 	auto f = p->result.getFuture();
 	writeThread->post(p);
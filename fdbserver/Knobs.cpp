@@ -90,6 +90,7 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( DD_QUEUE_MAX_KEY_SERVERS,                              100 ); if( randomize && BUGGIFY ) DD_QUEUE_MAX_KEY_SERVERS = 1;
 	init( DD_REBALANCE_PARALLELISM,                               50 );
 	init( DD_REBALANCE_RESET_AMOUNT,                              30 );
+	init( DD_READ_REBALANCE_SHARD_SAMPLES,                        10 );
 	init( BG_DD_MAX_WAIT,                                      120.0 );
 	init( BG_DD_MIN_WAIT,                                        0.1 );
 	init( BG_DD_INCREASE_RATE,                                  1.10 );
@@ -146,6 +147,24 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 		If this value is too small relative to SHARD_MIN_BYTES_PER_KSEC immediate merging work will be generated.
 		*/
 
+	bool buggifySmallReadBandwidthSplit = randomize && BUGGIFY;
+	init( SHARD_MAX_BYTES_READ_PER_KSEC,            8LL*1000000*1000 ); if( buggifySmallReadBandwidthSplit ) SHARD_MAX_BYTES_READ_PER_KSEC = 10LL*1000*1000;
+	/* 8*1MB/sec * 1000sec/ksec
+		Shards with more than this read bandwidth are read-hot and will be split immediately, so that the pieces can be spread over
+		more teams. Reads are served by a single replica, so this can be higher than SHARD_MAX_BYTES_PER_KSEC.
+		*/
+	init( SHARD_MIN_BYTES_READ_PER_KSEC,           200 * 1000 * 1000 ); if( buggifySmallReadBandwidthSplit ) SHARD_MIN_BYTES_READ_PER_KSEC = 200*1*1000;
+	/* 200*1KB/sec * 1000sec/ksec
+		Shards with more than this read bandwidth will not be merged. Needs to be significantly less than SHARD_SPLIT_BYTES_READ_PER_KSEC.
+		The read sample is sized from this value (see BYTES_READ_UNITS_PER_SAMPLE).
+		*/
+	init( SHARD_SPLIT_BYTES_READ_PER_KSEC,        2LL*1000000*1000 ); if( buggifySmallReadBandwidthSplit ) SHARD_SPLIT_BYTES_READ_PER_KSEC = 4 * 1000 * 1000;
+	/* 2*1MB/sec * 1000sec/ksec
+		When splitting a read-hot shard, it is split into pieces with less than this read bandwidth.
+		Should be less than half of SHARD_MAX_BYTES_READ_PER_KSEC.
+		*/
+	init( DD_READ_HOT_SHARDS_LOGGED,                               5 );
+
 	init( STORAGE_METRIC_TIMEOUT,                              600.0 ); if( randomize && BUGGIFY ) STORAGE_METRIC_TIMEOUT = deterministicRandom()->coinflip() ? 10.0 : 60.0;
 	init( METRIC_DELAY,                                          0.1 ); if( randomize && BUGGIFY ) METRIC_DELAY = 1.0;
 	init( ALL_DATA_REMOVED_DELAY,                                1.0 );
@@ -175,6 +194,7 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( DD_SHARD_METRICS_TIMEOUT,                             60.0 ); if( randomize && BUGGIFY ) DD_SHARD_METRICS_TIMEOUT = 0.1;
 	init( DD_LOCATION_CACHE_SIZE,                            2000000 ); if( randomize && BUGGIFY ) DD_LOCATION_CACHE_SIZE = 3;
 	init( MOVEKEYS_LOCK_POLLING_DELAY,                           5.0 );
+	init( DD_BULK_LOAD_POLLING_DELAY,                           10.0 ); if( randomize && BUGGIFY ) DD_BULK_LOAD_POLLING_DELAY = 1.0;
 	init( DEBOUNCE_RECRUITING_DELAY,                             5.0 );
 	init( DD_FAILURE_TIME,                                       1.0 ); if( randomize && BUGGIFY ) DD_FAILURE_TIME = 10.0;
 	init( DD_ZERO_HEALTHY_TEAM_DELAY,                            1.0 );
@@ -237,6 +257,9 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( SPRING_CLEANING_LAZY_DELETE_BATCH_SIZE,                100 ); if( randomize && BUGGIFY ) SPRING_CLEANING_LAZY_DELETE_BATCH_SIZE = deterministicRandom()->randomInt(1, 1000);
 	init( SPRING_CLEANING_MIN_VACUUM_PAGES,                        1 ); if( randomize && BUGGIFY ) SPRING_CLEANING_MIN_VACUUM_PAGES = deterministicRandom()->randomInt(0, 100);
 	init( SPRING_CLEANING_MAX_VACUUM_PAGES,                      1e9 ); if( randomize && BUGGIFY ) SPRING_CLEANING_MAX_VACUUM_PAGES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1, 1e4);
+	init( SPRING_CLEANING_YIELD_TO_COMMITS,                     true ); if( randomize && BUGGIFY ) SPRING_CLEANING_YIELD_TO_COMMITS = false;
+	init( SPRING_CLEANING_TARGET_COMMIT_TIME,                   0.05 ); if( randomize && BUGGIFY ) SPRING_CLEANING_TARGET_COMMIT_TIME = deterministicRandom()->random01() * 0.1;
+	init( SPRING_CLEANING_COMMIT_TIME_SMOOTHING,                 0.1 );
 
 	// KeyValueStoreMemory
 	init( REPLACE_CONTENTS_BYTES,                                1e5 ); if( randomize && BUGGIFY ) REPLACE_CONTENTS_BYTES = 1e3;
@@ -291,9 +314,11 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	//  by delay()ing for this amount of time between accepted batches of TransactionRequests.
 	bool fastBalancing = randomize && BUGGIFY;
 	init( COMMIT_SLEEP_TIME,								  0.0001 ); if( randomize && BUGGIFY ) COMMIT_SLEEP_TIME = 0;
-	init( KEY_BYTES_PER_SAMPLE,                                  2e4 ); if( fastBalancing ) KEY_BYTES_PER_SAMPLE = 1e3;
+	init( KEY_BYTES_PER_SAMPLE,                                  1e4 ); if( fastBalancing ) KEY_BYTES_PER_SAMPLE = 1e3;
 	init( MIN_BALANCE_TIME,                                      0.2 );
 	init( MIN_BALANCE_DIFFERENCE,                                1e6 ); if( fastBalancing ) MIN_BALANCE_DIFFERENCE = 1e4;
+	init( MAX_RESOLVER_BALANCE_PAIRS,                              8 ); if( randomize && BUGGIFY ) MAX_RESOLVER_BALANCE_PAIRS = 1;
+	init( RESOLVER_LOAD_LOGGING_INTERVAL,                        5.0 );
 	init( SECONDS_BEFORE_NO_FAILURE_DELAY,                  8 * 3600 );
 	init( MAX_TXS_SEND_MEMORY,                                   1e7 ); if( randomize && BUGGIFY ) MAX_TXS_SEND_MEMORY = 1e5;
 	init( MAX_RECOVERY_VERSIONS,           200 * VERSIONS_PER_SECOND );
@@ -411,6 +436,9 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( SPLIT_JITTER_AMOUNT,                                  0.05 ); if( randomize && BUGGIFY ) SPLIT_JITTER_AMOUNT = 0.2;
 	init( IOPS_UNITS_PER_SAMPLE,                                10000 * 1000 / STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS / 100 );
 	init( BANDWIDTH_UNITS_PER_SAMPLE,                           SHARD_MIN_BYTES_PER_KSEC / STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS / 25 );
+	init( BYTES_READ_UNITS_PER_SAMPLE,                          SHARD_MIN_BYTES_READ_PER_KSEC / STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS / 25 );
+	init( EMPTY_READ_PENALTY,                                     20 ); // A read that returns nothing still costs about this many bytes
+	init( READ_SAMPLING_ENABLED,                                true );
 
 	//Storage Server
 	init( STORAGE_LOGGING_DELAY,                                 5.0 );
@@ -419,12 +447,17 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( STORAGE_LIMIT_BYTES,                                500000 );
 	init( BUGGIFY_LIMIT_BYTES,                                  1000 );
 	init( FETCH_BLOCK_BYTES,                                     2e6 );
-	init( FETCH_KEYS_PARALLELISM_BYTES,                          4e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLELISM_BYTES = 3e6;
+	init( FETCH_KEYS_PARALLELISM_BYTES,                         16e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLELISM_BYTES = 3e6;
+	init( FETCH_KEYS_SUBRANGE_BYTES,                            20e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_SUBRANGE_BYTES = deterministicRandom()->coinflip() ? 0 : 500e3;
+	init( FETCH_KEYS_SPLIT_TIMEOUT,                              5.0 );
+	init( BACKUP_SHARD_FILE_BYTES,                              20e6 ); if( randomize && BUGGIFY ) BACKUP_SHARD_FILE_BYTES = 10e3;
+	init( BACKUP_SHARD_PARALLELISM,                                2 );
 	init( BUGGIFY_BLOCK_BYTES,                                 10000 );
 	init( STORAGE_COMMIT_BYTES,                             10000000 ); if( randomize && BUGGIFY ) STORAGE_COMMIT_BYTES = 2000000;
 	init( STORAGE_DURABILITY_LAG_REJECT_THRESHOLD,              0.25 );
 	init( STORAGE_DURABILITY_LAG_MIN_RATE,                       0.1 );
 	init( STORAGE_COMMIT_INTERVAL,                               0.5 ); if( randomize && BUGGIFY ) STORAGE_COMMIT_INTERVAL = 2.0;
+	init( STORAGE_DEFER_ATOMIC_OP_READS,                        true ); if( randomize && BUGGIFY ) STORAGE_DEFER_ATOMIC_OP_READS = false;
 	init( UPDATE_SHARD_VERSION_INTERVAL,                        0.25 ); if( randomize && BUGGIFY ) UPDATE_SHARD_VERSION_INTERVAL = 1.0;
 	init( BYTE_SAMPLING_FACTOR,                                  250 ); //cannot buggify because of differences in restarting tests
 	init( BYTE_SAMPLING_OVERHEAD,                                100 );
@@ -470,11 +503,23 @@ ServerKnobs::ServerKnobs(bool randomize, ClientKnobs* clientKnobs) {
 	init( FREE_PAGE_VACUUM_THRESHOLD,                              1 );
 	init( VACUUM_QUEUE_SIZE,                                  100000 );
 	init( VACUUM_BYTES_PER_SECOND,                               1e6 );
+	init( PAGER_MMAP_READS,                                    false );
+	init( PAGER_INTERNAL_PAGE_CACHE_PAGES,                      2500 ); if( randomize && BUGGIFY ) PAGER_INTERNAL_PAGE_CACHE_PAGES = deterministicRandom()->randomInt(0, 10);
+	init( PAGER_LEAF_PAGE_CACHE_PAGES,                         10000 ); if( randomize && BUGGIFY ) PAGER_LEAF_PAGE_CACHE_PAGES = deterministicRandom()->randomInt(0, 10);
+	init( PAGER_LEAF_PAGE_CACHE_PROTECTED_FRACTION,              0.8 ); if( randomize && BUGGIFY ) PAGER_LEAF_PAGE_CACHE_PROTECTED_FRACTION = deterministicRandom()->random01();
 
 	// Timekeeper
 	init( TIME_KEEPER_DELAY,                                      10 );
 	init( TIME_KEEPER_MAX_ENTRIES,                              3600 * 24 * 30 * 6); if( randomize && BUGGIFY ) { TIME_KEEPER_MAX_ENTRIES = 2; }
 
+	// Parallel restore
+	init( RESTORE_VERSION_BATCH_BYTES,                           2e9 ); if( randomize && BUGGIFY ) RESTORE_VERSION_BATCH_BYTES = deterministicRandom()->randomInt(1e3, 1e6);
+	init( RESTORE_PIPELINE_DEPTH,                                  2 ); if( randomize && BUGGIFY ) RESTORE_PIPELINE_DEPTH = deterministicRandom()->randomInt(1, 4);
+	init( RESTORE_LOADER_FILE_PARALLELISM,                         8 ); if( randomize && BUGGIFY ) RESTORE_LOADER_FILE_PARALLELISM = 1;
+	init( RESTORE_SAMPLE_BYTES,                                  1e6 ); if( randomize && BUGGIFY ) RESTORE_SAMPLE_BYTES = 1e3;
+	init( RESTORE_SEND_MUTATION_BYTES,                           1e6 ); if( randomize && BUGGIFY ) RESTORE_SEND_MUTATION_BYTES = 1e3;
+	init( RESTORE_APPLY_TXN_BYTES,                               1e6 ); if( randomize && BUGGIFY ) RESTORE_APPLY_TXN_BYTES = deterministicRandom()->randomInt(100, 1e5);
+
 	if(clientKnobs)
 		clientKnobs->IS_ACCEPTABLE_DELAY = clientKnobs->IS_ACCEPTABLE_DELAY*std::min(MAX_READ_TRANSACTION_LIFE_VERSIONS, MAX_WRITE_TRANSACTION_LIFE_VERSIONS)/(5.0*VERSIONS_PER_SECOND);
 }
@@ -93,6 +93,7 @@ public:
 	int DD_QUEUE_MAX_KEY_SERVERS;
 	int DD_REBALANCE_PARALLELISM;
 	int DD_REBALANCE_RESET_AMOUNT;
+	int DD_READ_REBALANCE_SHARD_SAMPLES;
 	double BG_DD_MAX_WAIT;
 	double BG_DD_MIN_WAIT;
 	double BG_DD_INCREASE_RATE;
@@ -110,6 +111,10 @@ public:
 	int64_t SHARD_MAX_BYTES_PER_KSEC, // Shards with more than this bandwidth will be split immediately
 		SHARD_MIN_BYTES_PER_KSEC,     // Shards with more than this bandwidth will not be merged
 		SHARD_SPLIT_BYTES_PER_KSEC;   // When splitting a shard, it is split into pieces with less than this bandwidth
+	int64_t SHARD_MAX_BYTES_READ_PER_KSEC, // Shards with more than this read bandwidth are read-hot and will be split immediately
+		SHARD_MIN_BYTES_READ_PER_KSEC,     // Shards with more than this read bandwidth will not be merged
+		SHARD_SPLIT_BYTES_READ_PER_KSEC;   // When splitting a read-hot shard, it is split into pieces with less than this read bandwidth
+	int DD_READ_HOT_SHARDS_LOGGED;
 	double STORAGE_METRIC_TIMEOUT;
 	double METRIC_DELAY;
 	double ALL_DATA_REMOVED_DELAY;
@@ -139,6 +144,7 @@ public:
 	double DD_SHARD_METRICS_TIMEOUT;
 	int64_t DD_LOCATION_CACHE_SIZE;
 	double MOVEKEYS_LOCK_POLLING_DELAY;
+	double DD_BULK_LOAD_POLLING_DELAY;
 	double DEBOUNCE_RECRUITING_DELAY;
 
 	// TeamRemover to remove redundant teams
@@ -185,6 +191,9 @@ public:
 	int SPRING_CLEANING_LAZY_DELETE_BATCH_SIZE;
 	int SPRING_CLEANING_MIN_VACUUM_PAGES;
 	int SPRING_CLEANING_MAX_VACUUM_PAGES;
+	bool SPRING_CLEANING_YIELD_TO_COMMITS;
+	double SPRING_CLEANING_TARGET_COMMIT_TIME;
+	double SPRING_CLEANING_COMMIT_TIME_SMOOTHING;
 
 	// KeyValueStoreMemory
 	int64_t REPLACE_CONTENTS_BYTES;
@@ -235,6 +244,8 @@ public:
 	double COMMIT_SLEEP_TIME;
 	double MIN_BALANCE_TIME;
 	int64_t MIN_BALANCE_DIFFERENCE;
+	int MAX_RESOLVER_BALANCE_PAIRS; // Number of (most loaded, least loaded) resolver pairs rebalanced in a single round
+	double RESOLVER_LOAD_LOGGING_INTERVAL;
 	double SECONDS_BEFORE_NO_FAILURE_DELAY;
 	int64_t MAX_TXS_SEND_MEMORY;
 	int64_t MAX_RECOVERY_VERSIONS;
@@ -347,6 +358,9 @@ public:
 	double SPLIT_JITTER_AMOUNT;
 	int64_t IOPS_UNITS_PER_SAMPLE;
 	int64_t BANDWIDTH_UNITS_PER_SAMPLE;
+	int64_t BYTES_READ_UNITS_PER_SAMPLE;
+	int64_t EMPTY_READ_PENALTY;
+	bool READ_SAMPLING_ENABLED;
 
 	//Storage Server
 	double STORAGE_LOGGING_DELAY;
@@ -356,6 +370,10 @@ public:
 	int BUGGIFY_LIMIT_BYTES;
 	int FETCH_BLOCK_BYTES;
 	int FETCH_KEYS_PARALLELISM_BYTES;
+	int64_t FETCH_KEYS_SUBRANGE_BYTES;
+	double FETCH_KEYS_SPLIT_TIMEOUT;
+	int64_t BACKUP_SHARD_FILE_BYTES;
+	int BACKUP_SHARD_PARALLELISM;
 	int BUGGIFY_BLOCK_BYTES;
 	int64_t STORAGE_HARD_LIMIT_BYTES;
 	int64_t STORAGE_DURABILITY_LAG_HARD_MAX;
@@ -364,6 +382,7 @@ public:
 	double STORAGE_DURABILITY_LAG_MIN_RATE;
 	int STORAGE_COMMIT_BYTES;
 	double STORAGE_COMMIT_INTERVAL;
+	bool STORAGE_DEFER_ATOMIC_OP_READS;
 	double UPDATE_SHARD_VERSION_INTERVAL;
 	int BYTE_SAMPLING_FACTOR;
 	int BYTE_SAMPLING_OVERHEAD;
@@ -409,11 +428,23 @@ public:
 	int FREE_PAGE_VACUUM_THRESHOLD;
 	int VACUUM_QUEUE_SIZE;
 	int VACUUM_BYTES_PER_SECOND;
+	bool PAGER_MMAP_READS;
+	int PAGER_INTERNAL_PAGE_CACHE_PAGES;
+	int PAGER_LEAF_PAGE_CACHE_PAGES;
+	double PAGER_LEAF_PAGE_CACHE_PROTECTED_FRACTION;
 
 	// Timekeeper
 	int64_t TIME_KEEPER_DELAY;
 	int64_t TIME_KEEPER_MAX_ENTRIES;
 
+	// Parallel restore
+	int64_t RESTORE_VERSION_BATCH_BYTES;
+	int RESTORE_PIPELINE_DEPTH;
+	int RESTORE_LOADER_FILE_PARALLELISM;
+	int64_t RESTORE_SAMPLE_BYTES;
+	int RESTORE_SEND_MUTATION_BYTES;
+	int RESTORE_APPLY_TXN_BYTES;
+
 
 	ServerKnobs(bool randomize = false, ClientKnobs* clientKnobs = NULL);
 };
@@ -739,6 +739,45 @@ struct LengthPrefixedStringRef {
 	LengthPrefixedStringRef(uint32_t* length) : length(length) {}
 };
 
+// Every message pushed to a TLog is framed as a 4-byte length of the rest of the message, the subsequence, the tag count,
+// the tags and then the message itself.  Tags are packed 3-byte structs whose layout matches their serialized form, so
+// they are written and read in bulk.
+#pragma pack(push, 1)
+struct TLogMessageHeader {
+	uint32_t length;
+	uint32_t subsequence;
+	uint16_t tagCount;
+};
+#pragma pack(pop)
+static_assert(sizeof(Tag) == sizeof(int8_t) + sizeof(uint16_t), "Tags must be packed to be read and written in bulk");
+
+// Appends a framed message to wr and returns the bytes appended, which can be copied as is to other TLogs' messages
+template <class T>
+StringRef writeTLogMessage(BinaryWriter& wr, uint32_t subsequence, std::vector<Tag> const& tags, T const& item) {
+	int offset = wr.getLength();
+	TLogMessageHeader h;
+	h.length = 0;
+	h.subsequence = subsequence;
+	h.tagCount = tags.size();
+	wr.serializeBytes(&h, sizeof(h));
+	wr.serializeBytes(tags.data(), tags.size() * sizeof(Tag));
+	wr << item;
+	uint8_t* begin = (uint8_t*)wr.getData() + offset;
+	int length = wr.getLength() - offset;
+	*(uint32_t*)begin = length - sizeof(uint32_t);
+	return StringRef(begin, length);
+}
+
+// Reads the header and tags of a framed message, leaving rd positioned at the message.  Returns the length of the
+// message that follows the tags.
+inline int32_t readTLogMessageHeader(ArenaReader& rd, uint32_t& subsequence, std::vector<Tag>& tags) {
+	TLogMessageHeader h = *(const TLogMessageHeader*)rd.readBytes(sizeof(TLogMessageHeader));
+	subsequence = h.subsequence;
+	tags.resize(h.tagCount);
+	memcpy(tags.data(), rd.readBytes(h.tagCount * sizeof(Tag)), h.tagCount * sizeof(Tag));
+	return h.length - sizeof(h.subsequence) - sizeof(h.tagCount) - h.tagCount * sizeof(Tag);
+}
+
 template<class T>
 struct CompareFirst {
 	bool operator() (T const& lhs, T const& rhs) const {
@@ -788,9 +827,12 @@ struct LogPushData : NonCopyable {
 		}
 		uint32_t subseq = this->subsequence++;
 		for(int loc : msg_locations) {
-			messagesWriter[loc] << uint32_t(rawMessageWithoutLength.size() + sizeof(subseq) + sizeof(uint16_t) + sizeof(Tag)*prev_tags.size()) << subseq << uint16_t(prev_tags.size());
-			for(auto& tag : prev_tags)
-				messagesWriter[loc] << tag;
+			TLogMessageHeader h;
+			h.length = rawMessageWithoutLength.size() + sizeof(h.subsequence) + sizeof(h.tagCount) + sizeof(Tag)*prev_tags.size();
+			h.subsequence = subseq;
+			h.tagCount = prev_tags.size();
+			messagesWriter[loc].serializeBytes(&h, sizeof(h));
+			messagesWriter[loc].serializeBytes(prev_tags.data(), prev_tags.size() * sizeof(Tag));
 			messagesWriter[loc].serializeBytes(rawMessageWithoutLength);
 		}
 	}
@@ -808,15 +850,11 @@ struct LogPushData : NonCopyable {
 		logSystem->getPushLocations(prev_tags, msg_locations, allLocations);
 
 		uint32_t subseq = this->subsequence++;
-		for(int loc : msg_locations) {
-			// FIXME: memcpy after the first time
-			BinaryWriter& wr = messagesWriter[loc];
-			int offset = wr.getLength();
-			wr << uint32_t(0) << subseq << uint16_t(prev_tags.size());
-			for(auto& tag : prev_tags)
-				wr << tag;
-			wr << item;
-			*(uint32_t*)((uint8_t*)wr.getData() + offset) = wr.getLength() - offset - sizeof(uint32_t);
+		if(!msg_locations.empty()) {
+			// Serialize the message once and copy the framed bytes to the other locations
+			StringRef message = writeTLogMessage(messagesWriter[msg_locations[0]], subseq, prev_tags, item);
+			for(int i = 1; i < msg_locations.size(); i++)
+				messagesWriter[msg_locations[i]].serializeBytes(message);
 		}
 		next_message_tags.clear();
 	}
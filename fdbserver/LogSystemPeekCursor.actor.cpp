@@ -89,15 +89,9 @@ void ILogSystem::ServerPeekCursor::nextMessage() {
 		ASSERT(!rd.empty());
 	}
 
-	uint16_t tagCount;
 	rd.checkpoint();
-	rd >> messageLength >> messageVersion.sub >> tagCount;
-	tags.resize(tagCount);
-	for(int i = 0; i < tagCount; i++) {
-		rd >> tags[i];
-	}
-	rawLength = messageLength + sizeof(messageLength);
-	messageLength -= (sizeof(messageVersion.sub) + sizeof(tagCount) + tagCount*sizeof(Tag));
+	messageLength = readTLogMessageHeader(rd, messageVersion.sub, tags);
+	rawLength = sizeof(TLogMessageHeader) + tags.size()*sizeof(Tag) + messageLength;
 	hasMsg = true;
 	//TraceEvent("SPC_NextMessageB", randomID).detail("MessageVersion", messageVersion.toString());
 }
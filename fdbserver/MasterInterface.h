@@ -26,6 +26,7 @@
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbclient/CommitTransaction.h"
 #include "fdbclient/DatabaseConfiguration.h"
+#include "fdbclient/MasterProxyInterface.h"
 #include "fdbserver/TLogInterface.h"
 
 typedef uint64_t DBRecoveryCount;
@@ -37,6 +38,8 @@ struct MasterInterface {
 	RequestStream< struct TLogRejoinRequest > tlogRejoin; // sent by tlog (whether or not rebooted) to communicate with a new master
 	RequestStream< struct ChangeCoordinatorsRequest > changeCoordinators;
 	RequestStream< struct GetCommitVersionRequest > getCommitVersion;
+	RequestStream< struct GetRawCommittedVersionRequest > getLiveCommittedVersion; // the latest version any proxy has reported committed
+	RequestStream< struct ReportRawCommittedVersionRequest > reportLiveCommittedVersion; // sent by proxies before replying to commits
 
 	NetworkAddress address() const { return changeCoordinators.getEndpoint().getPrimaryAddress(); }
 
@@ -46,11 +49,13 @@ struct MasterInterface {
 		if constexpr (!is_fb_function<Archive>) {
                 ASSERT( ar.protocolVersion().isValid() );
         }
-		serializer(ar, locality, waitFailure, tlogRejoin, changeCoordinators, getCommitVersion);
+		serializer(ar, locality, waitFailure, tlogRejoin, changeCoordinators, getCommitVersion, getLiveCommittedVersion, reportLiveCommittedVersion);
 	}
 
 	void initEndpoints() {
 		getCommitVersion.getEndpoint( TaskPriority::ProxyGetConsistentReadVersion );
+		getLiveCommittedVersion.getEndpoint( TaskPriority::ProxyGetRawCommittedVersion );
+		reportLiveCommittedVersion.getEndpoint( TaskPriority::ProxyGetRawCommittedVersion );
 	}
 };
 
@@ -141,6 +146,23 @@ struct GetCommitVersionRequest {
 	}
 };
 
+struct ReportRawCommittedVersionRequest {
+	constexpr static FileIdentifier file_identifier = 10456019;
+	Version version;
+	bool locked;
+	Optional<Value> metadataVersion;
+	ReplyPromise<Void> reply;
+
+	ReportRawCommittedVersionRequest() : version(invalidVersion), locked(false) {}
+	ReportRawCommittedVersionRequest(Version version, bool locked, Optional<Value> metadataVersion)
+		: version(version), locked(locked), metadataVersion(metadataVersion) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, version, locked, metadataVersion, reply);
+	}
+};
+
 struct LifetimeToken {
 	UID ccID;
 	int64_t count;
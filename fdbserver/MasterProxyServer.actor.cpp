@@ -60,25 +60,45 @@ struct ProxyStats {
 	Counter mutations;
 	Counter conflictRanges;
 	Counter keyServerLocationRequests;
+	Counter epochLiveConfirmations;
 	Version lastCommitVersionAssigned;
 
 	LatencyBands commitLatencyBands;
 	LatencyBands grvLatencyBands;
 
+	// The time a transaction spends in each stage of a commit.  Together they cover the time from the proxy receiving
+	// the transaction to it sending the reply.
+	LatencyHistogram commitBatchingLatency, commitGetVersionLatency, commitResolutionLatency, commitLoggingLatency, commitReplyLatency;
+
+	// The time from the proxy receiving a read version request to it sending the reply, and the part of that spent getting
+	// the live committed version
+	LatencyHistogram grvTotalLatency, grvGetLiveCommittedVersionLatency;
+
 	Future<Void> logger;
+	Future<Void> commitStageLogger;
+	Future<Void> grvStageLogger;
 
 	explicit ProxyStats(UID id, Version* pVersion, NotifiedVersion* pCommittedVersion, int64_t *commitBatchesMemBytesCountPtr)
 	  : cc("ProxyStats", id.toString()),
 		txnStartIn("TxnStartIn", cc), txnStartOut("TxnStartOut", cc), txnStartBatch("TxnStartBatch", cc), txnSystemPriorityStartIn("TxnSystemPriorityStartIn", cc), txnSystemPriorityStartOut("TxnSystemPriorityStartOut", cc), txnBatchPriorityStartIn("TxnBatchPriorityStartIn", cc), txnBatchPriorityStartOut("TxnBatchPriorityStartOut", cc),
 		txnDefaultPriorityStartIn("TxnDefaultPriorityStartIn", cc), txnDefaultPriorityStartOut("TxnDefaultPriorityStartOut", cc), txnCommitIn("TxnCommitIn", cc),	txnCommitVersionAssigned("TxnCommitVersionAssigned", cc), txnCommitResolving("TxnCommitResolving", cc), txnCommitResolved("TxnCommitResolved", cc), txnCommitOut("TxnCommitOut", cc),
-		txnCommitOutSuccess("TxnCommitOutSuccess", cc), txnConflicts("TxnConflicts", cc), commitBatchIn("CommitBatchIn", cc), commitBatchOut("CommitBatchOut", cc), mutationBytes("MutationBytes", cc), mutations("Mutations", cc), conflictRanges("ConflictRanges", cc), keyServerLocationRequests("KeyServerLocationRequests", cc), 
-		lastCommitVersionAssigned(0), commitLatencyBands("CommitLatencyMetrics", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY), grvLatencyBands("GRVLatencyMetrics", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY)
+		txnCommitOutSuccess("TxnCommitOutSuccess", cc), txnConflicts("TxnConflicts", cc), commitBatchIn("CommitBatchIn", cc), commitBatchOut("CommitBatchOut", cc), mutationBytes("MutationBytes", cc), mutations("Mutations", cc), conflictRanges("ConflictRanges", cc), keyServerLocationRequests("KeyServerLocationRequests", cc), epochLiveConfirmations("EpochLiveConfirmations", cc),
+		lastCommitVersionAssigned(0), commitLatencyBands("CommitLatencyMetrics", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY), grvLatencyBands("GRVLatencyMetrics", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
+		commitBatchingLatency("Batching", "CommitStageLatency", id), commitGetVersionLatency("GetCommitVersion", "CommitStageLatency", id),
+		commitResolutionLatency("Resolution", "CommitStageLatency", id), commitLoggingLatency("Logging", "CommitStageLatency", id),
+		commitReplyLatency("Reply", "CommitStageLatency", id), grvTotalLatency("Total", "GRVStageLatency", id),
+		grvGetLiveCommittedVersionLatency("GetLiveCommittedVersion", "GRVStageLatency", id)
 	{
 		specialCounter(cc, "LastAssignedCommitVersion", [this](){return this->lastCommitVersionAssigned;});
 		specialCounter(cc, "Version", [pVersion](){return *pVersion; });
 		specialCounter(cc, "CommittedVersion", [pCommittedVersion](){ return pCommittedVersion->get(); });
 		specialCounter(cc, "CommitBatchesMemBytesCount", [commitBatchesMemBytesCountPtr]() { return *commitBatchesMemBytesCountPtr; });
 		logger = traceCounters("ProxyMetrics", id, SERVER_KNOBS->WORKER_LOGGING_INTERVAL, &cc, "ProxyMetrics");
+		commitStageLogger = traceLatencyHistograms("CommitStageLatencyMetrics", id, SERVER_KNOBS->WORKER_LOGGING_INTERVAL,
+			{ &commitBatchingLatency, &commitGetVersionLatency, &commitResolutionLatency, &commitLoggingLatency, &commitReplyLatency },
+			id.toString() + "/CommitStageLatencyMetrics");
+		grvStageLogger = traceLatencyHistograms("GRVStageLatencyMetrics", id, SERVER_KNOBS->WORKER_LOGGING_INTERVAL,
+			{ &grvTotalLatency, &grvGetLiveCommittedVersionLatency }, id.toString() + "/GRVStageLatencyMetrics");
 	}
 };
 
@@ -237,6 +257,11 @@ struct ProxyCommitData {
 
 	Optional<LatencyBandConfig> latencyBandConfig;
 
+	// The most recent confirmation that the epoch is live, which read version batches share.  Once it has been sent to
+	// the logs, later batches queue another behind it instead.
+	Future<Void> epochLiveConfirmation;
+	bool epochLiveConfirmationSent;
+
 	//The tag related to a storage server rarely change, so we keep a vector of tags for each key range to be slightly more CPU efficient.
 	//When a tag related to a storage server does change, we empty out all of these vectors to signify they must be repopulated.
 	//We do not repopulate them immediately to avoid a slow task.
@@ -264,7 +289,8 @@ struct ProxyCommitData {
 			getConsistentReadVersion(getConsistentReadVersion), commit(commit), lastCoalesceTime(0),
 			localCommitBatchesStarted(0), locked(false), commitBatchInterval(SERVER_KNOBS->COMMIT_TRANSACTION_BATCH_INTERVAL_MIN),
 			firstProxy(firstProxy), cx(openDBOnServer(db, TaskPriority::DefaultEndpoint, true, true)), db(db),
-			singleKeyMutationEvent(LiteralStringRef("SingleKeyMutation")), commitBatchesMemBytesCount(0), lastTxsPop(0)
+			singleKeyMutationEvent(LiteralStringRef("SingleKeyMutation")), commitBatchesMemBytesCount(0), lastTxsPop(0),
+			epochLiveConfirmationSent(false)
 	{}
 };
 
@@ -463,7 +489,9 @@ ACTOR Future<Void> commitBatch(
 
 	++self->stats.commitBatchIn;
 
+	state double stageStart = timer();
 	for (int t = 0; t<trs.size(); t++) {
+		self->stats.commitBatchingLatency.addMeasurement(stageStart - trs[t].requestTime);
 		if (trs[t].debugID.present()) {
 			if (!debugID.present())
 				debugID = nondeterministicRandom()->randomUniqueID();
@@ -496,6 +524,10 @@ ACTOR Future<Void> commitBatch(
 	GetCommitVersionReply versionReply = wait(fVersionReply);
 	self->mostRecentProcessedRequestNumber = versionReply.requestNum;
 
+	double versionTime = timer();
+	self->stats.commitGetVersionLatency.addMeasurement(versionTime - stageStart, trs.size());
+	stageStart = versionTime;
+
 	self->stats.txnCommitVersionAssigned += trs.size();
 	self->stats.lastCommitVersionAssigned = versionReply.version;
 
@@ -545,6 +577,10 @@ ACTOR Future<Void> commitBatch(
 	/////// Phase 2: Resolution (waiting on the network; pipelined)
 	state vector<ResolveTransactionBatchReply> resolution = wait( getAll(replies) );
 
+	double resolutionTime = timer();
+	self->stats.commitResolutionLatency.addMeasurement(resolutionTime - stageStart, trs.size());
+	stageStart = resolutionTime;
+
 	if (debugID.present())
 		g_traceBatch.addEvent("CommitDebug", debugID.get().first(), "MasterProxyServer.commitBatch.AfterResolution");
 
@@ -1023,6 +1059,11 @@ ACTOR Future<Void> commitBatch(
 		}
 		throw;
 	}
+
+	double loggingTime = timer();
+	self->stats.commitLoggingLatency.addMeasurement(loggingTime - stageStart, trs.size());
+	stageStart = loggingTime;
+
 	wait(yield());
 
 	if( self->popRemoteTxs && msg.popTo > ( self->txsPopVersions.size() ? self->txsPopVersions.back().second : self->lastTxsPop ) ) {
@@ -1049,6 +1090,12 @@ ACTOR Future<Void> commitBatch(
 		ASSERT(p.second.isReady());
 	}
 
+	// The master must know about this version before any client does, so that read versions given out by other proxies
+	// are at least as large.  If a later version has already been set here, it has already been reported.
+	if( commitVersion > self->committedVersion.get() ) {
+		wait(brokenPromiseToNever(self->master.reportLiveCommittedVersion.getReply(ReportRawCommittedVersionRequest(commitVersion, lockedAfter, metadataVersionAfter), TaskPriority::ProxyGetRawCommittedVersion)));
+	}
+
 	TEST(self->committedVersion.get() > commitVersion);   // A later version was reported committed first
 	if( commitVersion > self->committedVersion.get() ) {
 		self->locked = lockedAfter;
@@ -1089,6 +1136,7 @@ ACTOR Future<Void> commitBatch(
 			self->stats.commitLatencyBands.addMeasurement(endTime - trs[t].requestTime, filter);
 		}
 	}
+	self->stats.commitReplyLatency.addMeasurement(timer() - stageStart, trs.size());
 
 	++self->stats.commitBatchOut;
 	self->stats.txnCommitOut += trs.size();
@@ -1125,36 +1173,56 @@ ACTOR Future<Void> commitBatch(
 }
 
 
-ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(ProxyCommitData* commitData, uint32_t flags, vector<MasterProxyInterface> *otherProxies, Optional<UID> debugID, int transactionCount, int systemTransactionCount, int defaultPriTransactionCount, int batchPriTransactionCount)
+ACTOR Future<Void> confirmEpochLiveAfter(ProxyCommitData* commitData, Future<Void> previous, Optional<UID> debugID) {
+	wait(previous);
+	commitData->epochLiveConfirmationSent = true;
+	++commitData->stats.epochLiveConfirmations;
+	wait(commitData->logSystem->confirmEpochLive(debugID));
+	return Void();
+}
+
+// Returns a future which is ready once the logs have confirmed that the epoch is live in response to a request sent after
+// this call.  Concurrent read version batches share confirmations, so that at most one is outstanding and one queued.
+Future<Void> confirmEpochLive(ProxyCommitData* commitData, Optional<UID> debugID) {
+	if(!commitData->epochLiveConfirmation.isValid() || commitData->epochLiveConfirmation.isReady()) {
+		++commitData->stats.epochLiveConfirmations;
+		commitData->epochLiveConfirmation = commitData->logSystem->confirmEpochLive(debugID);
+		commitData->epochLiveConfirmationSent = true;
+	} else if(commitData->epochLiveConfirmationSent) {
+		commitData->epochLiveConfirmation = confirmEpochLiveAfter(commitData, commitData->epochLiveConfirmation, debugID);
+		commitData->epochLiveConfirmationSent = false;
+	} else {
+		TEST(true); // Read version batch shares a queued epoch live confirmation
+	}
+	return commitData->epochLiveConfirmation;
+}
+
+ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(ProxyCommitData* commitData, uint32_t flags, Optional<UID> debugID, int transactionCount, int systemTransactionCount, int defaultPriTransactionCount, int batchPriTransactionCount)
 {
 	// Returns a version which (1) is committed, and (2) is >= the latest version reported committed (by a commit response) when this request was sent
-	// (1) The version returned is the committedVersion of some proxy at some point before the request returns, so it is committed.
-	// (2) No proxy on our list reported committed a higher version before this request was received, because then its committedVersion would have been higher,
-	//     and no other proxy could have already committed anything without first ending the epoch
+	// (1) The version returned is the largest version reported committed to the master by some proxy before the request returns, so it is committed.
+	// (2) Every proxy reports a version to the master before replying to the commit, and no other proxy could have already committed anything
+	//     without first ending the epoch
 	++commitData->stats.txnStartBatch;
-
-	state vector<Future<GetReadVersionReply>> proxyVersions;
-	for (auto const& p : *otherProxies)
-		proxyVersions.push_back(brokenPromiseToNever(p.getRawCommittedVersion.getReply(GetRawCommittedVersionRequest(debugID), TaskPriority::TLogConfirmRunningReply)));
+	state double startTime = timer();
+	state Future<GetReadVersionReply> replyFromMaster = brokenPromiseToNever(commitData->master.getLiveCommittedVersion.getReply(GetRawCommittedVersionRequest(debugID), TaskPriority::TLogConfirmRunningReply));
 
 	if (!(flags&GetReadVersionRequest::FLAG_CAUSAL_READ_RISKY))
 	{
-		wait(commitData->logSystem->confirmEpochLive(debugID));
+		wait(confirmEpochLive(commitData, debugID));
 	}
 
 	if (debugID.present())
 		g_traceBatch.addEvent("TransactionDebug", debugID.get().first(), "MasterProxyServer.getLiveCommittedVersion.confirmEpochLive");
 
-	vector<GetReadVersionReply> versions = wait(getAll(proxyVersions));
+	GetReadVersionReply repFromMaster = wait(replyFromMaster);
 	GetReadVersionReply rep;
 	rep.version = commitData->committedVersion.get();
 	rep.locked = commitData->locked;
 	rep.metadataVersion = commitData->metadataVersion;
 
-	for (auto v : versions) {
-		if(v.version > rep.version) {
-			rep = v;
-		}
+	if(repFromMaster.version > rep.version) {
+		rep = repFromMaster;
 	}
 
 	if (debugID.present())
@@ -1164,6 +1232,7 @@ ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(ProxyCommitData* commi
 	commitData->stats.txnSystemPriorityStartOut += systemTransactionCount;
 	commitData->stats.txnDefaultPriorityStartOut += defaultPriTransactionCount;
 	commitData->stats.txnBatchPriorityStartOut += batchPriTransactionCount;
+	commitData->stats.grvGetLiveCommittedVersionLatency.addMeasurement(timer() - startTime, transactionCount);
 
 	return rep;
 }
@@ -1200,6 +1269,7 @@ ACTOR Future<Void> sendGrvReplies(Future<GetReadVersionReply> replyFuture, std::
 	double end = timer();
 	for(GetReadVersionRequest const& request : requests) {
 		stats->grvLatencyBands.addMeasurement(end - request.requestTime);
+		stats->grvTotalLatency.addMeasurement(end - request.requestTime, request.transactionCount);
 		request.reply.send(reply);
 	}
 
@@ -1223,19 +1293,14 @@ ACTOR static Future<Void> transactionStarter(
 	state TransactionRateInfo batchRateInfo(0);
 
 	state std::priority_queue<std::pair<GetReadVersionRequest, int64_t>, std::vector<std::pair<GetReadVersionRequest, int64_t>>> transactionQueue;
-	state vector<MasterProxyInterface> otherProxies;
 
 	state PromiseStream<double> replyTimes;
 	addActor.send(getRate(proxy.id(), db, &transactionCount, &batchTransactionCount, &normalRateInfo.rate, &batchRateInfo.rate, healthMetricsReply, detailedHealthMetricsReply));
 	addActor.send(queueTransactionStartRequests(&transactionQueue, proxy.getConsistentReadVersion.getFuture(), GRVTimer, &lastGRVTime, &GRVBatchTime, replyTimes.getFuture(), &commitData->stats));
 
-	// Get a list of the other proxies that go together with us
+	// Wait until we are one of the proxies clients know about
 	while (std::find(db->get().client.proxies.begin(), db->get().client.proxies.end(), proxy) == db->get().client.proxies.end())
 		wait(db->onChange());
-	for (MasterProxyInterface mp : db->get().client.proxies) {
-		if (mp != proxy)
-			otherProxies.push_back(mp);
-	}
 
 	ASSERT(db->get().recoveryState >= RecoveryState::ACCEPTING_COMMITS);  // else potentially we could return uncommitted read versions (since self->committedVersion is only a committed version if this recovery succeeds)
 
@@ -1317,7 +1382,7 @@ ACTOR static Future<Void> transactionStarter(
 
 		for (int i = 0; i < start.size(); i++) {
 			if (start[i].size()) {
-				Future<GetReadVersionReply> readVersionReply = getLiveCommittedVersion(commitData, i, &otherProxies, debugID, transactionsStarted[i], systemTransactionsStarted[i], defaultPriTransactionsStarted[i], batchPriTransactionsStarted[i]);
+				Future<GetReadVersionReply> readVersionReply = getLiveCommittedVersion(commitData, i, debugID, transactionsStarted[i], systemTransactionsStarted[i], defaultPriTransactionsStarted[i], batchPriTransactionsStarted[i]);
 				addActor.send(sendGrvReplies(readVersionReply, start[i], &commitData->stats));
 
 				// for now, base dynamic batching on the time for normal requests (not read_risky)
@@ -123,6 +123,14 @@ Future<Void> removeOldDestinations(Transaction *tr, UID oldDest, VectorRef<KeyRa
 	return waitForAll(actors);
 }
 
+// Returns true if any part of keys may be registered for bulk load, given the (possibly truncated) krm map bulkLoads
+bool mayHaveBulkLoad( Standalone<RangeResultRef> const& bulkLoads, KeyRangeRef keys ) {
+	for(int i = 0; i < bulkLoads.size() - 1; i++)
+		if( bulkLoads[i].value.size() && KeyRangeRef( bulkLoads[i].key, bulkLoads[i+1].key ).intersects( keys ) )
+			return true;
+	return bulkLoads.end()[-1].key < keys.end;
+}
+
 ACTOR Future<vector<UID>> addReadWriteDestinations(KeyRangeRef shard, vector<StorageServerInterface> srcInterfs, vector<StorageServerInterface> destInterfs, Version version, int desiredHealthy, int maxServers) {
 	if(srcInterfs.size() >= maxServers) {
 		return vector<UID>();
@@ -290,6 +298,33 @@ ACTOR Future<Void> startMoveKeys( Database occ, KeyRange keys, vector<UID> serve
 					//for(int i=0; i<old.size(); i++)
 					//	printf("'%s': '%s'\n", old[i].key.toString().c_str(), old[i].value.toString().c_str());
 
+					state Standalone<RangeResultRef> bulkLoads = wait( krmGetRanges( &tr, bulkLoadPrefix, currentKeys, SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT, SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES) );
+
+					// The destinations of a range registered for bulk load ingest its files instead of fetching it, which
+					// would lose anything written to the range since it was registered.  Such a range is moved as usual.
+					state std::vector<int> bulkLoadIndices;
+					state std::vector<Future<Standalone<RangeResultRef>>> bulkLoadContents;
+					for(int i = 0; i < bulkLoads.size() - 1; i++) {
+						if( bulkLoads[i].value.size() ) {
+							bulkLoadIndices.push_back(i);
+							bulkLoadContents.push_back( tr.getRange( KeyRangeRef( bulkLoads[i].key, bulkLoads[i+1].key ), 1 ) );
+						}
+					}
+					wait( waitForAll( bulkLoadContents ) );
+
+					state int b;
+					for(b = 0; b < bulkLoadIndices.size(); b++) {
+						if( bulkLoadContents[b].get().size() ) {
+							state KeyRange writtenKeys = KeyRangeRef( bulkLoads[bulkLoadIndices[b]].key, bulkLoads[bulkLoadIndices[b]+1].key );
+							TEST(true); //start move keys refuses to bulk load a range which has been written to
+							TraceEvent(SevWarnAlways, "StartMoveKeysBulkLoadNotEmpty", relocationIntervalId)
+								.detail("KeyBegin", writtenKeys.begin)
+								.detail("KeyEnd", writtenKeys.end);
+							bulkLoads[bulkLoadIndices[b]].value = ValueRef();
+							wait( krmSetRange( &tr, bulkLoadPrefix, writtenKeys, Value() ) );
+						}
+					}
+
 					//Check that enough servers for each shard are in the correct state
 					vector<vector<UID>> addAsSource = wait(additionalSources(old, &tr, servers.size(), SERVER_KNOBS->MAX_ADDED_SOURCES_MULTIPLIER*servers.size()));
 
@@ -300,6 +335,21 @@ ACTOR Future<Void> startMoveKeys( Database occ, KeyRange keys, vector<UID> serve
 						vector<UID> dest;
 						decodeKeyServersValue( old[i].value, src, dest );
 
+						// The sources of a range registered for bulk load never held its data, and a destination only ingests
+						// the data if it does not already own the range
+						if( mayHaveBulkLoad( bulkLoads, rangeIntersectKeys ) ) {
+							for(auto& uid : src) {
+								if( std::find(servers.begin(), servers.end(), uid) != servers.end() ) {
+									TEST(true); //start move keys of a bulk loaded range onto one of its sources
+									TraceEvent(SevWarn, "StartMoveKeysBulkLoadSource", relocationIntervalId)
+										.detail("KeyBegin", rangeIntersectKeys.begin)
+										.detail("KeyEnd", rangeIntersectKeys.end)
+										.detail("Server", uid);
+									throw bulk_load_overlapping_team();
+								}
+							}
+						}
+
 						/*TraceEvent("StartMoveKeysOldRange", relocationIntervalId)
 							.detail("KeyBegin", rangeIntersectKeys.begin.c_str())
 							.detail("KeyEnd", rangeIntersectKeys.end.c_str())
@@ -330,6 +380,12 @@ ACTOR Future<Void> startMoveKeys( Database occ, KeyRange keys, vector<UID> serve
 						}
 					}
 
+					// Register the parts of currentKeys registered for bulk load again, now that keyServers names the new team, so
+					// that the registration reaches its storage servers (see fetchKeys).  This only splits the registration.
+					for(int i = 0; i < bulkLoads.size() - 1; i++)
+						if( bulkLoads[i].value.size() )
+							tr.set( bulkLoads[i].key.withPrefix( bulkLoadPrefix ), bulkLoads[i].value );
+
 					state std::set<UID>::iterator oldDest;
 
 					//Remove old dests from serverKeys.  In order for krmSetRangeCoalescing to work correctly in the same prefix for a single transaction, we must
@@ -359,7 +415,7 @@ ACTOR Future<Void> startMoveKeys( Database occ, KeyRange keys, vector<UID> serve
 					break;
 				} catch (Error& e) {
 					state Error err = e;
-					if (err.code() == error_code_move_to_removed_server)
+					if (err.code() == error_code_move_to_removed_server || err.code() == error_code_bulk_load_overlapping_team)
 						throw;
 					wait( tr.onError(e) );
 
@@ -641,6 +697,8 @@ ACTOR Future<Void> finishMoveKeys( Database occ, KeyRange keys, vector<UID> dest
 					TraceEvent(SevDebug, waitInterval.end(), relocationIntervalId).detail("ReadyServers", count);
 
 					if( count == dest.size() ) {
+						state Standalone<RangeResultRef> bulkLoads = wait( krmGetRanges( &tr, bulkLoadPrefix, currentKeys, SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT, SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES ) );
+
 						// update keyServers, serverKeys
 						// SOMEDAY: Doing these in parallel is safe because none of them overlap or touch (one per server)
 						wait( krmSetRangeCoalescing( &tr, keyServersPrefix, currentKeys, keys, keyServersValue( dest ) ) );
@@ -653,6 +711,12 @@ ACTOR Future<Void> finishMoveKeys( Database occ, KeyRange keys, vector<UID> dest
 							++asi;
 						}
 
+						// The destinations have ingested any part of currentKeys registered for bulk load, which this commit publishes
+						if( mayHaveBulkLoad( bulkLoads, currentKeys ) ) {
+							TEST(true); //finish move keys publishes a bulk load
+							actors.push_back( krmSetRangeCoalescing( &tr, bulkLoadPrefix, currentKeys, allKeys, Value() ) );
+						}
+
 						wait(waitForAll(actors));
 						wait( tr.commit() );
 
@@ -63,6 +63,8 @@ ACTOR Future<Void> moveKeys(Database occ, KeyRange keys, vector<UID> destination
 // Caller is responsible for cancelling it before issuing an overlapping move,
 // for restarting the remainder, and for not otherwise cancelling it before
 // it returns (since it needs to execute the finishMoveKeys transaction).
+// Keys registered for bulk load (see bulkLoadKeys) are ingested by the destination team, which must not include any
+// of their current servers, and become visible when the move completes.
 
 ACTOR Future<std::pair<Version, Tag>> addStorageServer(Database cx, StorageServerInterface server);
 // Adds a newly recruited storage server to a database (e.g. adding it to FF/serverList)
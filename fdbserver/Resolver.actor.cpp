@@ -143,10 +143,15 @@ ACTOR Future<Void> resolveBatch(
 			keys += req.transactions[t].write_conflict_ranges.size()*2 + req.transactions[t].read_conflict_ranges.size()*2;
 			
 			if(self->resolverCount > 1) {
-				for(auto it : req.transactions[t].write_conflict_ranges)
+				// Both ends of a conflict range are compared against the conflict set, so charge the sample at each of them
+				for(auto it : req.transactions[t].write_conflict_ranges) {
 					self->iopsSample.addAndExpire( it.begin, SERVER_KNOBS->SAMPLE_OFFSET_PER_KEY + it.begin.size(), expire );
-				for(auto it : req.transactions[t].read_conflict_ranges)
+					self->iopsSample.addAndExpire( it.end, SERVER_KNOBS->SAMPLE_OFFSET_PER_KEY + it.end.size(), expire );
+				}
+				for(auto it : req.transactions[t].read_conflict_ranges) {
 					self->iopsSample.addAndExpire( it.begin, SERVER_KNOBS->SAMPLE_OFFSET_PER_KEY + it.begin.size(), expire );
+					self->iopsSample.addAndExpire( it.end, SERVER_KNOBS->SAMPLE_OFFSET_PER_KEY + it.end.size(), expire );
+				}
 			}
 		}
 		conflictBatch.detectConflicts( req.version, req.version - SERVER_KNOBS->MAX_WRITE_TRANSACTION_LIFE_VERSIONS, commitList, &tooOldList);
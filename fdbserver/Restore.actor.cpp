@@ -18,86 +18,762 @@
  * limitations under the License.
  */
 
+#include <numeric>
 #include "fdbserver/RestoreInterface.h"
 #include "fdbclient/NativeAPI.actor.h"
+#include "fdbclient/ReadYourWrites.h"
 #include "fdbclient/SystemData.h"
+#include "fdbclient/BackupAgent.actor.h"
+#include "fdbclient/BackupContainer.h"
+#include "fdbserver/Knobs.h"
+#include "flow/ActorCollection.h"
 #include "flow/actorcompiler.h"  // This must be the last #include.
 
-ACTOR Future<Void> restoreWorker(Reference<ClusterConnectionFile> ccf, LocalityData locality) {
-	state Database cx = Database::createDatabase(ccf->getFilename(), Database::API_VERSION_LATEST, true, locality);
-	state RestoreInterface interf;
-	interf.initEndpoints();
-	state Optional<RestoreInterface> leaderInterf;
+// A restore is split into version batches which are applied one after another.  Within a batch, loaders parse their
+// files in parallel and appliers each own a disjoint key range, so applying a batch is conflict free; the mutations
+// of a key are applied in version order because every mutation of that key within the batch lands on one applier.
+// Batch boundaries fall on log file boundaries so that every log mutation older than a range file's version is
+// applied before (and overwritten by) the range file's data.
 
-	state Transaction tr(cx);
-	loop {
-		try {
-			Optional<Value> leader = wait(tr.get(restoreLeaderKey));
-			if(leader.present()) {
-				leaderInterf = BinaryReader::fromStringRef<RestoreInterface>(leader.get(), IncludeVersion());
-				break;
+struct VersionedMutations : ReferenceCounted<VersionedMutations> {
+	Arena arena;
+	VersionedMutationsRef data;
+	int64_t bytes;
+	int64_t bytesSinceSample;
+	Standalone<VectorRef<KeyRef>> samples;
+
+	VersionedMutations() : bytes(0), bytesSinceSample(0) {}
+
+	// Adds the parts of m that fall within ranges, sampling one key per RESTORE_SAMPLE_BYTES added.
+	void add(VectorRef<KeyRangeRef> ranges, MutationRef const& m, Version version, int32_t subVersion) {
+		if(m.type == MutationRef::ClearRange) {
+			KeyRangeRef clear(m.param1, m.param2);
+			for(auto& r : ranges) {
+				if(r.intersects(clear)) {
+					KeyRangeRef c = r & clear;
+					push(MutationRef(MutationRef::ClearRange, c.begin, c.end), version, subVersion);
+				}
 			}
-			tr.set(restoreLeaderKey, BinaryWriter::toValue(interf, IncludeVersion()));
-			wait(tr.commit());
-			break;
-		} catch( Error &e ) {
-			wait( tr.onError(e) );
+		} else {
+			for(auto& r : ranges) {
+				if(r.contains(m.param1)) {
+					push(m, version, subVersion);
+					break;
+				}
+			}
+		}
+	}
+
+private:
+	void push(MutationRef const& m, Version version, int32_t subVersion) {
+		data.push_back_deep(arena, m, version, subVersion);
+		bytes += m.expectedSize();
+		bytesSinceSample += m.expectedSize();
+		if(bytesSinceSample >= SERVER_KNOBS->RESTORE_SAMPLE_BYTES) {
+			samples.push_back_deep(samples.arena(), m.param1);
+			bytesSinceSample = 0;
 		}
 	}
+};
+
+struct RestoreWorkerData {
+	UID id;
+	UID restoreId;
+	std::map<int, Reference<VersionedMutations>> loaded;  // Batches parsed by this loader and not yet sent
+	std::map<int, Reference<VersionedMutations>> received;  // Batches sent to this applier and not yet applied
+	FlowLock fileLock;
+
+	explicit RestoreWorkerData(UID id) : id(id), fileLock(SERVER_KNOBS->RESTORE_LOADER_FILE_PARALLELISM) {}
+
+	// Forgets the batches of an earlier restore the first time a request of a new restore is seen
+	void setRestore(UID const& uid) {
+		if(uid != restoreId) {
+			restoreId = uid;
+			loaded.clear();
+			received.clear();
+		}
+	}
+};
+
+struct RestoreVersionBatch {
+	Version beginVersion;
+	Version endVersion;
+	std::vector<RestoreFile> files;
+	int64_t bytes;
+
+	RestoreVersionBatch() : beginVersion(invalidVersion), endVersion(invalidVersion), bytes(0) {}
+};
+
+// Range file values at a version are applied after every log mutation of that version
+static const int32_t rangeFileSubVersion = std::numeric_limits<int32_t>::max();
+
+static void addLogValue(VersionedMutations* batch, VectorRef<KeyRangeRef> ranges, Version version, std::string const& value) {
+	if(value.empty())
+		return;
+	Standalone<VectorRef<MutationRef>> mutations = decodeBackupLogValue(StringRef(value));
+	for(int i = 0; i < mutations.size(); i++) {
+		batch->add(ranges, mutations[i], version, i);
+	}
+}
+
+ACTOR static Future<Void> loadRangeFile(Reference<IBackupContainer> bc, RestoreFile file, VectorRef<KeyRangeRef> ranges, Reference<VersionedMutations> batch) {
+	state Reference<IAsyncFile> inFile = wait(bc->readFile(file.fileName));
+	state int64_t offset;
+	for(offset = 0; offset < file.fileSize; offset += file.blockSize) {
+		Standalone<VectorRef<KeyValueRef>> blockData = wait(fileBackup::decodeRangeFileBlock(inFile, offset, std::min<int64_t>(file.blockSize, file.fileSize - offset)));
+		// The first and last keys are the range covered by the block and carry no values
+		for(int i = 1; i < blockData.size() - 1; i++) {
+			batch->add(ranges, MutationRef(MutationRef::SetValue, blockData[i].key, blockData[i].value), file.beginVersion, rangeFileSubVersion);
+		}
+	}
+	return Void();
+}
+
+ACTOR static Future<Void> loadLogFile(Reference<IBackupContainer> bc, RestoreFile file, Version beginVersion, Version endVersion, VectorRef<KeyRangeRef> ranges, Reference<VersionedMutations> batch) {
+	state Reference<IAsyncFile> inFile = wait(bc->readFile(file.fileName));
+	state Version version = invalidVersion;
+	state int32_t nextPart = 0;
+	state std::string value;
+	state int64_t offset;
+	for(offset = 0; offset < file.fileSize; offset += file.blockSize) {
+		Standalone<VectorRef<KeyValueRef>> data = wait(fileBackup::decodeLogFileBlock(inFile, offset, std::min<int64_t>(file.blockSize, file.fileSize - offset)));
+		for(auto& kv : data) {
+			// Keys are a hash byte followed by the big endian version and part number.  The parts of a version's value
+			// are consecutive, possibly spanning blocks.
+			if(kv.key.size() != sizeof(uint8_t) + sizeof(Version) + sizeof(int32_t))
+				throw restore_corrupted_data();
+			Version v = bigEndian64(*(int64_t*)(kv.key.begin() + sizeof(uint8_t)));
+			int32_t part = bigEndian32(*(int32_t*)(kv.key.begin() + sizeof(uint8_t) + sizeof(Version)));
+			if(v != version) {
+				addLogValue(batch.getPtr(), ranges, version, value);
+				version = v;
+				nextPart = 0;
+				value.clear();
+			}
+			if(part != nextPart++)
+				throw restore_corrupted_data();
+			if(v >= beginVersion && v < endVersion)
+				value.append((const char*)kv.value.begin(), kv.value.size());
+		}
+	}
+	addLogValue(batch.getPtr(), ranges, version, value);
+	return Void();
+}
+
+ACTOR static Future<Void> loadFile(RestoreWorkerData* self, Reference<IBackupContainer> bc, RestoreFile file, Version beginVersion, Version endVersion, VectorRef<KeyRangeRef> ranges, Reference<VersionedMutations> batch) {
+	wait(self->fileLock.take());
+	state FlowLock::Releaser releaser(self->fileLock);
+	if(file.isRange) {
+		wait(loadRangeFile(bc, file, ranges, batch));
+	} else {
+		wait(loadLogFile(bc, file, beginVersion, endVersion, ranges, batch));
+	}
+	return Void();
+}
+
+ACTOR static Future<Void> loadFiles(RestoreWorkerData* self, RestoreLoadFilesRequest req) {
+	try {
+		state double startTime = now();
+		state Reference<VersionedMutations> batch(new VersionedMutations());
+		state Reference<IBackupContainer> bc = IBackupContainer::openContainer(req.url.toString());
+		std::vector<Future<Void>> loads;
+		for(auto& file : req.files) {
+			loads.push_back(loadFile(self, bc, file, req.beginVersion, req.endVersion, req.ranges, batch));
+		}
+		wait(waitForAll(loads));
+
+		if(req.restoreId != self->restoreId)
+			throw restore_error();
+		self->loaded[req.batchIndex] = batch;
+
+		TraceEvent(SevDebug, "RestoreLoaderLoadedFiles", self->id)
+			.detail("RestoreUID", req.restoreId)
+			.detail("Batch", req.batchIndex)
+			.detail("Files", req.files.size())
+			.detail("Mutations", batch->data.size())
+			.detail("Bytes", batch->bytes)
+			.detail("Elapsed", now() - startTime);
+
+		RestoreLoadFilesReply reply;
+		reply.samples = batch->samples;
+		reply.bytes = batch->bytes;
+		req.reply.send(reply);
+	} catch(Error& e) {
+		if(e.code() == error_code_actor_cancelled)
+			throw;
+		TraceEvent(SevWarn, "RestoreLoaderLoadFailed", self->id).error(e).detail("RestoreUID", req.restoreId).detail("Batch", req.batchIndex);
+		req.reply.sendError(e);
+	}
+	return Void();
+}
+
+// Returns the index of the applier owning key, where applier i owns [splitKeys[i-1], splitKeys[i])
+static int applierFor(VectorRef<KeyRef> const& splitKeys, KeyRef const& key) {
+	return std::upper_bound(splitKeys.begin(), splitKeys.end(), key) - splitKeys.begin();
+}
+
+ACTOR static Future<Void> sendMutations(RestoreWorkerData* self, RestoreSendMutationsRequest req) {
+	try {
+		auto it = self->loaded.find(req.batchIndex);
+		if(req.restoreId != self->restoreId || it == self->loaded.end())
+			throw restore_error();
+		state Reference<VersionedMutations> batch = it->second;
+		self->loaded.erase(it);
+
+		// Requests reference the batch's memory rather than copying it
+		state std::vector<RestoreApplierMutationsRequest> pending(req.appliers.size());
+		for(auto& p : pending) {
+			p.restoreId = req.restoreId;
+			p.batchIndex = req.batchIndex;
+			p.arena.dependsOn(batch->arena);
+		}
+		state std::vector<Future<Void>> sends;
+		state int i;
+		for(i = 0; i < batch->data.size(); i++) {
+			MutationRef const& m = batch->data.mutations[i];
+			Version v = batch->data.versions[i];
+			int32_t sub = batch->data.subVersions[i];
+			int a = applierFor(req.splitKeys, m.param1);
+			int first = a;
+			if(m.type == MutationRef::ClearRange) {
+				// Split clears spanning several appliers at the applier boundaries
+				while(true) {
+					bool last = a == req.splitKeys.size() || m.param2 <= req.splitKeys[a];
+					KeyRef begin = a == 0 ? m.param1 : std::max(m.param1, req.splitKeys[a - 1]);
+					KeyRef end = last ? m.param2 : req.splitKeys[a];
+					if(begin < end)
+						pending[a].mutations.push_back(pending[a].arena, MutationRef(MutationRef::ClearRange, begin, end), v, sub);
+					if(last)
+						break;
+					a++;
+				}
+			} else {
+				pending[a].mutations.push_back(pending[a].arena, m, v, sub);
+			}
+
+			for(int p = first; p <= a; p++) {
+				if(pending[p].mutations.expectedSize() >= SERVER_KNOBS->RESTORE_SEND_MUTATION_BYTES) {
+					sends.push_back(req.appliers[p].applierMutations.getReply(pending[p]));
+					pending[p] = RestoreApplierMutationsRequest();
+					pending[p].restoreId = req.restoreId;
+					pending[p].batchIndex = req.batchIndex;
+					pending[p].arena.dependsOn(batch->arena);
+				}
+			}
+			if(i % 1000 == 999)
+				wait(yield());
+		}
+		for(i = 0; i < pending.size(); i++) {
+			if(pending[i].mutations.size()) {
+				sends.push_back(req.appliers[i].applierMutations.getReply(pending[i]));
+			}
+		}
+		wait(waitForAll(sends));
+		req.reply.send(Void());
+	} catch(Error& e) {
+		if(e.code() == error_code_actor_cancelled)
+			throw;
+		TraceEvent(SevWarn, "RestoreLoaderSendFailed", self->id).error(e).detail("RestoreUID", req.restoreId).detail("Batch", req.batchIndex);
+		req.reply.sendError(e);
+	}
+	return Void();
+}
+
+// Commits the batch in version order.  Each transaction records its position in the applier's progress key, so a
+// transaction retried after commit_unknown_result is not applied twice.  Appliers own disjoint key ranges, so writes
+// carry no conflict ranges.
+ACTOR static Future<Void> commitMutations(Database cx, UID applierId, UID restoreId, int batchIndex, Reference<VersionedMutations> batch) {
+	state std::vector<int> order(batch->data.size());
+	std::iota(order.begin(), order.end(), 0);
+	VersionedMutationsRef const& data = batch->data;
+	std::sort(order.begin(), order.end(), [&data](int a, int b) {
+		return data.versions[a] < data.versions[b] || (data.versions[a] == data.versions[b] && data.subVersions[a] < data.subVersions[b]);
+	});
+
+	state Key progressKey = restoreApplierKeyFor(applierId);
+	state Transaction tr(cx);
+	state int begin = 0;
+	state int txnIndex = 0;
+	while(begin < order.size()) {
+		state int end = begin;
+		int bytes = 0;
+		while(end < order.size() && (end == begin || bytes < SERVER_KNOBS->RESTORE_APPLY_TXN_BYTES)) {
+			bytes += batch->data.mutations[order[end]].expectedSize();
+			end++;
+		}
+		BinaryWriter wr(Unversioned());
+		wr << restoreId << batchIndex << txnIndex;
+		state Value progress = wr.toValue();
 
-	//we are not the leader, so put our interface in the agent list
-	if(leaderInterf.present()) {
 		loop {
 			try {
-				tr.set(restoreWorkerKeyFor(interf.id()), BinaryWriter::toValue(interf, IncludeVersion()));
+				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				Optional<Value> committed = wait(tr.get(progressKey));
+				if(committed.present() && committed.get() == progress)
+					break;
+
+				for(int i = begin; i < end; i++) {
+					MutationRef const& m = batch->data.mutations[order[i]];
+					if(m.type == MutationRef::SetValue) {
+						tr.set(m.param1, m.param2, false);
+					} else if(m.type == MutationRef::ClearRange) {
+						tr.clear(KeyRangeRef(m.param1, m.param2), false);
+					} else if(isAtomicOp((MutationRef::Type)m.type)) {
+						tr.atomicOp(m.param1, m.param2, (MutationRef::Type)m.type, false);
+					} else {
+						TraceEvent(SevError, "RestoreApplierUnexpectedMutation", applierId).detail("Mutation", m.toString());
+						throw restore_corrupted_data();
+					}
+				}
+				tr.set(progressKey, progress);
 				wait(tr.commit());
 				break;
-			} catch( Error &e ) {
-				wait( tr.onError(e) );
+			} catch(Error& e) {
+				wait(tr.onError(e));
 			}
 		}
 
-		loop {
-			choose {
-				when(TestRequest req = waitNext(interf.test.getFuture())) {
-					printf("Got Request: %d\n", req.testData);
-					req.reply.send(TestReply(req.testData + 1));
-				}
-			}
+		tr.reset();
+		begin = end;
+		txnIndex++;
+	}
+	return Void();
+}
+
+ACTOR static Future<Void> applyBatch(RestoreWorkerData* self, Database cx, RestoreApplyRequest req) {
+	try {
+		state double startTime = now();
+		state Reference<VersionedMutations> batch;
+		auto it = self->received.find(req.batchIndex);
+		if(req.restoreId == self->restoreId && it != self->received.end()) {
+			batch = it->second;
+			self->received.erase(it);
+		}
+		if(batch) {
+			wait(commitMutations(cx, self->id, req.restoreId, req.batchIndex, batch));
+			TraceEvent(SevDebug, "RestoreApplierAppliedBatch", self->id)
+				.detail("RestoreUID", req.restoreId)
+				.detail("Batch", req.batchIndex)
+				.detail("Mutations", batch->data.size())
+				.detail("Elapsed", now() - startTime);
 		}
+		req.reply.send(Void());
+	} catch(Error& e) {
+		if(e.code() == error_code_actor_cancelled)
+			throw;
+		TraceEvent(SevWarn, "RestoreApplierApplyFailed", self->id).error(e).detail("RestoreUID", req.restoreId).detail("Batch", req.batchIndex);
+		req.reply.sendError(e);
+	}
+	return Void();
+}
+
+static RestoreFile toRestoreFile(RangeFile const& f) {
+	RestoreFile file;
+	file.fileName = f.fileName;
+	file.fileSize = f.fileSize;
+	file.blockSize = f.blockSize;
+	file.isRange = true;
+	file.beginVersion = f.version;
+	file.endVersion = f.version;
+	return file;
+}
+
+static RestoreFile toRestoreFile(LogFile const& f) {
+	RestoreFile file;
+	file.fileName = f.fileName;
+	file.fileSize = f.fileSize;
+	file.blockSize = f.blockSize;
+	file.isRange = false;
+	file.beginVersion = f.beginVersion;
+	file.endVersion = f.endVersion;
+	return file;
+}
+
+// Groups the files of a restore into version batches of about RESTORE_VERSION_BATCH_BYTES.  Batches end at log file
+// boundaries and each range file goes to the batch containing its version.
+static std::vector<RestoreVersionBatch> splitVersionBatches(RestorableFileSet const& restorable) {
+	std::vector<RangeFile> ranges = restorable.ranges;
+	std::vector<LogFile> logs = restorable.logs;
+	std::sort(ranges.begin(), ranges.end());
+	std::sort(logs.begin(), logs.end());
+
+	std::vector<RestoreVersionBatch> batches;
+	RestoreVersionBatch current;
+	current.beginVersion = restorable.snapshot.beginVersion;
+	int r = 0;
+	for(auto& log : logs) {
+		if(log.endVersion <= current.beginVersion)
+			continue;
+		current.files.push_back(toRestoreFile(log));
+		current.bytes += log.fileSize;
+		for(; r < ranges.size() && ranges[r].version < log.endVersion; r++) {
+			current.files.push_back(toRestoreFile(ranges[r]));
+			current.bytes += ranges[r].fileSize;
+		}
+		if(current.bytes >= SERVER_KNOBS->RESTORE_VERSION_BATCH_BYTES && log.endVersion <= restorable.targetVersion) {
+			current.endVersion = log.endVersion;
+			batches.push_back(current);
+			current = RestoreVersionBatch();
+			current.beginVersion = log.endVersion;
+		}
+	}
+	for(; r < ranges.size(); r++) {
+		current.files.push_back(toRestoreFile(ranges[r]));
+		current.bytes += ranges[r].fileSize;
+	}
+	current.endVersion = restorable.targetVersion + 1;
+	if(!current.files.empty())
+		batches.push_back(current);
+	return batches;
+}
+
+// Loads a batch on the loaders, splits its keys evenly among the appliers using the loaders' samples and has the
+// loaders send their mutations to the appliers.
+ACTOR static Future<Void> distributeBatch(std::vector<RestoreInterface> workers, RestoreRequest request, RestoreVersionBatch batch, int batchIndex, int64_t* bytes) {
+	state double startTime = now();
+
+	// Give each file, largest first, to the loader with the fewest bytes
+	std::sort(batch.files.begin(), batch.files.end(), [](RestoreFile const& a, RestoreFile const& b) { return a.fileSize > b.fileSize; });
+	std::vector<std::vector<RestoreFile>> assigned(workers.size());
+	std::vector<int64_t> assignedBytes(workers.size());
+	for(auto& file : batch.files) {
+		int i = std::min_element(assignedBytes.begin(), assignedBytes.end()) - assignedBytes.begin();
+		assigned[i].push_back(file);
+		assignedBytes[i] += file.fileSize;
 	}
 
-	//we are the leader
-	wait( delay(5.0) );
+	state std::vector<int> loaders;
+	state std::vector<Future<RestoreLoadFilesReply>> loads;
+	for(int i = 0; i < workers.size(); i++) {
+		if(assigned[i].empty())
+			continue;
+		RestoreLoadFilesRequest req;
+		req.restoreId = request.randomUid;
+		req.batchIndex = batchIndex;
+		req.url = StringRef(req.arena, request.url);
+		req.files = assigned[i];
+		req.beginVersion = batch.beginVersion;
+		req.endVersion = batch.endVersion;
+		req.ranges = VectorRef<KeyRangeRef>(req.arena, request.ranges);
+		loaders.push_back(i);
+		loads.push_back(workers[i].loadFiles.getReply(req));
+	}
+	std::vector<RestoreLoadFilesReply> replies = wait(getAll(loads));
+
+	state Standalone<VectorRef<KeyRef>> splitKeys;
+	std::vector<KeyRef> samples;
+	for(auto& reply : replies) {
+		*bytes += reply.bytes;
+		samples.insert(samples.end(), reply.samples.begin(), reply.samples.end());
+	}
+	std::sort(samples.begin(), samples.end());
+	for(int i = 1; i < workers.size() && !samples.empty(); i++) {
+		KeyRef k = samples[i * samples.size() / workers.size()];
+		if(splitKeys.empty() || splitKeys.back() < k)
+			splitKeys.push_back_deep(splitKeys.arena(), k);
+	}
+
+	// Rotate the appliers so successive batches spread over all workers
+	std::vector<RestoreInterface> appliers;
+	for(int i = 0; i <= splitKeys.size(); i++) {
+		appliers.push_back(workers[(batchIndex + i) % workers.size()]);
+	}
+	std::vector<Future<Void>> sends;
+	for(int i : loaders) {
+		RestoreSendMutationsRequest req;
+		req.restoreId = request.randomUid;
+		req.batchIndex = batchIndex;
+		req.splitKeys = VectorRef<KeyRef>(req.arena, splitKeys);
+		req.appliers = appliers;
+		sends.push_back(workers[i].sendMutations.getReply(req));
+	}
+	wait(waitForAll(sends));
+
+	TraceEvent("RestoreBatchDistributed")
+		.detail("RestoreUID", request.randomUid)
+		.detail("Batch", batchIndex)
+		.detail("BeginVersion", batch.beginVersion)
+		.detail("EndVersion", batch.endVersion)
+		.detail("Files", batch.files.size())
+		.detail("FileBytes", batch.bytes)
+		.detail("Loaders", loaders.size())
+		.detail("Appliers", splitKeys.size() + 1)
+		.detail("Elapsed", now() - startTime);
+	return Void();
+}
+
+// Applies a batch once it has been distributed and every earlier batch has been applied.
+ACTOR static Future<Void> applyBatchInOrder(std::vector<RestoreInterface> workers, UID restoreId, int batchIndex, Future<Void> distributed, Future<Void> previous) {
+	wait(previous);
+	wait(distributed);
+	state double startTime = now();
+	std::vector<Future<Void>> applies;
+	for(auto& w : workers) {
+		applies.push_back(w.apply.getReply(RestoreApplyRequest(restoreId, batchIndex)));
+	}
+	wait(waitForAll(applies));
+	TraceEvent("RestoreBatchApplied").detail("RestoreUID", restoreId).detail("Batch", batchIndex).detail("Elapsed", now() - startTime);
+	return Void();
+}
 
-	state vector<RestoreInterface> agents;
+ACTOR static Future<Void> checkDestinationEmpty(Database cx, Standalone<VectorRef<KeyRangeRef>> ranges) {
+	state Transaction tr(cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			std::vector<Future<Standalone<RangeResultRef>>> reads;
+			for(auto& range : ranges) {
+				reads.push_back(tr.getRange(range, 1));
+			}
+			std::vector<Standalone<RangeResultRef>> results = wait(getAll(reads));
+			for(auto& result : results) {
+				if(!result.empty())
+					throw restore_destination_not_empty();
+			}
+			return Void();
+		} catch(Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+ACTOR static Future<std::vector<RestoreInterface>> getRestoreWorkers(Database cx) {
+	state Transaction tr(cx);
 	loop {
 		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
 			Standalone<RangeResultRef> agentValues = wait(tr.getRange(restoreWorkersKeys, CLIENT_KNOBS->TOO_MANY));
 			ASSERT(!agentValues.more);
-			if(agentValues.size()) {
-				for(auto& it : agentValues) {
-					agents.push_back(BinaryReader::fromStringRef<RestoreInterface>(it.value, IncludeVersion()));
+			std::vector<RestoreInterface> workers;
+			for(auto& it : agentValues) {
+				workers.push_back(BinaryReader::fromStringRef<RestoreInterface>(it.value, IncludeVersion()));
+			}
+			return workers;
+		} catch(Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+ACTOR static Future<Void> processRestoreRequest(Database cx, RestoreRequest request, RestoreRequestResult* result) {
+	state std::vector<RestoreInterface> workers = wait(getRestoreWorkers(cx));
+	if(workers.empty())
+		throw restore_error();
+
+	state Reference<IBackupContainer> bc = IBackupContainer::openContainer(request.url.toString());
+	state Version targetVersion = request.targetVersion;
+	if(targetVersion == invalidVersion) {
+		BackupDescription desc = wait(bc->describeBackup());
+		if(!desc.maxRestorableVersion.present())
+			throw restore_invalid_version();
+		targetVersion = desc.maxRestorableVersion.get();
+	}
+	Optional<RestorableFileSet> restorable = wait(bc->getRestoreSet(targetVersion));
+	if(!restorable.present())
+		throw restore_missing_data();
+	state std::vector<RestoreVersionBatch> batches = splitVersionBatches(restorable.get());
+
+	wait(checkDestinationEmpty(cx, request.ranges));
+
+	TraceEvent("RestoreRequestStarted")
+		.detail("RestoreUID", request.randomUid)
+		.detail("URL", request.url)
+		.detail("TargetVersion", targetVersion)
+		.detail("Workers", workers.size())
+		.detail("Batches", batches.size());
+
+	// Batches are loaded and distributed up to RESTORE_PIPELINE_DEPTH ahead of the batch being applied
+	state std::deque<Future<Void>> inFlight;
+	state Future<Void> applied = Void();
+	state int b;
+	for(b = 0; b < batches.size(); b++) {
+		Future<Void> distributed = distributeBatch(workers, request, batches[b], b, &result->bytes);
+		applied = applyBatchInOrder(workers, request.randomUid, b, distributed, applied);
+		inFlight.push_back(applied);
+		while(inFlight.size() >= SERVER_KNOBS->RESTORE_PIPELINE_DEPTH) {
+			wait(inFlight.front());
+			inFlight.pop_front();
+		}
+	}
+	wait(applied);
+	result->restoredVersion = targetVersion;
+	return Void();
+}
+
+// Serves restore requests submitted through restoreRequestKey, one at a time.
+ACTOR static Future<Void> restoreLeader(Database cx, UID leaderId) {
+	state ReadYourWritesTransaction tr(cx);
+	loop {
+		state RestoreRequest request;
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				Optional<Value> value = wait(tr.get(restoreRequestKey));
+				if(value.present()) {
+					request = BinaryReader::fromStringRef<RestoreRequest>(value.get(), IncludeVersion());
+					break;
 				}
+				state Future<Void> watchFuture = tr.watch(restoreRequestKey);
+				wait(tr.commit());
+				wait(watchFuture);
+				tr.reset();
+			} catch(Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+
+		state RestoreRequestResult result;
+		result.randomUid = request.randomUid;
+		state double startTime = now();
+		try {
+			wait(processRestoreRequest(cx, request, &result));
+		} catch(Error& e) {
+			if(e.code() == error_code_actor_cancelled)
+				throw;
+			TraceEvent(SevWarnAlways, "RestoreRequestFailed", leaderId).error(e).detail("RestoreUID", request.randomUid);
+			result.errorCode = e.code();
+		}
+		result.elapsed = now() - startTime;
+
+		TraceEvent("RestoreRequestComplete", leaderId)
+			.detail("RestoreUID", request.randomUid)
+			.detail("Error", result.errorCode)
+			.detail("RestoredVersion", result.restoredVersion)
+			.detail("Bytes", result.bytes)
+			.detail("Elapsed", result.elapsed)
+			.detail("BytesPerSecond", result.elapsed > 0 ? result.bytes / result.elapsed : 0);
+
+		tr.reset();
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				tr.clear(restoreRequestKey);
+				tr.clear(restoreApplierKeys);
+				tr.set(restoreRequestDoneKey, BinaryWriter::toValue(result, IncludeVersion()));
+				wait(tr.commit());
 				break;
+			} catch(Error& e) {
+				wait(tr.onError(e));
 			}
-			wait( delay(5.0) );
+		}
+		tr.reset();
+	}
+}
+
+ACTOR Future<Void> runRestoreWorker(Database cx) {
+	state RestoreInterface interf;
+	interf.initEndpoints();
+	state RestoreWorkerData self(interf.id());
+	state ActorCollection actors(false);
+	state Future<Void> leader = Never();
+	state bool isLeader = false;
+
+	// The first worker to register becomes the leader; every worker, including the leader, loads and applies
+	state Transaction tr(cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			Optional<Value> leaderValue = wait(tr.get(restoreLeaderKey));
+			isLeader = !leaderValue.present();
+			if(isLeader) {
+				tr.set(restoreLeaderKey, BinaryWriter::toValue(interf, IncludeVersion()));
+			}
+			tr.set(restoreWorkerKeyFor(interf.id()), BinaryWriter::toValue(interf, IncludeVersion()));
+			wait(tr.commit());
+			break;
 		} catch( Error &e ) {
 			wait( tr.onError(e) );
 		}
 	}
 
-	ASSERT(agents.size() > 0);
+	TraceEvent("RestoreWorkerStarted", interf.id()).detail("Leader", isLeader);
+	if(isLeader) {
+		leader = restoreLeader(cx, interf.id());
+	}
+
+	loop {
+		choose {
+			when(RestoreLoadFilesRequest req = waitNext(interf.loadFiles.getFuture())) {
+				self.setRestore(req.restoreId);
+				actors.add(loadFiles(&self, req));
+			}
+			when(RestoreSendMutationsRequest req = waitNext(interf.sendMutations.getFuture())) {
+				actors.add(sendMutations(&self, req));
+			}
+			when(RestoreApplierMutationsRequest req = waitNext(interf.applierMutations.getFuture())) {
+				self.setRestore(req.restoreId);
+				auto& batch = self.received[req.batchIndex];
+				if(!batch) {
+					batch = Reference<VersionedMutations>(new VersionedMutations());
+				}
+				batch->arena.dependsOn(req.arena);
+				for(int i = 0; i < req.mutations.size(); i++) {
+					batch->data.push_back(batch->arena, req.mutations.mutations[i], req.mutations.versions[i], req.mutations.subVersions[i]);
+				}
+				req.reply.send(Void());
+			}
+			when(RestoreApplyRequest req = waitNext(interf.apply.getFuture())) {
+				actors.add(applyBatch(&self, cx, req));
+			}
+			when(wait(leader)) {}
+			when(wait(actors.getResult())) {}
+		}
+	}
+}
+
+ACTOR Future<Void> restoreWorker(Reference<ClusterConnectionFile> ccf, LocalityData locality) {
+	state Database cx = Database::createDatabase(ccf->getFilename(), Database::API_VERSION_LATEST, true, locality);
+	wait(runRestoreWorker(cx));
+	return Void();
+}
 
-	state int testData = 0;
+ACTOR Future<RestoreRequestResult> submitParallelRestore(Database cx, RestoreRequest request) {
+	state ReadYourWritesTransaction tr(cx);
 	loop {
-		wait(delay(1.0));
-		printf("Sending Request: %d\n", testData);
-		std::vector<Future<TestReply>> replies;
-		for(auto& it : agents) {
-			replies.push_back( it.test.getReply(TestRequest(testData)) );
-		}
-		std::vector<TestReply> reps = wait( getAll(replies ));
-		testData = reps[0].replyData;
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			Optional<Value> pending = wait(tr.get(restoreRequestKey));
+			if(!pending.present()) {
+				tr.set(restoreRequestKey, BinaryWriter::toValue(request, IncludeVersion()));
+				wait(tr.commit());
+				break;
+			}
+			// Wait for the restore in progress to finish
+			state Future<Void> pendingDone = tr.watch(restoreRequestKey);
+			wait(tr.commit());
+			wait(pendingDone);
+			tr.reset();
+		} catch(Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+
+	tr.reset();
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			Optional<Value> done = wait(tr.get(restoreRequestDoneKey));
+			if(done.present()) {
+				RestoreRequestResult result = BinaryReader::fromStringRef<RestoreRequestResult>(done.get(), IncludeVersion());
+				if(result.randomUid == request.randomUid) {
+					if(result.errorCode)
+						throw Error(result.errorCode);
+					return result;
+				}
+			}
+			state Future<Void> doneChanged = tr.watch(restoreRequestDoneKey);
+			wait(tr.commit());
+			wait(doneChanged);
+			tr.reset();
+		} catch(Error& e) {
+			wait(tr.onError(e));
+		}
 	}
 }
@@ -23,56 +23,213 @@
 #pragma once
 
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/NativeAPI.actor.h"
 #include "fdbrpc/fdbrpc.h"
 #include "fdbserver/CoordinationInterface.h"
 #include "fdbrpc/Locality.h"
 
+// A restore worker acts as both a loader and an applier.  Loaders parse backup files into versioned mutations and
+// route them to appliers; each applier owns a disjoint key range of a version batch, sorts the mutations it receives
+// by version and commits them.  One worker is elected leader and drives the batches.
 struct RestoreInterface {
 	constexpr static FileIdentifier file_identifier = 13398189;
-	RequestStream< struct TestRequest > test;
+	RequestStream< struct RestoreLoadFilesRequest > loadFiles;
+	RequestStream< struct RestoreSendMutationsRequest > sendMutations;
+	RequestStream< struct RestoreApplierMutationsRequest > applierMutations;
+	RequestStream< struct RestoreApplyRequest > apply;
 
 	bool operator == (RestoreInterface const& r) const { return id() == r.id(); }
 	bool operator != (RestoreInterface const& r) const { return id() != r.id(); }
-	UID id() const { return test.getEndpoint().token; }
-	NetworkAddress address() const { return test.getEndpoint().getPrimaryAddress(); }
+	UID id() const { return loadFiles.getEndpoint().token; }
+	NetworkAddress address() const { return loadFiles.getEndpoint().getPrimaryAddress(); }
 
 	void initEndpoints() {
-		test.getEndpoint( TaskPriority::ClusterController );
+		loadFiles.getEndpoint( TaskPriority::ClusterController );
+		sendMutations.getEndpoint( TaskPriority::ClusterController );
+		applierMutations.getEndpoint( TaskPriority::ClusterController );
+		apply.getEndpoint( TaskPriority::ClusterController );
 	}
 
 	template <class Ar>
 	void serialize( Ar& ar ) {
-		serializer(ar, test);
+		serializer(ar, loadFiles, sendMutations, applierMutations, apply);
 	}
 };
 
-struct TestReply {
-	constexpr static FileIdentifier file_identifier = 12075719;
-	int replyData;
+// A range or log file of a backup.  Range files have beginVersion == endVersion; log files cover
+// [beginVersion, endVersion).
+struct RestoreFile {
+	constexpr static FileIdentifier file_identifier = 5813960;
+	std::string fileName;
+	int64_t fileSize;
+	uint32_t blockSize;
+	bool isRange;
+	Version beginVersion;
+	Version endVersion;
 
-	TestReply() : replyData(0) {}
-	explicit TestReply(int replyData) : replyData(replyData) {}
+	RestoreFile() : fileSize(0), blockSize(0), isRange(false), beginVersion(invalidVersion), endVersion(invalidVersion) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, replyData);
+		serializer(ar, fileName, fileSize, blockSize, isRange, beginVersion, endVersion);
 	}
 };
 
-struct TestRequest {
-	constexpr static FileIdentifier file_identifier = 14404487;
-	int testData;
-	ReplyPromise< struct TestReply > reply;
+// Mutations tagged with the version they were committed at.  subVersions orders mutations within a version: log
+// mutations keep their commit order and range file data sorts after every log mutation of the same version.
+struct VersionedMutationsRef {
+	constexpr static FileIdentifier file_identifier = 11380617;
+	VectorRef<MutationRef> mutations;
+	VectorRef<Version> versions;
+	VectorRef<int32_t> subVersions;
 
-	TestRequest() : testData(0) {}
-	explicit TestRequest(int testData) : testData(testData) {}
+	void push_back(Arena& arena, MutationRef const& m, Version v, int32_t sub) {
+		mutations.push_back(arena, m);
+		versions.push_back(arena, v);
+		subVersions.push_back(arena, sub);
+	}
+	void push_back_deep(Arena& arena, MutationRef const& m, Version v, int32_t sub) {
+		mutations.push_back_deep(arena, m);
+		versions.push_back(arena, v);
+		subVersions.push_back(arena, sub);
+	}
+	int size() const { return mutations.size(); }
+	int expectedSize() const { return mutations.expectedSize() + versions.expectedSize() + subVersions.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, mutations, versions, subVersions);
+	}
+};
+
+// Sent by the leader to a loader: parse files for one version batch, keeping only mutations within [beginVersion,
+// endVersion) that touch ranges, and hold them until the batch is sent to appliers.
+struct RestoreLoadFilesReply {
+	constexpr static FileIdentifier file_identifier = 2401379;
+	Standalone<VectorRef<KeyRef>> samples;  // One key per RESTORE_SAMPLE_BYTES of loaded mutations
+	int64_t bytes;
+
+	RestoreLoadFilesReply() : bytes(0) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, testData, reply);
+		serializer(ar, samples, bytes);
+	}
+};
+
+struct RestoreLoadFilesRequest {
+	constexpr static FileIdentifier file_identifier = 8812644;
+	Arena arena;
+	UID restoreId;
+	int batchIndex;
+	KeyRef url;
+	std::vector<RestoreFile> files;
+	Version beginVersion;
+	Version endVersion;
+	VectorRef<KeyRangeRef> ranges;
+	ReplyPromise<RestoreLoadFilesReply> reply;
+
+	RestoreLoadFilesRequest() : batchIndex(0), beginVersion(invalidVersion), endVersion(invalidVersion) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, restoreId, batchIndex, url, files, beginVersion, endVersion, ranges, reply, arena);
+	}
+};
+
+// Sent by the leader to a loader: send a loaded batch to appliers, where appliers[i] owns
+// [splitKeys[i-1], splitKeys[i]).
+struct RestoreSendMutationsRequest {
+	constexpr static FileIdentifier file_identifier = 15092337;
+	Arena arena;
+	UID restoreId;
+	int batchIndex;
+	VectorRef<KeyRef> splitKeys;
+	std::vector<RestoreInterface> appliers;
+	ReplyPromise<Void> reply;
+
+	RestoreSendMutationsRequest() : batchIndex(0) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, restoreId, batchIndex, splitKeys, appliers, reply, arena);
+	}
+};
+
+// Sent by a loader to an applier.
+struct RestoreApplierMutationsRequest {
+	constexpr static FileIdentifier file_identifier = 3527741;
+	Arena arena;
+	UID restoreId;
+	int batchIndex;
+	VersionedMutationsRef mutations;
+	ReplyPromise<Void> reply;
+
+	RestoreApplierMutationsRequest() : batchIndex(0) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, restoreId, batchIndex, mutations, reply, arena);
+	}
+};
+
+// Sent by the leader to an applier once every loader has sent the batch and the previous batch has been applied.
+struct RestoreApplyRequest {
+	constexpr static FileIdentifier file_identifier = 9914086;
+	UID restoreId;
+	int batchIndex;
+	ReplyPromise<Void> reply;
+
+	RestoreApplyRequest() : batchIndex(0) {}
+	RestoreApplyRequest(UID restoreId, int batchIndex) : restoreId(restoreId), batchIndex(batchIndex) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, restoreId, batchIndex, reply);
+	}
+};
+
+// Stored in restoreRequestKey.  The destination ranges must be empty; a targetVersion of invalidVersion restores to
+// the latest restorable version.
+struct RestoreRequest {
+	constexpr static FileIdentifier file_identifier = 12466925;
+	UID randomUid;
+	Key url;
+	Version targetVersion;
+	Standalone<VectorRef<KeyRangeRef>> ranges;
+
+	RestoreRequest() : targetVersion(invalidVersion) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, randomUid, url, targetVersion, ranges);
+	}
+};
+
+// Stored in restoreRequestDoneKey.  errorCode is 0 if the restore succeeded.
+struct RestoreRequestResult {
+	constexpr static FileIdentifier file_identifier = 6370412;
+	UID randomUid;
+	Version restoredVersion;
+	int64_t bytes;
+	double elapsed;
+	int errorCode;
+
+	RestoreRequestResult() : restoredVersion(invalidVersion), bytes(0), elapsed(0), errorCode(0) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, randomUid, restoredVersion, bytes, elapsed, errorCode);
 	}
 };
 
 Future<Void> restoreWorker(Reference<ClusterConnectionFile> const& ccf, LocalityData const& locality);
 
+// Runs a restore worker using cx, electing a leader among the workers registered in the database.
+Future<Void> runRestoreWorker(Database const& cx);
+
+// Submits a request to the restore workers of cx and waits for its outcome.
+Future<RestoreRequestResult> submitParallelRestore(Database const& cx, RestoreRequest const& request);
+
 #endif
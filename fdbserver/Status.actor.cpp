@@ -401,6 +401,19 @@ struct RolesInfo {
 		return latency;
 	}
 
+	// Reads the details logged by LatencyHistogram::logToTraceEvent for the histogram with the given name
+	JsonBuilderObject addLatencyHistogramInfo(TraceEventFields const& metrics, std::string const& name) {
+		JsonBuilderObject latency;
+		latency.setKeyRawNumber("count", metrics.getValue(name + "Count"));
+		latency.setKeyRawNumber("mean", metrics.getValue(name + "Mean"));
+		latency.setKeyRawNumber("median", metrics.getValue(name + "Median"));
+		latency.setKeyRawNumber("p90", metrics.getValue(name + "P90"));
+		latency.setKeyRawNumber("p99", metrics.getValue(name + "P99"));
+		latency.setKeyRawNumber("p99.9", metrics.getValue(name + "P99.9"));
+		latency.setKeyRawNumber("max", metrics.getValue(name + "Max"));
+		return latency;
+	}
+
 	JsonBuilderObject& addRole( NetworkAddress address, std::string const& role, UID id) {
 		JsonBuilderObject obj;
 		obj["id"] = id.shortString();
@@ -517,6 +530,25 @@ struct RolesInfo {
 			if(commitLatencyMetrics.size()) {
 				obj["commit_latency_bands"] = addLatencyBandInfo(commitLatencyMetrics);
 			}
+
+			TraceEventFields const& commitStageLatencyMetrics = metrics.at("CommitStageLatencyMetrics");
+			if(commitStageLatencyMetrics.size()) {
+				JsonBuilderObject stages;
+				stages["batching"] = addLatencyHistogramInfo(commitStageLatencyMetrics, "Batching");
+				stages["get_commit_version"] = addLatencyHistogramInfo(commitStageLatencyMetrics, "GetCommitVersion");
+				stages["resolution"] = addLatencyHistogramInfo(commitStageLatencyMetrics, "Resolution");
+				stages["logging"] = addLatencyHistogramInfo(commitStageLatencyMetrics, "Logging");
+				stages["reply"] = addLatencyHistogramInfo(commitStageLatencyMetrics, "Reply");
+				obj["commit_stage_latency"] = stages;
+			}
+
+			TraceEventFields const& grvStageLatencyMetrics = metrics.at("GRVStageLatencyMetrics");
+			if(grvStageLatencyMetrics.size()) {
+				JsonBuilderObject stages;
+				stages["total"] = addLatencyHistogramInfo(grvStageLatencyMetrics, "Total");
+				stages["get_live_committed_version"] = addLatencyHistogramInfo(grvStageLatencyMetrics, "GetLiveCommittedVersion");
+				obj["grv_stage_latency"] = stages;
+			}
 		} catch (Error &e) {
 			if(e.code() != error_code_attribute_not_found) {
 				throw e;
@@ -1169,6 +1201,7 @@ ACTOR static Future<JsonBuilderObject> dataStatusFetcher(WorkerDetails ddWorker,
 		futures.push_back(timeoutError(ddWorker.interf.eventLogRequest.getReply(EventLogRequest(LiteralStringRef("MovingData"))), 1.0));
 		futures.push_back(timeoutError(ddWorker.interf.eventLogRequest.getReply(EventLogRequest(LiteralStringRef("TotalDataInFlight"))), 1.0));
 		futures.push_back(timeoutError(ddWorker.interf.eventLogRequest.getReply(EventLogRequest(LiteralStringRef("TotalDataInFlightRemote"))), 1.0));
+		futures.push_back(timeoutError(ddWorker.interf.eventLogRequest.getReply(EventLogRequest(LiteralStringRef("DDTrackerReadHotShards"))), 1.0));
 
 		std::vector<TraceEventFields> dataInfo = wait(getAll(futures));
 
@@ -1214,6 +1247,21 @@ ACTOR static Future<JsonBuilderObject> dataStatusFetcher(WorkerDetails ddWorker,
 			statusObjData.setKeyRawNumber("partitions_count",dataStats.getValue("Shards"));
 		}
 
+		TraceEventFields readHotStats = dataInfo[5];
+		if (readHotStats.size())
+		{
+			JsonBuilderArray readHotShards;
+			int logged = readHotStats.getInt("Logged");
+			for(int i = 0; i < logged; i++) {
+				JsonBuilderObject shard;
+				shard["begin"] = readHotStats.getValue(format("Shard%dBegin", i));
+				shard["end"] = readHotStats.getValue(format("Shard%dEnd", i));
+				shard["read_bytes_per_second"] = readHotStats.getInt64(format("Shard%dBytesReadPerKSec", i)) / 1000;
+				readHotShards.push_back(shard);
+			}
+			statusObjData["read_hot_partitions"] = readHotShards;
+		}
+
 		JsonBuilderArray teamTrackers;
 		for(int i = 0; i < 2; i++) {
 			TraceEventFields inFlight = dataInfo[3 + i];
@@ -1371,7 +1419,7 @@ ACTOR static Future<vector<std::pair<MasterProxyInterface, EventMap>>> getProxie
 	}
 
 	vector<std::pair<MasterProxyInterface, EventMap>> results = wait(getServerMetrics(servers, address_workers, 
-		std::vector<std::string>{ "GRVLatencyMetrics", "CommitLatencyMetrics" }));
+		std::vector<std::string>{ "GRVLatencyMetrics", "CommitLatencyMetrics", "CommitStageLatencyMetrics", "GRVStageLatencyMetrics" }));
 
 	return results;
 }
@@ -1502,6 +1550,23 @@ ACTOR static Future<JsonBuilderObject> workloadStatusFetcher(Reference<AsyncVar<
 		incomplete_reasons->insert("Unknown mutations, conflicts, and transactions state.");
 	}
 
+	// Resolver load balance
+	try {
+		TraceEventFields md = wait( timeoutError(mWorker.interf.eventLogRequest.getReply( EventLogRequest( LiteralStringRef("ResolverLoads") ) ), 1.0) );
+		if(md.size()) {
+			JsonBuilderObject resolution;
+			resolution["resolvers"] = md.getInt("Resolvers");
+			resolution["load_skew"] = md.getDouble("Skew");
+			resolution["ranges_moved"] = md.getInt64("RangesMoved");
+			statusObj["resolution"] = resolution;
+		}
+	}
+	catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled)
+			throw;
+		incomplete_reasons->insert("Unknown resolver load balance.");
+	}
+
 	// Transactions
 	try {
 		state TraceEventFields ratekeeper = wait( timeoutError(rkWorker.interf.eventLogRequest.getReply( EventLogRequest(LiteralStringRef("RkUpdate") ) ), 1.0) );
@@ -185,9 +185,11 @@ struct StorageServerMetrics {
 	KeyRangeMap< vector< PromiseStream< StorageMetrics > > > waitMetricsMap;
 	StorageMetricSample byteSample;
 	TransientStorageMetricSample iopsSample, bandwidthSample;	// FIXME: iops and bandwidth calculations are not effectively tested, since they aren't currently used by data distribution
+	TransientStorageMetricSample bytesReadSample;	// Bytes returned by getValue/getKeyValues, used by data distribution to find read-hot shards
 
 	StorageServerMetrics()
-		: byteSample( 0 ), iopsSample( SERVER_KNOBS->IOPS_UNITS_PER_SAMPLE ), bandwidthSample( SERVER_KNOBS->BANDWIDTH_UNITS_PER_SAMPLE )
+		: byteSample( 0 ), iopsSample( SERVER_KNOBS->IOPS_UNITS_PER_SAMPLE ), bandwidthSample( SERVER_KNOBS->BANDWIDTH_UNITS_PER_SAMPLE ),
+		  bytesReadSample( SERVER_KNOBS->BYTES_READ_UNITS_PER_SAMPLE )
 	{
 	}
 
@@ -197,6 +199,7 @@ struct StorageServerMetrics {
 		result.bytes = byteSample.getEstimate( keys );
 		result.bytesPerKSecond = bandwidthSample.getEstimate( keys ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 		result.iosPerKSecond = iopsSample.getEstimate( keys ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
+		result.bytesReadPerKSecond = bytesReadSample.getEstimate( keys ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 		return result;
 	}
 
@@ -206,6 +209,7 @@ struct StorageServerMetrics {
 		ASSERT (metrics.bytes == 0); // ShardNotifyMetrics
 		TEST (metrics.bytesPerKSecond != 0); // ShardNotifyMetrics
 		TEST (metrics.iosPerKSecond != 0); // ShardNotifyMetrics
+		TEST (metrics.bytesReadPerKSecond != 0); // ShardNotifyMetrics
 
 		double expire = now() + SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL;
 
@@ -215,6 +219,8 @@ struct StorageServerMetrics {
 			notifyMetrics.bytesPerKSecond = bandwidthSample.addAndExpire( key, metrics.bytesPerKSecond, expire ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 		if (metrics.iosPerKSecond)
 			notifyMetrics.iosPerKSecond = iopsSample.addAndExpire( key, metrics.iosPerKSecond, expire ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
+		if (metrics.bytesReadPerKSecond)
+			notifyMetrics.bytesReadPerKSecond = bytesReadSample.addAndExpire( key, metrics.bytesReadPerKSecond, expire ) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 		if (!notifyMetrics.allZero()) {
 			auto& v = waitMetricsMap[key];
 			for(int i=0; i<v.size(); i++) {
@@ -263,6 +269,7 @@ struct StorageServerMetrics {
 	void poll() {
 		{ StorageMetrics m; m.bytesPerKSecond = SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS; bandwidthSample.poll(waitMetricsMap, m); }
 		{ StorageMetrics m; m.iosPerKSecond = SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS; iopsSample.poll(waitMetricsMap, m); }
+		{ StorageMetrics m; m.bytesReadPerKSecond = SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS; bytesReadSample.poll(waitMetricsMap, m); }
 		// bytesSample doesn't need polling because we never call addExpire() on it
 	}
 
@@ -313,7 +320,7 @@ struct StorageServerMetrics {
 				if( remaining.bytes < 2*SERVER_KNOBS->MIN_SHARD_BYTES )
 					break;
 				KeyRef key = req.keys.end;
-				bool hasUsed = used.bytes != 0 || used.bytesPerKSecond != 0 || used.iosPerKSecond != 0;
+				bool hasUsed = used.bytes != 0 || used.bytesPerKSecond != 0 || used.iosPerKSecond != 0 || used.bytesReadPerKSecond != 0;
 				key = getSplitKey( remaining.bytes, estimated.bytes, req.limits.bytes, used.bytes, 
 					req.limits.infinity, req.isLastShard, byteSample, 1, lastKey, key, hasUsed );
 				if( used.bytes < SERVER_KNOBS->MIN_SHARD_BYTES )
@@ -322,6 +329,8 @@ struct StorageServerMetrics {
 					req.limits.infinity, req.isLastShard, iopsSample, SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS, lastKey, key, hasUsed );
 				key = getSplitKey( remaining.bytesPerKSecond, estimated.bytesPerKSecond, req.limits.bytesPerKSecond, used.bytesPerKSecond, 
 					req.limits.infinity, req.isLastShard, bandwidthSample, SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS, lastKey, key, hasUsed );
+				key = getSplitKey( remaining.bytesReadPerKSecond, estimated.bytesReadPerKSecond, req.limits.bytesReadPerKSecond, used.bytesReadPerKSecond,
+					req.limits.infinity, req.isLastShard, bytesReadSample, SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS, lastKey, key, hasUsed );
 				ASSERT( key != lastKey || hasUsed);
 				if( key == req.keys.end )
 					break;
@@ -358,10 +367,12 @@ struct StorageServerMetrics {
 		rep.free.bytes = sb.free;
 		rep.free.iosPerKSecond = 10e6;
 		rep.free.bytesPerKSecond = 100e9;
+		rep.free.bytesReadPerKSecond = 100e9;
 
 		rep.capacity.bytes = sb.total;
 		rep.capacity.iosPerKSecond = 10e6;
 		rep.capacity.bytesPerKSecond = 100e9;
+		rep.capacity.bytesReadPerKSecond = 100e9;
 
 		req.reply.send(rep);
 	}
@@ -1124,18 +1124,13 @@ void commitMessages( TLogData* self, Reference<LogData> logData, Version version
 void commitMessages( TLogData *self, Reference<LogData> logData, Version version, Arena arena, StringRef messages ) {
 	ArenaReader rd( arena, messages, Unversioned() );
 	int32_t messageLength, rawLength;
-	uint16_t tagCount;
 	uint32_t sub;
 	std::vector<TagsAndMessage> msgs;
 	while(!rd.empty()) {
 		TagsAndMessage tagsAndMsg;
 		rd.checkpoint();
-		rd >> messageLength >> sub >> tagCount;
-		tagsAndMsg.tags.resize(tagCount);
-		for(int i = 0; i < tagCount; i++) {
-			rd >> tagsAndMsg.tags[i];
-		}
-		rawLength = messageLength + sizeof(messageLength);
+		messageLength = readTLogMessageHeader(rd, sub, tagsAndMsg.tags);
+		rawLength = sizeof(TLogMessageHeader) + tagsAndMsg.tags.size()*sizeof(Tag) + messageLength;
 		rd.rewind();
 		tagsAndMsg.message = StringRef((uint8_t const*)rd.readBytes(rawLength), rawLength);
 		msgs.push_back(std::move(tagsAndMsg));
@@ -2972,3 +2967,42 @@ TEST_CASE("/fdbserver/tlogserver/VersionMessagesOverheadFactor" ) {
 
 	return Void();
 }
+
+TEST_CASE("/fdbserver/tlogserver/MessageFraming" ) {
+	// Framed messages must match the field by field encoding and parse back to the same tags and message
+	Arena arena;
+	MutationRef m(MutationRef::SetValue, LiteralStringRef("key"), LiteralStringRef("value"));
+	std::vector<Tag> tags;
+	int tagCount = deterministicRandom()->randomInt(0, 10);
+	for(int i = 0; i < tagCount; i++)
+		tags.push_back(Tag(deterministicRandom()->randomInt(-3, 3), deterministicRandom()->randomInt(0, 60000)));
+	uint32_t subsequence = deterministicRandom()->randomInt(1, 1000000);
+
+	BinaryWriter expected(AssumeVersion(currentProtocolVersion));
+	BinaryWriter body(AssumeVersion(currentProtocolVersion));
+	body << m;
+	expected << uint32_t(body.getLength() + sizeof(subsequence) + sizeof(uint16_t) + sizeof(Tag)*tags.size()) << subsequence << uint16_t(tags.size());
+	for(auto& tag : tags)
+		expected << tag;
+	expected << m;
+
+	BinaryWriter wr(AssumeVersion(currentProtocolVersion));
+	wr << uint32_t(12345);  // Framing must work at any offset
+	StringRef framed = writeTLogMessage(wr, subsequence, tags, m);
+	ASSERT(framed == expected.toValue());
+
+	Standalone<StringRef> messages = wr.toValue();
+	ArenaReader rd(messages.arena(), messages.substr(sizeof(uint32_t)), AssumeVersion(currentProtocolVersion));
+	uint32_t readSubsequence;
+	std::vector<Tag> readTags;
+	int32_t messageLength = readTLogMessageHeader(rd, readSubsequence, readTags);
+	ASSERT(readSubsequence == subsequence);
+	ASSERT(readTags == tags);
+	ASSERT(messageLength == body.getLength());
+	MutationRef readMutation;
+	rd >> readMutation;
+	ASSERT(readMutation.type == m.type && readMutation.param1 == m.param1 && readMutation.param2 == m.param2);
+	ASSERT(rd.empty());
+
+	return Void();
+}
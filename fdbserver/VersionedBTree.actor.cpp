@@ -27,6 +27,7 @@
 #include "flow/UnitTest.h"
 #include "fdbserver/MemoryPager.h"
 #include "fdbserver/IndirectShadowPager.h"
+#include "fdbserver/Knobs.h"
 #include <map>
 #include <vector>
 #include "fdbclient/CommitTransaction.h"
@@ -406,7 +407,8 @@ struct RedwoodRecordRef {
 		// If has value and value is not 4 bytes
 		//    1 byte value length
 		//
-		// 1 or 2 bytes for Prefix Borrow Length (hi bit indicates presence of second byte)
+		// 1 or 2 bytes for Prefix Borrow Length (hi bit indicates presence of second byte), not counting the
+		// key prefix shared by every record in the page, whose length is in the page header
 		//
 		// IF has_key_suffix is set
 		//    1 or 2 bytes for Key Suffix Length
@@ -453,11 +455,11 @@ struct RedwoodRecordRef {
 			return flags & PREFIX_SOURCE;
 		}
 
-		RedwoodRecordRef apply(const RedwoodRecordRef &base, Arena &arena) const {
+		RedwoodRecordRef apply(const RedwoodRecordRef &base, int sharedPrefixLen, Arena &arena) const {
 			Reader r(data());
 
 			int intFieldSuffixLen = flags & INT_FIELD_SUFFIX_BITS;
-			int prefixLen = r.readVarInt();
+			int prefixLen = sharedPrefixLen + r.readVarInt();
 			int valueLen = (flags & HAS_VALUE) ? r.read<uint8_t>() : 0;
 
 			StringRef k;
@@ -588,7 +590,7 @@ struct RedwoodRecordRef {
 		return compare(rhs) >= 0;
 	}
 
-	int deltaSize(const RedwoodRecordRef &base, bool worstCase = true) const {
+	int deltaSize(const RedwoodRecordRef &base, bool worstCase = true, int sharedPrefixLen = 0) const {
 		int size = sizeof(Delta);
 
 		if(value.present()) {
@@ -597,7 +599,7 @@ struct RedwoodRecordRef {
 		}
 
 		int prefixLen = getCommonPrefixLen(base, 0);
-		size += (worstCase || prefixLen >= 128) ? 2 : 1;
+		size += (worstCase || prefixLen - sharedPrefixLen >= 128) ? 2 : 1;
 
 		int intFieldPrefixLen;
 
@@ -637,18 +639,20 @@ struct RedwoodRecordRef {
 		return size;
 	}
 
-	// commonPrefix between *this and base can be passed if known
-	int writeDelta(Delta &d, const RedwoodRecordRef &base, int commonPrefix = -1) const {
+	// commonPrefix between *this and base can be passed if known.  *this and base must have at least sharedPrefixLen
+	// bytes of their keys in common.
+	int writeDelta(Delta &d, const RedwoodRecordRef &base, int commonPrefix = -1, int sharedPrefixLen = 0) const {
 		d.flags = version == 0 ? 0 : Delta::HAS_VERSION;
 
 		if(commonPrefix < 0) {
 			commonPrefix = getCommonPrefixLen(base, 0);
 		}
+		ASSERT(commonPrefix >= sharedPrefixLen);
 
 		Writer w(d.data());
 
 		// prefixLen
-		w.writeVarInt(commonPrefix);
+		w.writeVarInt(commonPrefix - sharedPrefixLen);
 
 		// valueLen
 		if(value.present()) {
@@ -744,6 +748,9 @@ struct BTreePage {
 		uint16_t count;
 		uint32_t kvBytes;
 		uint8_t extensionPageCount;
+		// Length of the key prefix shared by every record in the page and by its bounds, which the tree's
+		// deltas do not count in their prefix lengths
+		uint16_t sharedPrefixLen;
 	};
 #pragma pack(pop)
 
@@ -778,13 +785,13 @@ struct BTreePage {
 
 	std::string toString(bool write, LogicalPageID id, Version ver, const RedwoodRecordRef *lowerBound, const RedwoodRecordRef *upperBound) const {
 		std::string r;
-		r += format("BTreePage op=%s id=%d ver=%" PRId64 " ptr=%p flags=0x%X count=%d kvBytes=%d extPages=%d\n  lowerBound: %s\n  upperBound: %s\n",
-					write ? "write" : "read", id, ver, this, (int)flags, (int)count, (int)kvBytes, (int)extensionPageCount,
+		r += format("BTreePage op=%s id=%d ver=%" PRId64 " ptr=%p flags=0x%X count=%d kvBytes=%d extPages=%d sharedPrefixLen=%d\n  lowerBound: %s\n  upperBound: %s\n",
+					write ? "write" : "read", id, ver, this, (int)flags, (int)count, (int)kvBytes, (int)extensionPageCount, (int)sharedPrefixLen,
 					lowerBound->toString().c_str(), upperBound->toString().c_str());
 		try {
 			if(count > 0) {
 				// This doesn't use the cached reader for the page but it is only for debugging purposes
-				BinaryTree::Reader reader(&tree(), lowerBound, upperBound);
+				BinaryTree::Reader reader(&tree(), lowerBound, upperBound, sharedPrefixLen);
 				BinaryTree::Cursor c = reader.getCursor();
 
 				c.moveFirst();
@@ -828,6 +835,7 @@ static void makeEmptyPage(Reference<IPage> page, uint8_t newFlags, int pageSize)
 	btpage->kvBytes = 0;
 	btpage->count = 0;
 	btpage->extensionPageCount = 0;
+	btpage->sharedPrefixLen = 0;
 	btpage->tree().build(nullptr, nullptr, nullptr, nullptr);
 }
 
@@ -858,6 +866,9 @@ static std::vector<BoundaryAndPage> buildPages(bool minimalBoundaries, const Red
 	int kvBytes = 0;
 	int compressedBytes = BTreePage::BinaryTree::GetTreeOverhead();
 
+	// Each page's tree is built here first, since it may not fit in the page (see below)
+	std::vector<uint8_t> treeScratch;
+
 	int start = 0;
 	int i = 0;
 	const int iEnd = entries.size();
@@ -874,9 +885,11 @@ static std::vector<BoundaryAndPage> buildPages(bool minimalBoundaries, const Red
 			pageUpperBound = upperBound.withoutValue();
 		}
 		else {
-			// Get delta from previous record
+			// Get delta from previous record.  Its prefix length is counted from the prefix that it shares with the
+			// page's lower bound, which is as long as the page's shared prefix can be if the record is added.
 			const RedwoodRecordRef &entry = entries[i];
-			int deltaSize = entry.deltaSize((i == start) ? pageLowerBound : entries[i - 1]);
+			int sharedPrefixLen = commonPrefixLength(pageLowerBound.key, entry.key);
+			int deltaSize = entry.deltaSize((i == start) ? pageLowerBound : entries[i - 1], false, sharedPrefixLen);
 			int keySize = entry.key.size();
 			int valueSize = entry.value.present() ? entry.value.get().size() : 0;
 
@@ -931,13 +944,56 @@ static std::vector<BoundaryAndPage> buildPages(bool minimalBoundaries, const Red
 			// If not writing the final page, reduce entry count of page by a third
 			if(!end) {
 				i -= count / 3;
-				pageUpperBound = entries[i].withoutValue();
 			}
 
-			// If this isn't the final page, shorten the upper boundary
-			if(!end && minimalBoundaries) {
-				int commonPrefix = pageUpperBound.getCommonPrefixLen(entries[i - 1], 0);
-				pageUpperBound.truncate(commonPrefix + 1);
+			// Records were sized exactly against their neighbors, but the tree may encode a record against a more
+			// distant ancestor, and the page's shared prefix may be shorter than the one a record was sized with.  So
+			// the tree is built in scratch space, and records are given back until it fits in the page.
+			int sharedPrefixLen;
+			int written;
+			while(true) {
+				if(!end) {
+					pageUpperBound = entries[i].withoutValue();
+
+					// If this isn't the final page, shorten the upper boundary
+					if(minimalBoundaries) {
+						int commonPrefix = pageUpperBound.getCommonPrefixLen(entries[i - 1], 0);
+						pageUpperBound.truncate(commonPrefix + 1);
+					}
+				}
+
+				// The records are sorted, so they and the bounds share the prefix that the bounds and the first and
+				// last records share.  It is stored once in the page header rather than counted in every delta.
+				sharedPrefixLen = commonPrefixLength(pageLowerBound.key, pageUpperBound.key);
+				if(i > start) {
+					sharedPrefixLen = std::min(sharedPrefixLen, commonPrefixLength(pageLowerBound.key, entries[start].key));
+					sharedPrefixLen = std::min(sharedPrefixLen, commonPrefixLength(entries[start].key, entries[i - 1].key));
+				}
+				sharedPrefixLen = std::min<int>(sharedPrefixLen, std::numeric_limits<uint16_t>::max());
+
+				// No delta is larger than its record encoded against an empty key with all of its int fields
+				int maxTreeSize = BTreePage::BinaryTree::GetTreeOverhead(i - start);
+				for(int j = start; j < i; ++j) {
+					maxTreeSize += entries[j].deltaSize(RedwoodRecordRef(), true) + RedwoodRecordRef::intFieldArraySize;
+				}
+				if(treeScratch.size() < (size_t)maxTreeSize) {
+					treeScratch.resize(maxTreeSize);
+				}
+
+				written = ((BTreePage::BinaryTree *)treeScratch.data())->build(&entries[start], &entries[i], &pageLowerBound, &pageUpperBound, sharedPrefixLen);
+				if(written <= pageSize) {
+					break;
+				}
+
+				debug_printf("Tree of %d records is %d bytes, more than the %d byte page, giving back a record\n", i - start, written, pageSize);
+				ASSERT(i - start > 1);
+				--i;
+				end = false;
+			}
+
+			kvBytes = 0;
+			for(int j = start; j < i; ++j) {
+				kvBytes += entries[j].key.size() + (entries[j].value.present() ? entries[j].value.get().size() : 0);
 			}
 
 			debug_printf("Flushing page start=%d i=%d count=%d\nlower: %s\nupper: %s\n", start, i, count, pageLowerBound.toString().c_str(), pageUpperBound.toString().c_str());
@@ -976,11 +1032,8 @@ static std::vector<BoundaryAndPage> buildPages(bool minimalBoundaries, const Red
 			btPage->count = i - start;
 			btPage->extensionPageCount = blockCount - 1;
 
-			int written = btPage->tree().build(&entries[start], &entries[i], &pageLowerBound, &pageUpperBound);
-			if(written > pageSize) {
-				fprintf(stderr, "ERROR:  Wrote %d bytes to %d byte page (%d blocks). recs %d  kvBytes %d  compressed %d\n", written, pageSize, blockCount, i - start, kvBytes, compressedBytes);
-				ASSERT(false);
-			}
+			btPage->sharedPrefixLen = sharedPrefixLen;
+			memcpy(&btPage->tree(), treeScratch.data(), written);
 
 			if(blockCount != 1) {
 				Reference<IPage> page = newBlockFn();
@@ -1690,6 +1743,10 @@ private:
 		++counts.pageReads;
 		state const BTreePage *pTreePage = (const BTreePage *)result->begin();
 
+		// Lets the pager's page cache keep internal pages in preference to leaves
+		state int level = pTreePage->isLeaf() ? 0 : 1;
+		result->level = level;
+
 		if(pTreePage->extensionPageCount == 0) {
 			debug_printf("readPage() Found normal page for op=read id=%u @%" PRId64 "\n", id, snapshot->getVersion());
 		}
@@ -1703,6 +1760,9 @@ private:
 			}
 
 			std::vector<Reference<const IPage>> pages = wait(getAll(pageGets));
+			for(auto &p : pages) {
+				p->level = level;
+			}
 			counts.extPageReads += pTreePage->extensionPageCount;
 			result = Reference<const IPage>(new SuperPage(pages, usablePageSize));
 			pTreePage = (const BTreePage *)result->begin();
@@ -1710,7 +1770,7 @@ private:
 
 		if(result->userData == nullptr) {
 			debug_printf("readPage() Creating Reader for PageID=%u @%" PRId64 " lower=%s upper=%s\n", id, snapshot->getVersion(), lowerBound->toString().c_str(), upperBound->toString().c_str());
-			result->userData = new BTreePage::BinaryTree::Reader(&pTreePage->tree(), lowerBound, upperBound);
+			result->userData = new BTreePage::BinaryTree::Reader(&pTreePage->tree(), lowerBound, upperBound, pTreePage->sharedPrefixLen);
 			result->userDataDestructor = [](void *ptr) { delete (BTreePage::BinaryTree::Reader *)ptr; };
 		}
 
@@ -2755,7 +2815,7 @@ class KeyValueStoreRedwoodUnversioned : public IKeyValueStore {
 public:
 	KeyValueStoreRedwoodUnversioned(std::string filePrefix, UID logID) : m_filePrefix(filePrefix) {
 		// TODO: This constructor should really just take an IVersionedStore
-		IPager *pager = new IndirectShadowPager(filePrefix);
+		IPager *pager = new IndirectShadowPager(filePrefix, SERVER_KNOBS->PAGER_MMAP_READS);
 		m_tree = new VersionedBTree(pager, filePrefix, true, pager->getUsablePageSize());
 		m_init = catchError(init_impl(this));
 	}
@@ -3228,7 +3288,7 @@ struct IntIntPair {
 		int dk;
 		int dv;
 
-		IntIntPair apply(const IntIntPair &base, Arena &arena) {
+		IntIntPair apply(const IntIntPair &base, int sharedPrefixLen, Arena &arena) {
 			return {base.k + dk, base.v + dv};
 		}
 
@@ -3266,7 +3326,7 @@ struct IntIntPair {
 		return sizeof(Delta);
 	}
 
-	int writeDelta(Delta &d, const IntIntPair &base, int commonPrefix = -1) const {
+	int writeDelta(Delta &d, const IntIntPair &base, int commonPrefix = -1, int sharedPrefixLen = 0) const {
 		d.dk = k - base.k;
 		d.dv = v - base.v;
 		return sizeof(Delta);
@@ -3303,14 +3363,18 @@ void deltaTest(RedwoodRecordRef rec, RedwoodRecordRef base) {
 	char buf[500];
 	RedwoodRecordRef::Delta &d = *(RedwoodRecordRef::Delta *)buf;
 
+	// Any of the key bytes that rec and base have in common can be left out of the delta's prefix length
+	int sharedPrefixLen = deterministicRandom()->randomInt(0, commonPrefixLength(rec.key, base.key) + 1);
+
 	Arena mem;
-	int expectedSize = rec.deltaSize(base, false);
-	int deltaSize = rec.writeDelta(d, base);
-	RedwoodRecordRef decoded = d.apply(base, mem);
+	int expectedSize = rec.deltaSize(base, false, sharedPrefixLen);
+	int deltaSize = rec.writeDelta(d, base, -1, sharedPrefixLen);
+	RedwoodRecordRef decoded = d.apply(base, sharedPrefixLen, mem);
 
 	if(decoded != rec || expectedSize != deltaSize) {
 		printf("\n");
 		printf("Base:         %s\n", base.toString().c_str());
+		printf("SharedPrefix: %d\n", sharedPrefixLen);
 		printf("ExpectedSize: %d\n", expectedSize);
 		printf("DeltaSize:    %d\n", deltaSize);
 		printf("Delta:        %s\n", d.toString().c_str());
@@ -3612,6 +3676,109 @@ TEST_CASE("!/redwood/correctness/unit/deltaTree/RedwoodRecordRef") {
 	return Void();
 }
 
+// Records under a long common key prefix, as in deeply nested subspaces, take less space when the tree is built with
+// the length of the prefix that they share with its bounds
+TEST_CASE("!/redwood/correctness/unit/deltaTree/RedwoodRecordRef/sharedPrefix") {
+	const int N = 200;
+	const int prefixLen = 200;
+
+	Arena arena;
+	StringRef prefix(arena, deterministicRandom()->randomAlphaNumeric(prefixLen));
+	RedwoodRecordRef prev(prefix);
+	RedwoodRecordRef next(prefix.withSuffix(LiteralStringRef("\xff\xff\xff\xff"), arena));
+
+	std::vector<RedwoodRecordRef> items;
+	for(int i = 0; i < N; ++i) {
+		RedwoodRecordRef rec;
+		rec.key = prefix.withSuffix(StringRef(deterministicRandom()->randomAlphaNumeric(30)), arena);
+		rec.value = StringRef(arena, deterministicRandom()->randomAlphaNumeric(30));
+		items.push_back(rec);
+	}
+	std::sort(items.begin(), items.end());
+
+	DeltaTree<RedwoodRecordRef> *plain = (DeltaTree<RedwoodRecordRef> *) new uint8_t[N * 300];
+	DeltaTree<RedwoodRecordRef> *shared = (DeltaTree<RedwoodRecordRef> *) new uint8_t[N * 300];
+	int plainSize = plain->build(&items[0], &items[items.size()], &prev, &next);
+	int sharedSize = shared->build(&items[0], &items[items.size()], &prev, &next, prefixLen);
+
+	printf("Count=%d  Size=%d  SizeWithSharedPrefix=%d\n", (int)items.size(), plainSize, sharedSize);
+	ASSERT(sharedSize < plainSize);
+
+	DeltaTree<RedwoodRecordRef>::Reader r(shared, &prev, &next, prefixLen);
+	DeltaTree<RedwoodRecordRef>::Cursor c = r.getCursor();
+	ASSERT(c.moveFirst());
+	for(int i = 0; i < items.size(); ++i) {
+		ASSERT(c.valid());
+		if(!c.get().identical(items[i])) {
+			printf("i=%d\n  %s found\n  %s expected\n", i, c.get().toString().c_str(), items[i].toString().c_str());
+			ASSERT(false);
+		}
+		c.moveNext();
+	}
+	ASSERT(!c.valid());
+
+	for(auto &item : items) {
+		ASSERT(c.seekLessThanOrEqual(item) && c.get() == item);
+	}
+
+	delete [] (uint8_t *)plain;
+	delete [] (uint8_t *)shared;
+	return Void();
+}
+
+// Pages of records under a long common key prefix hold more records than buildPages put in them when it sized every
+// record with worst case varint lengths and no shared prefix
+TEST_CASE("!/redwood/correctness/unit/buildPages/sharedPrefix") {
+	state IPager *pager = createMemoryPager();
+
+	{
+		const int N = 10000;
+		int pageSize = pager->getUsablePageSize();
+
+		Arena arena;
+		StringRef prefix(arena, deterministicRandom()->randomAlphaNumeric(200));
+		RedwoodRecordRef lower(prefix);
+		RedwoodRecordRef upper(prefix.withSuffix(LiteralStringRef("\xff\xff\xff\xff"), arena));
+
+		std::vector<RedwoodRecordRef> entries;
+		for(int i = 0; i < N; ++i) {
+			RedwoodRecordRef rec;
+			rec.key = prefix.withSuffix(StringRef(format("%08d", i)), arena);
+			rec.value = StringRef(arena, deterministicRandom()->randomAlphaNumeric(8));
+			entries.push_back(rec);
+		}
+
+		IPager *p = pager;
+		std::vector<BoundaryAndPage> pages = buildPages(true, lower, upper, entries, BTreePage::IS_LEAF, [p](){ return p->newPageBuffer(); }, pageSize);
+		ASSERT(pages.size() > 1);
+
+		// Every page but the last is cut back by a third from the records that fit by estimate
+		int worstCaseBytes = 0;
+		for(int i = 0; i < N; ++i) {
+			worstCaseBytes += sizeof(BTreePage::BinaryTree::Node) + entries[i].deltaSize(i == 0 ? lower : entries[i - 1], true);
+		}
+		int worstCaseFit = (int64_t)(pageSize - BTreePage::GetHeaderSize() - BTreePage::BinaryTree::GetTreeOverhead()) * N / worstCaseBytes;
+		int worstCaseRecordsPerPage = worstCaseFit - worstCaseFit / 3;
+
+		int records = 0;
+		for(int i = 0; i + 1 < pages.size(); ++i) {
+			const BTreePage *btPage = (const BTreePage *)pages[i].firstPage->begin();
+			ASSERT(btPage->extensionPageCount == 0);
+			ASSERT(btPage->sharedPrefixLen >= prefix.size());
+			records += btPage->count;
+		}
+		int recordsPerPage = records / (pages.size() - 1);
+
+		printf("Pages=%d  RecordsPerPage=%d  WorstCaseRecordsPerPage=%d\n", (int)pages.size(), recordsPerPage, worstCaseRecordsPerPage);
+		ASSERT(recordsPerPage > worstCaseRecordsPerPage);
+	}
+
+	Future<Void> closedFuture = pager->onClosed();
+	pager->dispose();
+	wait(closedFuture);
+	return Void();
+}
+
 TEST_CASE("!/redwood/correctness/unit/deltaTree/IntIntPair") {
 	const int N = 200;
 	IntIntPair prev = {0, 0};
@@ -4047,3 +4214,119 @@ TEST_CASE("!/redwood/performance/set") {
 
 	return Void();
 }
+
+ACTOR Future<Void> sequentialScan(VersionedBTree *btree) {
+	state Version readVer = wait(btree->getLatestVersion());
+	state int64_t rows = 0;
+	state int64_t bytes = 0;
+	state double readStart = timer();
+	printf("Executing sequential scan\n");
+	state Reference<IStoreCursor> cur = btree->readAtVersion(readVer);
+	wait(cur->findFirstEqualOrGreater(LiteralStringRef(""), true, 0));
+	while(cur->isValid()) {
+		++rows;
+		bytes += cur->getKey().size() + cur->getValue().size();
+		wait(cur->next(true));
+	}
+	double elapsed = timer() - readStart;
+	printf("Sequential read speed %d rows/s, %.2f MB/s\n", int(rows / elapsed), bytes / elapsed / 1e6);
+	return Void();
+}
+
+// Creates a new tree in pagerFile holding kvBytesTarget bytes of random keys and values, and closes it
+ACTOR Future<Void> writeRandomTree(std::string pagerFile, bool singleVersion, int64_t kvBytesTarget) {
+	printf("Deleting old test data\n");
+	deleteFile(pagerFile);
+	deleteFile(pagerFile + "0.pagerlog");
+	deleteFile(pagerFile + "1.pagerlog");
+
+	state VersionedBTree *btree = new VersionedBTree(new IndirectShadowPager(pagerFile), pagerFile, singleVersion);
+	wait(btree->init());
+
+	state int64_t kvBytesTotal = 0;
+	state std::string value(100, 'v');
+	Version latestVersion = wait(btree->getLatestVersion());
+	state Version version = latestVersion;
+
+	printf("Writing %.2f MB of keyValue bytes\n", kvBytesTarget / 1e6);
+	while(kvBytesTotal < kvBytesTarget) {
+		btree->setWriteVersion(++version);
+		for(int i = 0; i < 100000; ++i) {
+			KeyValue kv;
+			kv.key = randomString(kv.arena(), deterministicRandom()->randomInt(10, 30), 'a', 'b');
+			kv.value = StringRef((uint8_t *)value.data(), deterministicRandom()->randomInt(0, value.size()));
+			btree->set(kv);
+			kvBytesTotal += kv.key.size() + kv.value.size();
+		}
+		wait(btree->commit());
+	}
+
+	state Future<Void> closedFuture = btree->onClosed();
+	btree->close();
+	wait(closedFuture);
+
+	return Void();
+}
+
+// Compares read throughput through the page file with read throughput through the page file mapping
+TEST_CASE("!/redwood/performance/read") {
+	state std::string pagerFile = "unittest_pageFile";
+	state bool singleVersion = true;
+	wait(writeRandomTree(pagerFile, singleVersion, 100e6));
+
+	state VersionedBTree *btree;
+	state Future<Void> closedFuture;
+	state int reads = 30000;
+	state int mmapReads = 0;
+	for(; mmapReads < 2; ++mmapReads) {
+		printf("Reading %s the page file mapping\n", mmapReads ? "through" : "without");
+		btree = new VersionedBTree(new IndirectShadowPager(pagerFile, mmapReads), pagerFile, singleVersion);
+		wait(btree->init());
+
+		wait(randomSeeks(btree, reads));
+		wait(randomSeeks(btree, reads));
+		wait(sequentialScan(btree));
+
+		closedFuture = btree->onClosed();
+		btree->close();
+		wait(closedFuture);
+	}
+
+	return Void();
+}
+
+// Compares random seek throughput while a sequential scan runs when internal pages share the page cache with leaf pages
+// and when they have their own share of it
+TEST_CASE("!/redwood/performance/mixed") {
+	state std::string pagerFile = "unittest_pageFile";
+	state bool singleVersion = true;
+	wait(writeRandomTree(pagerFile, singleVersion, 100e6));
+
+	state int cachePages = 10000;
+	state int reads = 30000;
+	state int internalCache = 0;
+	for(; internalCache < 2; ++internalCache) {
+		state IndirectShadowPager *pager = new IndirectShadowPager(pagerFile);
+		if(internalCache) {
+			pager->setPageCacheSizes(cachePages / 4, cachePages - cachePages / 4);
+		}
+		else {
+			pager->setPageCacheSizes(0, cachePages);
+		}
+		printf("Reading %s a separate internal page cache\n", internalCache ? "with" : "without");
+
+		state VersionedBTree *btree = new VersionedBTree(pager, pagerFile, singleVersion);
+		wait(btree->init());
+
+		wait(randomSeeks(btree, reads));
+		wait(randomSeeks(btree, reads) && sequentialScan(btree));
+		printf("Page cache hits %lld (%lld internal), misses %lld, evictions %lld\n", (long long)pager->pageCache.hits,
+		       (long long)pager->pageCache.internalHits, (long long)pager->pageCache.misses, (long long)pager->pageCache.evictions);
+
+		state Future<Void> closedFuture = btree->onClosed();
+		btree->close();
+		wait(closedFuture);
+	}
+
+	return Void();
+}
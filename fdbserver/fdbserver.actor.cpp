@@ -83,7 +83,7 @@
 
 enum {
 	OPT_CONNFILE, OPT_SEEDCONNFILE, OPT_SEEDCONNSTRING, OPT_ROLE, OPT_LISTEN, OPT_PUBLICADDR, OPT_DATAFOLDER, OPT_LOGFOLDER, OPT_PARENTPID, OPT_NEWCONSOLE, OPT_NOBOX, OPT_TESTFILE, OPT_RESTARTING, OPT_RESTORING, OPT_RANDOMSEED, OPT_KEY, OPT_MEMLIMIT, OPT_STORAGEMEMLIMIT, OPT_MACHINEID, OPT_DCID, OPT_MACHINE_CLASS, OPT_BUGGIFY, OPT_VERSION, OPT_CRASHONERROR, OPT_HELP, OPT_NETWORKIMPL, OPT_NOBUFSTDOUT, OPT_BUFSTDOUTERR, OPT_TRACECLOCK, OPT_NUMTESTERS, OPT_DEVHELP, OPT_ROLLSIZE, OPT_MAXLOGS, OPT_MAXLOGSSIZE, OPT_KNOB, OPT_TESTSERVERS, OPT_TEST_ON_SERVERS, OPT_METRICSCONNFILE, OPT_METRICSPREFIX,
-	OPT_LOGGROUP, OPT_LOCALITY, OPT_IO_TRUST_SECONDS, OPT_IO_TRUST_WARN_ONLY, OPT_FILESYSTEM, OPT_PROFILER_RSS_SIZE, OPT_KVFILE, OPT_TRACE_FORMAT, OPT_USE_OBJECT_SERIALIZER, OPT_WHITELIST_BINPATH };
+	OPT_LOGGROUP, OPT_LOCALITY, OPT_IO_TRUST_SECONDS, OPT_IO_TRUST_WARN_ONLY, OPT_FILESYSTEM, OPT_PROFILER_RSS_SIZE, OPT_KVFILE, OPT_TRACE_FORMAT, OPT_USE_OBJECT_SERIALIZER, OPT_WHITELIST_BINPATH, OPT_BLOB_CREDENTIALS };
 
 CSimpleOpt::SOption g_rgOptions[] = {
 	{ OPT_CONNFILE,              "-C",                          SO_REQ_SEP },
@@ -162,6 +162,7 @@ CSimpleOpt::SOption g_rgOptions[] = {
 	{ OPT_USE_OBJECT_SERIALIZER, "-S",                          SO_REQ_SEP },
 	{ OPT_USE_OBJECT_SERIALIZER, "--object-serializer",         SO_REQ_SEP },
 	{ OPT_WHITELIST_BINPATH,     "--whitelist_binpath",         SO_REQ_SEP },
+	{ OPT_BLOB_CREDENTIALS,      "--blob_credentials",          SO_REQ_SEP },
 
 #ifndef TLS_DISABLED
 	TLS_OPTION_FLAGS
@@ -582,6 +583,11 @@ static void printUsage( const char *name, bool devhelp ) {
 		   "                 Machine class (valid options are storage, transaction,\n"
 		   "                 resolution, proxy, master, test, unset, stateless, log, router,\n"
 		   "                 and cluster_controller).\n");
+	printf("  --blob_credentials FILE\n"
+		   "                 File containing blob credentials in JSON format, used when\n"
+		   "                 storage servers write backup range files to a blobstore://\n"
+		   "                 container. Can be specified multiple times. Files listed in\n"
+		   "                 the FDB_BLOB_CREDENTIALS environment variable are also used.\n");
 	printf("  -S ON|OFF, --object-serializer ON|OFF\n"
 		   "                 Use object serializer for sending messages. The object serializer\n"
 		   "                 is currently a beta feature and it allows fdb processes to talk to\n"
@@ -918,6 +924,7 @@ int main(int argc, char* argv[]) {
 		std::string kvFile;
 		std::string testServersStr;
 		std::string whitelistBinPaths;
+		std::vector<std::string> blobCredentials;
 		std::vector<std::string> publicAddressStrs, listenAddressStrs;
 		const char *targetKey = NULL;
 		uint64_t memLimit = 8LL << 30; // Nice to maintain the same default value for memLimit and SERVER_KNOBS->SERVER_MEM_LIMIT and SERVER_KNOBS->COMMIT_BATCHES_MEM_BYTES_HARD_LIMIT
@@ -1313,6 +1320,9 @@ int main(int argc, char* argv[]) {
 				case OPT_WHITELIST_BINPATH:
 					whitelistBinPaths = args.OptionArg();
 					break;
+				case OPT_BLOB_CREDENTIALS:
+					blobCredentials.push_back(args.OptionArg());
+					break;
 #ifndef TLS_DISABLED
 				case TLSOptions::OPT_TLS_PLUGIN:
 					args.OptionArg();
@@ -1543,6 +1553,23 @@ int main(int argc, char* argv[]) {
 
 			openTraceFile(publicAddresses.address, rollsize, maxLogsSize, logFolder, "trace", logGroup);
 
+			// Storage servers write backup range files to blob store containers, so they need the credentials for them
+			const char *blobCredsFromENV = getenv("FDB_BLOB_CREDENTIALS");
+			if(blobCredsFromENV != nullptr) {
+				StringRef t((uint8_t*)blobCredsFromENV, strlen(blobCredsFromENV));
+				do {
+					StringRef file = t.eat(":");
+					if(file.size() != 0)
+						blobCredentials.push_back(file.toString());
+				} while(t.size() != 0);
+			}
+			std::vector<std::string> *pFiles = (std::vector<std::string> *)g_network->global(INetwork::enBlobCredentialFiles);
+			if(pFiles != nullptr) {
+				for(auto &f : blobCredentials) {
+					pFiles->push_back(f);
+				}
+			}
+
 #ifndef TLS_DISABLED
 			if ( tlsCertPath.size() )
 				tlsOptions->set_cert_file( tlsCertPath );
@@ -180,6 +180,9 @@ struct MasterData : NonCopyable, ReferenceCounted<MasterData> {
 	Reference< ILogSystem > logSystem;
 	Version version;   // The last version assigned to a proxy by getVersion()
 	double lastVersionTime;
+	Version liveCommittedVersion; // The largest version any proxy has reported committed, with its locked state and metadata version
+	bool databaseLocked;
+	Optional<Value> proxyMetadataVersion;
 	LogSystemDiskQueueAdapter* txnStateLogAdapter;
 	IKeyValueStore* txnStateStore;
 	int64_t memoryLimit;
@@ -249,6 +252,8 @@ struct MasterData : NonCopyable, ReferenceCounted<MasterData> {
 		  registrationCount(0),
 		  version(invalidVersion),
 		  lastVersionTime(0),
+		  liveCommittedVersion(invalidVersion),
+		  databaseLocked(false),
 		  txnStateStore(0),
 		  memoryLimit(2e9),
 		  addActor(addActor),
@@ -960,6 +965,38 @@ ACTOR Future<Void> provideVersions(Reference<MasterData> self) {
 	}
 }
 
+// Proxies report every version they commit before replying to the clients, so the largest reported version is at least
+// as large as any version a client has been told is committed.  Proxies ask for it to give out read versions without
+// asking every other proxy.
+ACTOR Future<Void> serveLiveCommittedVersion(Reference<MasterData> self) {
+	if(self->liveCommittedVersion == invalidVersion) {
+		self->liveCommittedVersion = self->recoveryTransactionVersion;
+	}
+
+	loop {
+		choose {
+			when(GetRawCommittedVersionRequest req = waitNext(self->myInterface.getLiveCommittedVersion.getFuture())) {
+				if (req.debugID.present())
+					g_traceBatch.addEvent("TransactionDebug", req.debugID.get().first(), "MasterServer.serveLiveCommittedVersion.GetRawCommittedVersion");
+
+				GetReadVersionReply reply;
+				reply.version = self->liveCommittedVersion;
+				reply.locked = self->databaseLocked;
+				reply.metadataVersion = self->proxyMetadataVersion;
+				req.reply.send(reply);
+			}
+			when(ReportRawCommittedVersionRequest req = waitNext(self->myInterface.reportLiveCommittedVersion.getFuture())) {
+				if(req.version > self->liveCommittedVersion) {
+					self->liveCommittedVersion = req.version;
+					self->databaseLocked = req.locked;
+					self->proxyMetadataVersion = req.metadataVersion;
+				}
+				req.reply.send(Void());
+			}
+		}
+	}
+}
+
 std::pair<KeyRangeRef, bool> findRange( CoalescedKeyRangeMap<int>& key_resolver, Standalone<VectorRef<ResolverMoveRef>>& movedRanges, int src, int dest ) {
 	auto ranges = key_resolver.ranges();
 	auto prev = ranges.begin();
@@ -1013,6 +1050,8 @@ std::pair<KeyRangeRef, bool> findRange( CoalescedKeyRangeMap<int>& key_resolver,
 ACTOR Future<Void> resolutionBalancing(Reference<MasterData> self) {
 	state CoalescedKeyRangeMap<int> key_resolver;
 	key_resolver.insert(allKeys, 0);
+	state int64_t totalRangesMoved = 0;
+	state double lastLoadLogged = 0;
 	loop {
 		wait(delay(SERVER_KNOBS->MIN_BALANCE_TIME, TaskPriority::ResolutionMetrics));
 		while(self->resolverChanges.get().size())
@@ -1021,21 +1060,51 @@ ACTOR Future<Void> resolutionBalancing(Reference<MasterData> self) {
 		for (auto& p : self->resolvers)
 			futures.push_back(brokenPromiseToNever(p.metrics.getReply(ResolutionMetricsRequest(), TaskPriority::ResolutionMetrics)));
 		wait( waitForAll(futures) );
-		state IndexedSet<std::pair<int64_t, int>, NoMetric> metrics;
 
+		// Resolvers sorted by their sampled conflict checking load, least loaded first
+		state std::vector<std::pair<int64_t, int>> loads;
 		int64_t total = 0;
 		for (int i = 0; i < futures.size(); i++) {
 			total += futures[i].get();
-			metrics.insert(std::make_pair(futures[i].get(), i), NoMetric());
+			loads.push_back(std::make_pair(futures[i].get(), i));
 			//TraceEvent("ResolverMetric").detail("I", i).detail("Metric", futures[i].get());
 		}
-		if( metrics.lastItem()->first - metrics.begin()->first > SERVER_KNOBS->MIN_BALANCE_DIFFERENCE ) {
-			try {
-				state int src = metrics.lastItem()->second;
-				state int dest = metrics.begin()->second;
-				state int64_t amount = std::min( metrics.lastItem()->first - total/self->resolvers.size(), total/self->resolvers.size() - metrics.begin()->first ) / 2;
-				state Standalone<VectorRef<ResolverMoveRef>> movedRanges;
+		std::sort(loads.begin(), loads.end());
+		state int64_t mean = total / self->resolvers.size();
+
+		if(now() - lastLoadLogged >= SERVER_KNOBS->RESOLVER_LOAD_LOGGING_INTERVAL) {
+			lastLoadLogged = now();
+			TraceEvent("ResolverLoads", self->dbgid)
+				.detail("Resolvers", loads.size())
+				.detail("MinLoad", loads.front().first)
+				.detail("MaxLoad", loads.back().first)
+				.detail("MeanLoad", mean)
+				.detail("Skew", mean > 0 ? (double)loads.back().first / mean : 1.0)
+				.detail("RangesMoved", totalRangesMoved)
+				.trackLatest("ResolverLoads");
+		}
+
+		// Pair the i-th most loaded resolver with the i-th least loaded one, so that every overloaded resolver can
+		// shed load in the same round instead of only the single most loaded one.
+		state Standalone<VectorRef<ResolverMoveRef>> movedRanges;
+		state int pair = 0;
+		for(; pair < loads.size() / 2 && pair < SERVER_KNOBS->MAX_RESOLVER_BALANCE_PAIRS; pair++) {
+			state int src = loads[loads.size() - 1 - pair].second;
+			state int dest = loads[pair].second;
+			state int64_t srcLoad = loads[loads.size() - 1 - pair].first;
+			state int64_t destLoad = loads[pair].first;
+			if( srcLoad - destLoad <= SERVER_KNOBS->MIN_BALANCE_DIFFERENCE )
+				break;
+			// Later pairs are closer together, so once a pair no longer straddles the mean none of the rest do either
+			if( srcLoad <= mean || destLoad >= mean )
+				break;
+
+			state int64_t amount = std::min( srcLoad - mean, mean - destLoad ) / 2;
+			if( amount <= 0 )
+				continue;
 
+			try {
+				TEST(pair > 0); // Balancing more than one pair of resolvers in a round
 				loop {
 					state std::pair<KeyRangeRef, bool> range = findRange( key_resolver, movedRanges, src, dest );
 
@@ -1044,7 +1113,7 @@ ACTOR Future<Void> resolutionBalancing(Reference<MasterData> self) {
 					req.offset = amount;
 					req.range = range.first;
 
-					ResolutionSplitReply split = wait( brokenPromiseToNever(self->resolvers[metrics.lastItem()->second].split.getReply(req, TaskPriority::ResolutionMetrics)) );
+					ResolutionSplitReply split = wait( brokenPromiseToNever(self->resolvers[src].split.getReply(req, TaskPriority::ResolutionMetrics)) );
 					KeyRangeRef moveRange = range.second ? KeyRangeRef( range.first.begin, split.key ) : KeyRangeRef( split.key, range.first.end );
 					movedRanges.push_back_deep(movedRanges.arena(), ResolverMoveRef(moveRange, dest));
 					TraceEvent("MovingResolutionRange").detail("Src", src).detail("Dest", dest).detail("Amount", amount).detail("StartRange", range.first).detail("MoveRange", moveRange).detail("Used", split.used).detail("KeyResolverRanges", key_resolver.size());
@@ -1052,20 +1121,24 @@ ACTOR Future<Void> resolutionBalancing(Reference<MasterData> self) {
 					if(moveRange != range.first || amount <= 0 )
 						break;
 				}
-				for(auto& it : movedRanges)
-					key_resolver.insert(it.range, it.dest);
-				//for(auto& it : key_resolver.ranges())
-				//	TraceEvent("KeyResolver").detail("Range", it.range()).detail("Value", it.value());
-
-				self->resolverChangesVersion = self->version + 1;
-				for (auto& p : self->proxies)
-					self->resolverNeedingChanges.insert(p.id());
-				self->resolverChanges.set(movedRanges);
 			} catch( Error&e ) {
 				if(e.code() != error_code_operation_failed)
 					throw;
 			}
 		}
+
+		if(movedRanges.size()) {
+			for(auto& it : movedRanges)
+				key_resolver.insert(it.range, it.dest);
+			//for(auto& it : key_resolver.ranges())
+			//	TraceEvent("KeyResolver").detail("Range", it.range()).detail("Value", it.value());
+			totalRangesMoved += movedRanges.size();
+
+			self->resolverChangesVersion = self->version + 1;
+			for (auto& p : self->proxies)
+				self->resolverNeedingChanges.insert(p.id());
+			self->resolverChanges.set(movedRanges);
+		}
 	}
 }
 
@@ -1345,6 +1418,7 @@ ACTOR Future<Void> masterCore( Reference<MasterData> self ) {
 	self->addActor.send( waitResolverFailure( self->resolvers ) );
 	self->addActor.send( waitProxyFailure( self->proxies ) );
 	self->addActor.send( provideVersions(self) );
+	self->addActor.send( serveLiveCommittedVersion(self) );
 	self->addActor.send( reportErrors(updateRegistration(self, self->logSystem), "UpdateRegistration", self->dbgid) );
 	self->registrationTrigger.trigger();
 
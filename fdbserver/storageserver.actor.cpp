@@ -34,6 +34,8 @@
 #include "fdbclient/StatusClient.h"
 #include "fdbclient/MasterProxyInterface.h"
 #include "fdbclient/DatabaseContext.h"
+#include "fdbclient/BackupAgent.actor.h"
+#include "fdbclient/BackupContainer.h"
 #include "fdbserver/WorkerInterface.actor.h"
 #include "fdbserver/TLogInterface.h"
 #include "fdbserver/MoveKeys.actor.h"
@@ -76,27 +78,88 @@ inline bool canReplyWith(Error e) {
 }
 
 struct StorageServer;
+
+// An atomic operation on a key whose previous value was not in versionedData when the operation was applied.  Instead of reading
+// the previous value from storage on the update path, the operation is kept in versionedData and folded over the value in storage
+// when the key is read, or when the version of the operation is made durable (see resolveAtomicOps()).
+// Operations on the same key form a chain which is shared between versions of versionedData.  Each link is allocated in the arena of
+// the mutation log for its version.
+struct AtomicOpChain {
+	AtomicOpChain* prev;  // The previous operation on the same key, or NULL if this operation applies to the value in storage
+	MutationRef op;       // As recorded in the mutation log
+	Version version;
+	bool resolved;        // If true, value is the value of the key after this operation
+	ValueRef value;
+
+	AtomicOpChain( AtomicOpChain* prev, MutationRef const& op, Version version ) : prev(prev), op(op), version(version), resolved(false) {}
+
+	// Returns true if the value of the key after this operation depends on the value of the key in storage
+	bool needsStorageValue() const {
+		for(auto c = this; c; c = c->prev)
+			if (c->resolved)
+				return false;
+		return true;
+	}
+
+	// Returns the value of the key after this operation, given the value of the key in storage.  The value in storage is ignored
+	//   if any operation in the chain has been resolved, because storage might already reflect that operation.
+	ValueRef fold( Optional<ValueRef> const& storageValue, Arena& arena ) const;
+};
+
 class ValueOrClearToRef {
 public:
-	static ValueOrClearToRef value(ValueRef const& v) { return ValueOrClearToRef(v, false); }
-	static ValueOrClearToRef clearTo(KeyRef const& k) { return ValueOrClearToRef(k, true); }
+	static ValueOrClearToRef value(ValueRef const& v) { return ValueOrClearToRef(v, SET_VALUE); }
+	static ValueOrClearToRef clearTo(KeyRef const& k) { return ValueOrClearToRef(k, CLEAR_TO); }
+	static ValueOrClearToRef atomicOps(AtomicOpChain* ops) { return ValueOrClearToRef(StringRef((const uint8_t*)ops, sizeof(AtomicOpChain)), ATOMIC_OPS); }
 
-	bool isValue() const { return !isClear; };
-	bool isClearTo() const { return isClear; }
+	bool isValue() const { return type == SET_VALUE; };
+	bool isClearTo() const { return type == CLEAR_TO; }
+	bool isAtomicOps() const { return type == ATOMIC_OPS; }
 
 	ValueRef const& getValue() const { ASSERT( isValue() ); return item; };
 	KeyRef const&  getEndKey() const { ASSERT(isClearTo()); return item; };
+	AtomicOpChain* getAtomicOps() const { ASSERT(isAtomicOps()); return (AtomicOpChain*)item.begin(); }
+
+	// An estimate of the size of the value, for sets and atomic operations
+	int expectedValueSize() const { return isAtomicOps() ? getAtomicOps()->op.param2.expectedSize() : getValue().expectedSize(); }
 
 private:
-	ValueOrClearToRef( StringRef item, bool isClear ) : item(item), isClear(isClear) {}
+	enum ItemType : uint8_t { SET_VALUE, CLEAR_TO, ATOMIC_OPS };
+
+	ValueOrClearToRef( StringRef item, ItemType type ) : item(item), type(type) {}
 
 	StringRef item;
-	bool isClear;
+	ItemType type;
+};
+
+// Totals for the fetch of one moving shard, shared by the subranges and blocks its fetchKeys splits it into.  Logged when the
+// last of their fetchKeys actors has finished fetching (or has been cancelled).
+struct FetchKeysProgress : ReferenceCounted<FetchKeysProgress>, NonCopyable {
+	UID serverID;
+	KeyRange keys;
+	double startTime;
+	int64_t bytes;
+	int subranges;
+	int blocks;
+
+	FetchKeysProgress( UID serverID, KeyRange const& keys ) : serverID(serverID), keys(keys), startTime(now()), bytes(0), subranges(1), blocks(0) {}
+	~FetchKeysProgress() {
+		double elapsed = now() - startTime;
+		TraceEvent("FetchKeysShardStats", serverID)
+			.detail("KeyBegin", keys.begin)
+			.detail("KeyEnd", keys.end)
+			.detail("Subranges", subranges)
+			.detail("Blocks", blocks)
+			.detail("Bytes", bytes)
+			.detail("Elapsed", elapsed)
+			.detail("BytesPerSecond", elapsed > 0 ? bytes / elapsed : 0);
+	}
 };
 
 struct AddingShard : NonCopyable {
 	KeyRange keys;
 	Future<Void> fetchClient;			// holds FetchKeys() actor
+	Reference<FetchKeysProgress> progress;	// Set by the fetchKeys that split this shard off, before this shard's own fetchKeys starts
 	Promise<Void> fetchComplete;
 	Promise<Void> readWrite;
 
@@ -202,6 +265,12 @@ private:
 	}
 };
 
+// Returns true if an atomic operation of the given type can be applied without reading the previous value of its key (see AtomicOpChain).
+// CompareAndClear is never deferred, because whether or not it clears its key determines how clears are expanded.
+inline bool canDeferAtomicOp( MutationRef::Type type ) {
+	return SERVER_KNOBS->STORAGE_DEFER_ATOMIC_OP_READS && isAtomicOp(type) && type != MutationRef::CompareAndClear;
+}
+
 struct UpdateEagerReadInfo {
 	std::vector<KeyRef> keyBegin;
 	std::vector<Key> keyEnd; // these are for ClearRange
@@ -229,6 +298,8 @@ struct UpdateEagerReadInfo {
 			} else {
 				keys.emplace_back(m.param1, m.param2.size() + 1);
 			}
+		} else if (canDeferAtomicOp((MutationRef::Type) m.type)) {
+			// The previous value is read lazily, see AtomicOpChain
 		} else if ((m.type == MutationRef::AppendIfFits) || (m.type == MutationRef::ByteMin) ||
 		           (m.type == MutationRef::ByteMax))
 			keys.emplace_back(m.param1, CLIENT_KNOBS->VALUE_SIZE_LIMIT);
@@ -270,7 +341,7 @@ struct StorageServer {
 	typedef VersionedMap<KeyRef, ValueOrClearToRef> VersionedData;
 
 private:
-	// versionedData contains sets and clears.
+	// versionedData contains sets, clears and deferred atomic operations (AtomicOpChain).
 
 	// * Nonoverlapping: No clear overlaps a set or another clear, or adjoins another clear.
 	// ~ Clears are maximal: If versionedData.at(v) contains a clear [b,e) then
@@ -278,6 +349,7 @@ private:
 
 	// * Reads are possible: When k is in a readable shard, for any v in [storageVersion, version.get()],
 	//      storage[k] + versionedData.at(v)[k] = database[k] @ v    (storage[k] might be @ any version in [durableVersion, storageVersion])
+	//      where an atomic operation chain in versionedData is folded over storage[k], unless part of the chain has been resolved
 
 	// * Transferred shards are partially readable: When k is in an adding, transferred shard, for any v in [transferredVersion, version.get()],
 	//      storage[k] + versionedData.at(v)[k] = database[k] @ v
@@ -398,6 +470,15 @@ public:
 
 	CoalescedKeyRangeMap< Version > newestDirtyVersion; // Similar to newestAvailableVersion, but includes (only) keys that were only partly available (due to cancelled fetchKeys)
 
+	// Keys ingested for a bulk load (see fetchKeys) become visible only at the version of the move that publishes them, and
+	// reads at earlier versions are rejected.  latestVersion marks keys which have been ingested but not yet published.
+	// Changed only through setBulkLoadVisibleVersion(), which persists it with the shard assignment (see persistBulkLoadVisibleKeys).
+	CoalescedKeyRangeMap< Version > bulkLoadVisibleVersion;
+
+	// Set once a range this server holds or is fetching has been registered for bulk load, or a fetch has been restarted
+	// from the durable state.  Until then fetchKeys need not look up the bulk load registry.
+	bool bulkLoadRegistered;
+
 	// The following are in rough order from newest to oldest
 	Version lastTLogVersion, lastVersionWithData, restoredVersion;
 	NotifiedVersion version;
@@ -424,6 +505,10 @@ public:
 	CoalescedKeyRangeMap<bool, int64_t, KeyBytesMetric<int64_t>> byteSampleClears;
 	AsyncVar<bool> byteSampleClearsTooLarge;
 	Future<Void> byteSampleRecovery;
+	CoalescedKeyRangeMap<bool> byteSampleRecovered;  // Ranges whose part of the byte sample has been loaded by restoreByteSample()
+	AsyncTrigger byteSampleRecoveryProgress;         // Triggered whenever byteSampleRecovered or byteSampleRecovery changes
+	double byteSampleRecoveryStart;
+	double byteSampleRecoveryTime;                   // Duration of restoreByteSample(), or 0 if it has not finished
 	Future<Void> durableInProgress;
 
 	AsyncMap<Key,bool> watches;
@@ -439,9 +524,13 @@ public:
 	// defined only during splitMutations()/addMutation()
 	UpdateEagerReadInfo *updateEagerReads;
 
+	// Deferred atomic operations which have not been written to storage, in mutation log order
+	Deque<AtomicOpChain*> pendingAtomicOps;
+
 	FlowLock durableVersionLock;
 	FlowLock fetchKeysParallelismLock;
 	vector< Promise<FetchInjectionInfo*> > readyFetchKeys;
+	FlowLock backupShardLock;
 
 	int64_t instanceID;
 
@@ -466,9 +555,9 @@ public:
 	struct Counters {
 		CounterCollection cc;
 		Counter allQueries, getKeyQueries, getValueQueries, getRangeQueries, finishedQueries, rowsQueried, bytesQueried, watchQueries;
-		Counter bytesInput, bytesDurable, bytesFetched,
+		Counter bytesInput, bytesDurable, bytesFetched, bytesBulkLoaded,
 			mutationBytes;  // Like bytesInput but without MVCC accounting
-		Counter mutations, setMutations, clearRangeMutations, atomicMutations;
+		Counter mutations, setMutations, clearRangeMutations, atomicMutations, deferredAtomicMutations;
 		Counter updateBatches, updateVersions;
 		Counter loops;
 		Counter fetchWaitingMS, fetchWaitingCount, fetchExecutingMS, fetchExecutingCount;
@@ -489,11 +578,13 @@ public:
 			bytesInput("BytesInput", cc),
 			bytesDurable("BytesDurable", cc),
 			bytesFetched("BytesFetched", cc),
+			bytesBulkLoaded("BytesBulkLoaded", cc),
 			mutationBytes("MutationBytes", cc),
 			mutations("Mutations", cc),
 			setMutations("SetMutations", cc),
 			clearRangeMutations("ClearRangeMutations", cc),
 			atomicMutations("AtomicMutations", cc),
+			deferredAtomicMutations("DeferredAtomicMutations", cc),
 			updateBatches("UpdateBatches", cc),
 			updateVersions("UpdateVersions", cc),
 			loops("Loops", cc),
@@ -518,8 +609,10 @@ public:
 			specialCounter(cc, "QueryQueueMax", [self](){ return self->getAndResetMaxQueryQueueSize(); });
 
 			specialCounter(cc, "BytesStored", [self](){ return self->metrics.byteSample.getEstimate(allKeys); });
+			specialCounter(cc, "ByteSampleRecoveryMS", [self](){ return 1000*(self->byteSampleRecovery.isReady() ? self->byteSampleRecoveryTime : now() - self->byteSampleRecoveryStart); });
 			specialCounter(cc, "ActiveWatches", [self](){ return self->numWatches; });
 			specialCounter(cc, "WatchBytes", [self](){ return self->watchBytes; });
+			specialCounter(cc, "PendingAtomicMutations", [self](){ return self->pendingAtomicOps.size(); });
 
 			specialCounter(cc, "KvstoreBytesUsed", [self](){ return self->storage.getStorageBytes().used; });
 			specialCounter(cc, "KvstoreBytesFree", [self](){ return self->storage.getStorageBytes().free; });
@@ -533,15 +626,18 @@ public:
 			storage(this, storage), db(db),
 			lastTLogVersion(0), lastVersionWithData(0), restoredVersion(0),
 			rebootAfterDurableVersion(std::numeric_limits<Version>::max()),
+			bulkLoadRegistered(false),
 			durableInProgress(Void()),
 			versionLag(0), primaryLocality(tagLocalityInvalid),
 			updateEagerReads(0),
 			shardChangeCounter(0),
 			fetchKeysParallelismLock(SERVER_KNOBS->FETCH_KEYS_PARALLELISM_BYTES),
+			backupShardLock(SERVER_KNOBS->BACKUP_SHARD_PARALLELISM),
 			shuttingDown(false), debug_inApplyUpdate(false), debug_lastValidateTime(0), watchBytes(0), numWatches(0),
 			logProtocol(0), counters(this), tag(invalidTag), maxQueryQueue(0), thisServerID(ssi.id()),
 			readQueueSizeMetric(LiteralStringRef("StorageServer.ReadQueueSize")),
-			behind(false), byteSampleClears(false, LiteralStringRef("\xff\xff\xff")), noRecentUpdates(false),
+			behind(false), byteSampleClears(false, LiteralStringRef("\xff\xff\xff")), byteSampleRecovered(false, LiteralStringRef("\xff\xff\xff")),
+			byteSampleRecoveryStart(now()), byteSampleRecoveryTime(0), noRecentUpdates(false),
 			lastUpdate(now()), poppedAllAfter(std::numeric_limits<Version>::max()), cpuUsage(0.0), diskUsage(0.0)
 	{
 		version.initMetric(LiteralStringRef("StorageServer.Version"), counters.cc.id);
@@ -593,6 +689,23 @@ public:
 		return true;
 	}
 
+	void checkBulkLoadVisible( KeyRef const& key, Version version ) {
+		Version visible = bulkLoadVisibleVersion[key];
+		if (version < visible) {
+			TEST(true); // Read of bulk loaded key before it was published
+			throw visible == latestVersion ? wrong_shard_server() : transaction_too_old();
+		}
+	}
+
+	void checkBulkLoadVisible( KeyRangeRef const& keys, Version version ) {
+		auto r = bulkLoadVisibleVersion.intersectingRanges(keys);
+		for(auto i = r.begin(); i != r.end(); ++i)
+			if (version < i->value()) {
+				TEST(true); // Read of bulk loaded range before it was published
+				throw i->value() == latestVersion ? wrong_shard_server() : transaction_too_old();
+			}
+	}
+
 	void checkChangeCounter( uint64_t oldShardChangeCounter, KeyRef const& key ) {
 		if (oldShardChangeCounter != shardChangeCounter &&
 			shards[key]->changeCounter > oldShardChangeCounter)
@@ -668,6 +781,9 @@ void StorageServer::byteSampleApplyMutation( MutationRef const& m, Version ver )
 		byteSampleApplyClear( KeyRangeRef(m.param1, m.param2), ver );
 	else if (m.type == MutationRef::SetValue)
 		byteSampleApplySet( KeyValueRef(m.param1, m.param2), ver );
+	else if (isAtomicOp((MutationRef::Type) m.type)) {
+		// A deferred atomic op is sampled once its value is known, in resolveAtomicOps()
+	}
 	else
 		ASSERT(false); // Mutation of unknown type modfying byte sample
 }
@@ -848,14 +964,22 @@ ACTOR Future<Void> getValueQ( StorageServer* data, GetValueRequest req ) {
 			//TraceEvent("WrongShardServer", data->thisServerID).detail("Key", req.key).detail("Version", version).detail("In", "getValueQ");
 			throw wrong_shard_server();
 		}
+		data->checkBulkLoadVisible( req.key, version );
 
 		state int path = 0;
+		state AtomicOpChain* atomicOps = NULL;
 		auto i = data->data().at(version).lastLessOrEqual(req.key);
 		if (i && i->isValue() && i.key() == req.key) {
 			v = (Value)i->getValue();
 			path = 1;
+		} else if (i && i->isAtomicOps() && i.key() == req.key && !i->getAtomicOps()->needsStorageValue()) {
+			Arena arena;
+			v = Value( i->getAtomicOps()->fold( Optional<ValueRef>(), arena ) );
+			path = 1;
 		} else if (!i || !i->isClearTo() || i->getEndKey() <= req.key) {
 			path = 2;
+			if (i && i->isAtomicOps() && i.key() == req.key)
+				atomicOps = i->getAtomicOps();
 			Optional<Value> vv = wait( data->storage.readValue( req.key, req.debugID ) );
 			// Validate that while we were reading the data we didn't lose the version or shard
 			if (version < data->storageVersion()) {
@@ -864,17 +988,22 @@ ACTOR Future<Void> getValueQ( StorageServer* data, GetValueRequest req ) {
 			}
 			data->checkChangeCounter(changeCounter, req.key);
 			v = vv;
+			if (atomicOps) {
+				// The chain may have been resolved while we were reading, in which case fold() ignores vv
+				Arena arena;
+				v = Value( atomicOps->fold( vv.castTo<ValueRef>(), arena ) );
+			}
 		}
 
 		debugMutation("ShardGetValue", version, MutationRef(MutationRef::DebugKey, req.key, v.present()?v.get():LiteralStringRef("<null>")));
 		debugMutation("ShardGetPath", version, MutationRef(MutationRef::DebugKey, req.key, path==0?LiteralStringRef("0"):path==1?LiteralStringRef("1"):LiteralStringRef("2")));
 
-		/*
-		StorageMetrics m;
-		m.bytesPerKSecond = req.key.size() + (v.present() ? v.get().size() : 0);
-		m.iosPerKSecond = 1;
-		data->metrics.notify(req.key, m);
-		*/
+		if (SERVER_KNOBS->READ_SAMPLING_ENABLED) {
+			// Empty reads still cost the storage server work, so they are charged a minimum size
+			StorageMetrics m;
+			m.bytesReadPerKSecond = std::max<int64_t>(req.key.size() + (v.present() ? v.get().size() : 0), SERVER_KNOBS->EMPTY_READ_PENALTY);
+			data->metrics.notify(req.key, m);
+		}
 
 		if (v.present()) {
 			++data->counters.rowsQueried;
@@ -1031,6 +1160,13 @@ ACTOR Future<Void> getShardStateQ( StorageServer* data, GetShardStateRequest req
 	return Void();
 }
 
+// Returns the value of the set or atomic operation chain at i, given the value of the same key (if any) at the older version of base
+ValueRef mergedValue( StorageServer::VersionedData::iterator& i, Optional<ValueRef> const& baseValue, Arena& arena ) {
+	if (i->isAtomicOps())
+		return i->getAtomicOps()->fold( baseValue, arena );
+	return i->getValue();
+}
+
 void merge( Arena& arena, VectorRef<KeyValueRef>& output, VectorRef<KeyValueRef> const& base,
 	        StorageServer::VersionedData::iterator& start, StorageServer::VersionedData::iterator const& end,
 			int versionedDataCount, int limit, bool stopAtEndOfBase, int limitBytes = 1<<30 )
@@ -1049,8 +1185,11 @@ void merge( Arena& arena, VectorRef<KeyValueRef>& output, VectorRef<KeyValueRef>
 		if (forward ? baseStart->key < start.key() : baseStart->key > start.key())
 			output.push_back_deep( arena, *baseStart++ );
 		else {
-			output.push_back_deep( arena, KeyValueRef(start.key(), start->getValue()) );
-			if (baseStart->key == start.key()) ++baseStart;
+			if (baseStart->key == start.key()) {
+				output.push_back_deep( arena, KeyValueRef(start.key(), mergedValue(start, baseStart->value, arena)) );
+				++baseStart;
+			} else
+				output.push_back_deep( arena, KeyValueRef(start.key(), mergedValue(start, Optional<ValueRef>(), arena)) );
 			if (forward) ++start; else --start;
 		}
 		accumulatedBytes += sizeof(KeyValueRef) + output.end()[-1].expectedSize();
@@ -1061,7 +1200,7 @@ void merge( Arena& arena, VectorRef<KeyValueRef>& output, VectorRef<KeyValueRef>
 	}
 	if( !stopAtEndOfBase ) {
 		while (start!=end && --limit>=0 && accumulatedBytes < limitBytes) {
-			output.push_back_deep( arena, KeyValueRef(start.key(), start->getValue()) );
+			output.push_back_deep( arena, KeyValueRef(start.key(), mergedValue(start, Optional<ValueRef>(), arena)) );
 			accumulatedBytes += sizeof(KeyValueRef) + output.end()[-1].expectedSize();
 			if (forward) ++start; else --start;
 		}
@@ -1123,7 +1262,7 @@ ACTOR Future<GetKeyValuesReply> readRange( StorageServer* data, Version version,
 			vCount = 0;
 			int vSize = 0;
 			while (vEnd && vEnd.key() < range.end && !vEnd->isClearTo() && vCount < limit && vSize < *pLimitBytes){
-				vSize += sizeof(KeyValueRef) + vEnd->getValue().expectedSize() + vEnd.key().expectedSize();
+				vSize += sizeof(KeyValueRef) + vEnd->expectedValueSize() + vEnd.key().expectedSize();
 				++vCount;
 				++vEnd;
 			}
@@ -1221,7 +1360,7 @@ ACTOR Future<GetKeyValuesReply> readRange( StorageServer* data, Version version,
 			vCount = 0;
 			int vSize=0;
 			while (vEnd && vEnd.key() >= range.begin && !vEnd->isClearTo() && vCount < -limit && vSize < *pLimitBytes){
-				vSize += sizeof(KeyValueRef) + vEnd->getValue().expectedSize() + vEnd.key().expectedSize();
+				vSize += sizeof(KeyValueRef) + vEnd->expectedValueSize() + vEnd.key().expectedSize();
 				++vCount;
 				--vEnd;
 			}
@@ -1391,6 +1530,9 @@ ACTOR Future<Void> getKeyValues( StorageServer* data, GetKeyValuesRequest req )
 			throw wrong_shard_server();
 		}
 
+		data->checkBulkLoadVisible( KeyRangeRef( std::min<KeyRef>({ begin, end, req.begin.getKey(), req.end.getKey() }),
+		                                         std::max<KeyRef>({ begin, end, req.begin.getKey(), req.end.getKey() }) ) & shard, version );
+
 		if (begin >= end) {
 			if( req.debugID.present() )
 				g_traceBatch.addEvent("TransactionDebug", req.debugID.get().first(), "storageserver.getKeyValues.Send");
@@ -1419,12 +1561,23 @@ ACTOR Future<Void> getKeyValues( StorageServer* data, GetKeyValuesRequest req )
 				ASSERT(r.data.size() <= std::abs(req.limit));
 			}
 
-			/*for( int i = 0; i < r.data.size(); i++ ) {
+			if (SERVER_KNOBS->READ_SAMPLING_ENABLED) {
+				// Charge the bytes of the whole reply to its first and last keys rather than sampling every row; a
+				//  split point chosen from the read sample then lands at one end of the scanned range.  A read which
+				//  found nothing is charged the empty read penalty at the beginning of the range it scanned.
 				StorageMetrics m;
-				m.bytesPerKSecond = r.data[i].expectedSize();
-				m.iosPerKSecond = 1; //FIXME: this should be 1/r.data.size(), but we cannot do that because it is an int
-				data->metrics.notify(r.data[i].key, m);
-			}*/
+				if (r.data.size()) {
+					int64_t totalByteSize = 0;
+					for( int i = 0; i < r.data.size(); i++ )
+						totalByteSize += r.data[i].expectedSize();
+					m.bytesReadPerKSecond = std::max<int64_t>(totalByteSize, SERVER_KNOBS->EMPTY_READ_PENALTY) / 2;
+					data->metrics.notify(r.data[0].key, m);
+					data->metrics.notify(r.data[r.data.size() - 1].key, m);
+				} else {
+					m.bytesReadPerKSecond = SERVER_KNOBS->EMPTY_READ_PENALTY;
+					data->metrics.notify(begin, m);
+				}
+			}
 
 			r.penalty = data->getPenalty();
 			req.reply.send( r );
@@ -1451,6 +1604,68 @@ ACTOR Future<Void> getKeyValues( StorageServer* data, GetKeyValuesRequest req )
 	return Void();
 }
 
+// Writes req.keys at req.version to a range file in the backup container for a backup agent, so that snapshot data
+// goes straight from the storage servers to the container.  The file ends at a key boundary after
+// BACKUP_SHARD_FILE_BYTES of data; the reply says where, and the agent asks again for the rest.
+ACTOR Future<Void> backupShardQ( StorageServer* data, BackupShardRequest req ) {
+	wait( data->backupShardLock.take() );
+	state FlowLock::Releaser holdingLock( data->backupShardLock );
+
+	try {
+		state Version version = wait( waitForVersion( data, req.version ) );
+		state uint64_t changeCounter = data->shardChangeCounter;
+		state KeyRange shard = getShardKeyRange( data, firstGreaterOrEqual(req.keys.begin) );
+		if ( req.keys.end > shard.end )
+			throw wrong_shard_server();
+		data->checkBulkLoadVisible( req.keys, version );
+
+		state Standalone<VectorRef<KeyValueRef>> kvs;
+		state Key end = req.keys.end;
+		state Key readBegin = req.keys.begin;
+		state int64_t bytes = 0;
+		loop {
+			state int remainingLimitBytes = SERVER_KNOBS->FETCH_BLOCK_BYTES;
+			GetKeyValuesReply r = wait( readRange( data, version, KeyRangeRef(readBegin, req.keys.end), std::numeric_limits<int>::max(), &remainingLimitBytes ) );
+			kvs.arena().dependsOn( r.arena );
+			kvs.append( kvs.arena(), r.data.begin(), r.data.size() );
+			bytes += SERVER_KNOBS->FETCH_BLOCK_BYTES - remainingLimitBytes;
+			if ( !r.more )
+				break;
+			readBegin = keyAfter( r.data.back().key );
+			if ( bytes >= SERVER_KNOBS->BACKUP_SHARD_FILE_BYTES ) {
+				end = readBegin;
+				break;
+			}
+		}
+		data->checkChangeCounter( changeCounter, KeyRangeRef( req.keys.begin, end ) );
+
+		state Reference<IBackupContainer> bc = IBackupContainer::openContainer( req.containerURL );
+		state Reference<IBackupFile> file = wait( bc->writeRangeFile( req.snapshotBeginVersion, req.snapshotFileCount, version, req.blockSize ) );
+		wait( fileBackup::writeRangeFile( file, req.blockSize, KeyRangeRef( req.keys.begin, end ), kvs ) );
+
+		TraceEvent("BackupShardWroteRangeFile", data->thisServerID).suppressFor(60)
+			.detail("KeyBegin", req.keys.begin).detail("KeyEnd", end).detail("Version", version)
+			.detail("Keys", kvs.size()).detail("Bytes", file->size()).detail("File", file->getFileName());
+
+		BackupShardReply reply;
+		reply.fileName = file->getFileName();
+		reply.fileSize = file->size();
+		reply.end = end;
+		reply.keyCount = kvs.size();
+		req.reply.send( reply );
+	} catch (Error& e) {
+		if( e.code() == error_code_actor_cancelled )
+			throw;
+		// Errors from the backup container are the agent's to handle, so never let them take down the storage server.  The
+		// container URL is not logged since it may carry a secret key.
+		TraceEvent(SevWarn, "BackupShardFailed", data->thisServerID).error(e, true).suppressFor(60)
+			.detail("KeyBegin", req.keys.begin).detail("KeyEnd", req.keys.end).detail("Version", req.version);
+		req.reply.sendError( e );
+	}
+
+	return Void();
+}
+
 ACTOR Future<Void> getKey( StorageServer* data, GetKeyRequest req ) {
 	state int64_t resultSize = 0;
 
@@ -1472,6 +1687,7 @@ ACTOR Future<Void> getKey( StorageServer* data, GetKeyRequest req ) {
 		Key k = wait( findKey( data, req.sel, version, shard, &offset ) );
 
 		data->checkChangeCounter( changeCounter, KeyRangeRef( std::min<KeyRef>(req.sel.getKey(), k), std::max<KeyRef>(req.sel.getKey(), k) ) );
+		data->checkBulkLoadVisible( KeyRangeRef( std::min<KeyRef>(req.sel.getKey(), k), keyAfter( std::max<KeyRef>(req.sel.getKey(), k) ) ), version );
 
 		KeySelector updated;
 		if (offset < 0)
@@ -1630,6 +1846,49 @@ Optional<MutationRef> clipMutation( MutationRef const& m, KeyRangeRef range ) {
 	return Optional<MutationRef>();
 }
 
+// Returns the value of the key m.param1 after applying the atomic operation m to its previous value
+ValueRef applyAtomicOp( MutationRef const& m, Optional<ValueRef> const& oldVal, Arena& ar ) {
+	switch(m.type) {
+	case MutationRef::AddValue:
+		return doLittleEndianAdd(oldVal, m.param2, ar);
+	case MutationRef::And:
+		return doAnd(oldVal, m.param2, ar);
+	case MutationRef::Or:
+		return doOr(oldVal, m.param2, ar);
+	case MutationRef::Xor:
+		return doXor(oldVal, m.param2, ar);
+	case MutationRef::AppendIfFits:
+		return doAppendIfFits(oldVal, m.param2, ar);
+	case MutationRef::Max:
+		return doMax(oldVal, m.param2, ar);
+	case MutationRef::Min:
+		return doMin(oldVal, m.param2, ar);
+	case MutationRef::ByteMin:
+		return doByteMin(oldVal, m.param2, ar);
+	case MutationRef::ByteMax:
+		return doByteMax(oldVal, m.param2, ar);
+	case MutationRef::MinV2:
+		return doMinV2(oldVal, m.param2, ar);
+	case MutationRef::AndV2:
+		return doAndV2(oldVal, m.param2, ar);
+	default:
+		// Mutations of other types (in particular, CompareAndClear) do not produce a value
+		UNREACHABLE();
+	}
+}
+
+ValueRef AtomicOpChain::fold( Optional<ValueRef> const& storageValue, Arena& arena ) const {
+	std::vector<AtomicOpChain const*> unresolved;
+	auto c = this;
+	for(; c && !c->resolved; c = c->prev)
+		unresolved.push_back(c);
+
+	Optional<ValueRef> val = c ? Optional<ValueRef>(c->value) : storageValue;
+	for(auto op = unresolved.rbegin(); op != unresolved.rend(); ++op)
+		val = applyAtomicOp( (*op)->op, val, arena );
+	return val.get();
+}
+
 bool expandMutation( MutationRef& m, StorageServer::VersionedData const& data, UpdateEagerReadInfo* eager, KeyRef eagerTrustedEnd, Arena& ar ) {
 	// After this function call, m should be copied into an arena immediately (before modifying data, shards, or eager)
 	if (m.type == MutationRef::ClearRange) {
@@ -1667,47 +1926,30 @@ bool expandMutation( MutationRef& m, StorageServer::VersionedData const& data, U
 		else if (it != data.atLatest().end() && it->isClearTo() && it->getEndKey() > m.param1) {
 			TEST(true); // Atomic op right after a clear.
 		}
+		else if (it != data.atLatest().end() && it->isAtomicOps() && it.key() == m.param1) {
+			AtomicOpChain* ops = it->getAtomicOps();
+			if (ops->resolved) {
+				TEST(true); // Atomic op right after a resolved atomic op
+				oldVal = ops->value;
+			} else if (canDeferAtomicOp((MutationRef::Type) m.type)) {
+				TEST(true); // Atomic op appended to a chain of deferred atomic ops
+				return true; // applyMutation() appends it to the chain
+			} else {
+				TEST(true); // Non-deferrable atomic op right after a deferred atomic op
+				oldVal = ops->fold( eager->getValue(m.param1).castTo<ValueRef>(), ar );
+			}
+		}
+		else if (canDeferAtomicOp((MutationRef::Type) m.type)) {
+			TEST(true); // Atomic op deferred
+			return true; // applyMutation() starts a chain
+		}
 		else {
 			Optional<Value>& oldThing = eager->getValue(m.param1);
 			if (oldThing.present())
 				oldVal = oldThing.get();
 		}
 
-		switch(m.type) {
-		case MutationRef::AddValue:
-			m.param2 = doLittleEndianAdd(oldVal, m.param2, ar);
-			break;
-		case MutationRef::And:
-			m.param2 = doAnd(oldVal, m.param2, ar);
-			break;
-		case MutationRef::Or:
-			m.param2 = doOr(oldVal, m.param2, ar);
-			break;
-		case MutationRef::Xor:
-			m.param2 = doXor(oldVal, m.param2, ar);
-			break;
-		case MutationRef::AppendIfFits:
-			m.param2 = doAppendIfFits(oldVal, m.param2, ar);
-			break;
-		case MutationRef::Max:
-			m.param2 = doMax(oldVal, m.param2, ar);
-			break;
-		case MutationRef::Min:
-			m.param2 = doMin(oldVal, m.param2, ar);
-			break;
-		case MutationRef::ByteMin:
-			m.param2 = doByteMin(oldVal, m.param2, ar);
-			break;
-		case MutationRef::ByteMax:
-			m.param2 = doByteMax(oldVal, m.param2, ar);
-			break;
-		case MutationRef::MinV2:
-			m.param2 = doMinV2(oldVal, m.param2, ar);
-			break;
-		case MutationRef::AndV2:
-			m.param2 = doAndV2(oldVal, m.param2, ar);
-			break;
-		case MutationRef::CompareAndClear:
+		if (m.type == MutationRef::CompareAndClear) {
 			if (oldVal.present() && m.param2 == oldVal.get()) {
 				m.type = MutationRef::ClearRange;
 				m.param2 = keyAfter(m.param1, ar);
@@ -1715,6 +1957,7 @@ bool expandMutation( MutationRef& m, StorageServer::VersionedData const& data, U
 			}
 			return false;
 		}
+		m.param2 = applyAtomicOp(m, oldVal, ar);
 		m.type = MutationRef::SetValue;
 	}
 
@@ -1758,6 +2001,15 @@ void applyMutation( StorageServer *self, MutationRef const& m, Arena& arena, Sto
 		ASSERT( !isClearContaining( data.atLatest(), m.param1 ) );
 		data.insert( m.param1, ValueOrClearToRef::clearTo(m.param2) );
 		self->watches.triggerRange( m.param1, m.param2 );
+	} else if (isAtomicOp((MutationRef::Type) m.type)) {
+		// expandMutation() deferred this op because the previous value of the key is not in data; start or extend its chain
+		auto prev = data.atLatest().find(m.param1);
+		ASSERT( !prev || prev->isAtomicOps() );
+		AtomicOpChain* ops = new (arena) AtomicOpChain( prev ? prev->getAtomicOps() : NULL, m, data.getLatestVersion() );
+		data.insert( m.param1, ValueOrClearToRef::atomicOps(ops) );
+		self->pendingAtomicOps.push_back(ops);
+		++self->counters.deferredAtomicMutations;
+		self->watches.trigger( m.param1 );
 	}
 
 }
@@ -1798,6 +2050,8 @@ void removeDataRange( StorageServer *ss, Standalone<VersionUpdateRef> &mLV, KeyR
 
 void setAvailableStatus( StorageServer* self, KeyRangeRef keys, bool available );
 void setAssignedStatus( StorageServer* self, KeyRangeRef keys, bool nowAssigned );
+void setBulkLoadVisibleVersion( StorageServer* self, KeyRangeRef keys, Version version );
+void publishBulkLoad( StorageServer* self, KeyRangeRef keys, Version version );
 
 void coalesceShards(StorageServer *data, KeyRangeRef keys) {
 	auto shardRanges = data->shards.intersectingRanges(keys);
@@ -1887,6 +2141,95 @@ ACTOR Future<Standalone<RangeResultRef>> tryGetRange( Database cx, Version versi
 	}
 }
 
+// Returns the begin key of the range file block at offset, which is all that is needed to search the blocks of a file
+ACTOR Future<Key> readRangeFileBlockBegin( Reference<IAsyncFile> file, int64_t offset, int len ) {
+	state Standalone<StringRef> buf = makeString( std::min<int64_t>( len, sizeof(int32_t) + sizeof(uint32_t) + CLIENT_KNOBS->KEY_SIZE_LIMIT ) );
+	int rLen = wait( file->read( mutateString(buf), buf.size(), offset ) );
+	if( rLen < sizeof(int32_t) + sizeof(uint32_t) )
+		throw restore_bad_read();
+
+	// Skip the block header to the length of the begin key
+	uint32_t kLen = bigEndian32( *(const uint32_t*)( buf.begin() + sizeof(int32_t) ) );
+	if( sizeof(int32_t) + sizeof(uint32_t) + kLen > rLen )
+		throw restore_corrupted_data();
+	return Key( buf.substr( sizeof(int32_t) + sizeof(uint32_t), kLen ), buf.arena() );
+}
+
+// Reads keys from the range file a bulk load registered for a range containing them, decoding the file's blocks from the one
+// containing keys.begin until at least blockBytes have been read.  Like tryGetRange, sets more and readThrough if it stops short of keys.end.
+ACTOR Future<Standalone<RangeResultRef>> tryGetBulkLoadRange( Value registration, KeyRange keys, int blockBytes ) {
+	state std::string containerUrl;
+	state std::string fileName;
+	state int64_t fileSize;
+	state uint32_t blockSize;
+	decodeBulkLoadValue( registration, containerUrl, fileName, fileSize, blockSize );
+
+	state Reference<IAsyncFile> file = wait( IBackupContainer::openContainer( containerUrl )->readFile( fileName ) );
+	state int64_t blocks = blockSize ? (fileSize + blockSize - 1) / blockSize : 0;
+	state Standalone<RangeResultRef> output;
+
+	// Binary search for the last block beginning at or before keys.begin
+	state int64_t block = 0;
+	state int64_t end = blocks;
+	state int64_t mid;
+	while( end - block > 1 ) {
+		mid = block + (end - block) / 2;
+		Key blockBegin = wait( readRangeFileBlockBegin( file, mid * blockSize, std::min<int64_t>( blockSize, fileSize - mid * blockSize ) ) );
+		if( blockBegin <= keys.begin )
+			block = mid;
+		else
+			end = mid;
+	}
+
+	for(; block < blocks; ++block) {
+		Standalone<VectorRef<KeyValueRef>> kvs = wait( fileBackup::decodeRangeFileBlock( file, block * blockSize, std::min<int64_t>( blockSize, fileSize - block * blockSize ) ) );
+
+		// The first and last keys of a block are the range it covers rather than data
+		output.arena().dependsOn( kvs.arena() );
+		for(int i = 1; i < kvs.size() - 1 && kvs[i].key < keys.end; i++) {
+			if( kvs[i].key >= keys.begin )
+				output.push_back( output.arena(), kvs[i] );
+		}
+
+		if( kvs.back().key >= keys.end )
+			break;
+		if( output.size() && output.expectedSize() >= blockBytes ) {
+			output.more = true;
+			output.readThrough = kvs.back().key;
+			break;
+		}
+	}
+
+	return output;
+}
+
+// Reads the next block of keys for fetchKeys at version.  A block beginning in a range registered for bulk load is read from the
+// registered range file, since the source servers never held it, and any other block from the source servers.  A block never spans
+// the boundary of a registration.  The registry is only read if checkBulkLoad is set.
+ACTOR Future<Standalone<RangeResultRef>> tryGetFetchBlock( Database cx, Version version, KeyRange keys, int blockBytes, bool checkBulkLoad, bool* isTooOld, bool* isBulkLoad ) {
+	if( !checkBulkLoad ) {
+		*isBulkLoad = false;
+		Standalone<RangeResultRef> range = wait( tryGetRange( cx, version, keys, GetRangeLimits( CLIENT_KNOBS->ROW_LIMIT_UNLIMITED, blockBytes ), isTooOld ) );
+		return range;
+	}
+
+	state Transaction tr( cx );
+	tr.setVersion( version );
+
+	Standalone<RangeResultRef> bulkLoads = wait( krmGetRanges( &tr, bulkLoadPrefix, keys, 3 ) );
+	state KeyRange blockKeys = KeyRangeRef( keys.begin, bulkLoads[1].key );
+	state Value registration = bulkLoads[0].value;
+
+	*isBulkLoad = registration.size() > 0;
+	state Standalone<RangeResultRef> block = wait( *isBulkLoad ? tryGetBulkLoadRange( registration, blockKeys, blockBytes )
+	                                                           : tryGetRange( cx, version, blockKeys, GetRangeLimits( CLIENT_KNOBS->ROW_LIMIT_UNLIMITED, blockBytes ), isTooOld ) );
+	if( !block.more && blockKeys.end != keys.end ) {
+		block.more = true;
+		block.readThrough = blockKeys.end;
+	}
+	return block;
+}
+
 template <class T>
 void addMutation( T& target, Version version, MutationRef const& mutation ) {
 	target.addMutation( version, mutation );
@@ -1979,6 +2322,13 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 	//  This allows adding->start() to be called inline with CSK.
 	wait( data->coreStarted.getFuture() && delay( 0 ) );
 
+	// A shard split off by another fetchKeys shares its progress, and is not split along the byte sample again
+	state Reference<FetchKeysProgress> progress = shard->progress;
+	state bool isSubrange = progress.isValid();
+	if( !isSubrange )
+		progress = Reference<FetchKeysProgress>( new FetchKeysProgress( data->thisServerID, keys ) );
+	shard->progress.clear();
+
 	try {
 		debugKeyRange("fetchKeysBegin", data->version.get(), shard->keys);
 
@@ -2006,6 +2356,34 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 
 		TraceEvent(SevDebug, "FetchKeysVersionSatisfied", data->thisServerID).detail("FKID", interval.pairID);
 
+		if( !isSubrange && SERVER_KNOBS->FETCH_KEYS_SUBRANGE_BYTES > 0 ) {
+			// Split a large shard along the source servers' byte sample.  The subranges are fetched by their own fetchKeys
+			//  concurrently (and, through load balancing, from different source replicas) rather than one block after another.
+			data->cx->invalidateCache(keys);
+			StorageMetrics subrangeLimit;
+			subrangeLimit.bytes = SERVER_KNOBS->FETCH_KEYS_SUBRANGE_BYTES;
+			subrangeLimit.bytesPerKSecond = subrangeLimit.infinity;
+			subrangeLimit.iosPerKSecond = subrangeLimit.infinity;
+			subrangeLimit.bytesReadPerKSecond = subrangeLimit.infinity;
+			state Transaction splitTr( data->cx );
+			Standalone<VectorRef<KeyRef>> splits = wait( timeout( splitTr.splitStorageMetrics( keys, subrangeLimit, StorageMetrics() ),
+			                                                      SERVER_KNOBS->FETCH_KEYS_SPLIT_TIMEOUT, Standalone<VectorRef<KeyRef>>() ) );
+
+			if( splits.size() > 2 && shard->phase == AddingShard::WaitPrevious && shard->keys == keys ) {
+				TEST( true ); // fetchKeys split a shard into subranges
+				// Nothing has been fetched and no updates are kept in WaitPrevious, so the subranges can start from scratch
+				progress->subranges = splits.size() - 1;
+				shard->server->addShard( ShardInfo::addingSplitLeft( KeyRangeRef(splits[0], splits[1]), shard ) );
+				for( int i = 1; i < splits.size() - 1; i++ ) {
+					ShardInfo* subrange = ShardInfo::newAdding( data, KeyRangeRef(splits[i], splits[i+1]) );
+					subrange->adding->progress = progress;
+					shard->server->addShard( subrange );
+				}
+				shard = data->shards.rangeContaining( keys.begin ).value()->adding;
+				keys = shard->keys;
+			}
+		}
+
 		wait( data->fetchKeysParallelismLock.take( TaskPriority::DefaultYield, fetchBlockBytes ) );
 		state FlowLock::Releaser holdingFKPL( data->fetchKeysParallelismLock, fetchBlockBytes );
 
@@ -2031,6 +2409,7 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 		state int debug_getRangeRetries = 0;
 		state int debug_nextRetryToLog = 1;
 		state bool isTooOld = false;
+		state bool isBulkLoad = false;
 
 		//FIXME: The client cache does not notice when servers are added to a team. To read from a local storage server we must refresh the cache manually.
 		data->cx->invalidateCache(keys);
@@ -2039,7 +2418,7 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 			try {
 				TEST(true);		// Fetching keys for transferred shard
 
-				state Standalone<RangeResultRef> this_block = wait( tryGetRange( data->cx, fetchVersion, keys, GetRangeLimits( CLIENT_KNOBS->ROW_LIMIT_UNLIMITED, fetchBlockBytes ), &isTooOld ) );
+				state Standalone<RangeResultRef> this_block = wait( tryGetFetchBlock( data->cx, fetchVersion, keys, fetchBlockBytes, data->bulkLoadRegistered, &isTooOld, &isBulkLoad ) );
 
 				int expectedSize = (int)this_block.expectedSize() + (8-(int)sizeof(KeyValueRef))*this_block.size();
 
@@ -2047,32 +2426,23 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 					.detail("BlockRows", this_block.size()).detail("BlockBytes", expectedSize)
 					.detail("KeyBegin", keys.begin).detail("KeyEnd", keys.end)
 					.detail("Last", this_block.size() ? this_block.end()[-1].key : std::string())
-					.detail("Version", fetchVersion).detail("More", this_block.more);
+					.detail("Version", fetchVersion).detail("More", this_block.more).detail("BulkLoad", isBulkLoad);
 				debugKeyRange("fetchRange", fetchVersion, keys);
 				for(auto k = this_block.begin(); k != this_block.end(); ++k) debugMutation("fetch", fetchVersion, MutationRef(MutationRef::SetValue, k->key, k->value));
 
 				data->counters.bytesFetched += expectedSize;
+				if( isBulkLoad ) {
+					data->counters.bytesBulkLoaded += expectedSize;
+				}
 				if( fetchBlockBytes > expectedSize ) {
 					holdingFKPL.release( fetchBlockBytes - expectedSize );
 				}
 
-				// Wait for permission to proceed
-				//wait( data->fetchKeysStorageWriteLock.take() );
-				//state FlowLock::Releaser holdingFKSWL( data->fetchKeysStorageWriteLock );
-
-				// Write this_block to storage
-				state KeyValueRef *kvItr = this_block.begin();
-				for(; kvItr != this_block.end(); ++kvItr) {
-					data->storage.writeKeyValue( *kvItr );
-					wait(yield());
-				}
-
-				kvItr = this_block.begin();
-				for(; kvItr != this_block.end(); ++kvItr) {
-					data->byteSampleApplySet( *kvItr, invalidVersion );
-					wait(yield());
-				}
+				progress->bytes += expectedSize;
+				progress->blocks++;
 
+				// Hand the rest of the range to a new fetchKeys before writing this block, so that fetching the next block
+				//  overlaps the writes below
 				if (this_block.more) {
 					Key nfk = this_block.readThrough.present() ? this_block.readThrough.get() : keyAfter( this_block.end()[-1].key );
 					if (nfk != keys.end) {
@@ -2081,7 +2451,9 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 						// This actor finishes committing the keys [keys.begin,nfk) that we already fetched.
 						// The remaining unfetched keys [nfk,keys.end) will become a separate AddingShard with its own fetchKeys.
 						shard->server->addShard( ShardInfo::addingSplitLeft( KeyRangeRef(keys.begin, nfk), shard ) );
-						shard->server->addShard( ShardInfo::newAdding( data, KeyRangeRef(nfk, keys.end) ) );
+						ShardInfo* remainder = ShardInfo::newAdding( data, KeyRangeRef(nfk, keys.end) );
+						remainder->adding->progress = progress;
+						shard->server->addShard( remainder );
 						shard = data->shards.rangeContaining( keys.begin ).value()->adding;
 						state AddingShard* otherShard = data->shards.rangeContaining( nfk ).value()->adding;
 						keys = shard->keys;
@@ -2106,6 +2478,28 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 					}
 				}
 
+				// Wait for permission to proceed
+				//wait( data->fetchKeysStorageWriteLock.take() );
+				//state FlowLock::Releaser holdingFKSWL( data->fetchKeysStorageWriteLock );
+
+				// Write this_block to storage
+				state KeyValueRef *kvItr = this_block.begin();
+				for(; kvItr != this_block.end(); ++kvItr) {
+					data->storage.writeKeyValue( *kvItr );
+					wait(yield());
+				}
+
+				kvItr = this_block.begin();
+				for(; kvItr != this_block.end(); ++kvItr) {
+					data->byteSampleApplySet( *kvItr, invalidVersion );
+					wait(yield());
+				}
+
+				if( isBulkLoad ) {
+					// The source servers keep serving the range, without this data, until the move carrying it commits
+					setBulkLoadVisibleVersion( data, keys, latestVersion );
+				}
+
 				this_block = Standalone<RangeResultRef>();
 
 				if (BUGGIFY) wait( delay( 1 ) );
@@ -2134,6 +2528,11 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 					}
 				} else if (e.code() == error_code_future_version || e.code() == error_code_process_behind) {
 					TEST(true); // fetchKeys got future_version or process_behind, so there must be a huge storage lag somewhere.  Keep trying.
+				} else if (isBulkLoad && e.code() != error_code_actor_cancelled) {
+					TEST(true); // fetchKeys failed to read a bulk load file.  Keep trying.
+					TraceEvent(SevWarnAlways, "FetchKeysBulkLoadFailed", data->thisServerID).error(e).suppressFor(60.0).detail("FKID", interval.pairID)
+						.detail("KeyBegin", keys.begin).detail("KeyEnd", keys.end);
+					isBulkLoad = false;
 				} else {
 					throw;
 				}
@@ -2147,6 +2546,7 @@ ACTOR Future<Void> fetchKeys( StorageServer *data, AddingShard* shard ) {
 		// We have completed the fetch and write of the data, now we wait for MVCC window to pass.
 		//  As we have finished this work, we will allow more work to start...
 		shard->fetchComplete.send(Void());
+		progress.clear();
 
 		TraceEvent(SevDebug, "FKBeforeFinalCommit", data->thisServerID).detail("FKID", interval.pairID).detail("SV", data->storageVersion()).detail("DV", data->durableVersion.get());
 		// Directly commit()ing the IKVS would interfere with updateStorage, possibly resulting in an incomplete version being recovered.
@@ -2387,8 +2787,12 @@ void changeServerKeys( StorageServer* data, const KeyRangeRef& keys, bool nowAss
 				setAvailableStatus(data, range, true);
 			} else {
 				auto& shard = data->shards[range.begin];
-				if( !shard->assigned() || shard->keys != range )
+				if( !shard->assigned() || shard->keys != range ) {
+					// The registration of a bulk load interrupted by a restart is not replayed, so look it up
+					if( context == CSK_RESTORE )
+						data->bulkLoadRegistered = true;
 					data->addShard( ShardInfo::newAdding(data, range) );
+				}
 			}
 		} else {
 			changeNewestAvailable.emplace_back(range, latestVersion);
@@ -2399,8 +2803,10 @@ void changeServerKeys( StorageServer* data, const KeyRangeRef& keys, bool nowAss
 	for(auto r = changeNewestAvailable.begin(); r != changeNewestAvailable.end(); ++r)
 		data->newestAvailableVersion.insert( r->first, r->second );
 
-	if (!nowAssigned)
+	if (!nowAssigned) {
 		data->metrics.notifyNotReadable( keys );
+		setBulkLoadVisibleVersion( data, keys, 0 );
+	}
 
 	coalesceShards( data, KeyRangeRef(ranges[0].begin, ranges[ranges.size()-1].end) );
 
@@ -2471,6 +2877,7 @@ static const KeyRef persistID = LiteralStringRef( PERSIST_PREFIX "ID" );
 static const KeyRef persistVersion = LiteralStringRef( PERSIST_PREFIX "Version" );
 static const KeyRangeRef persistShardAssignedKeys = KeyRangeRef( LiteralStringRef( PERSIST_PREFIX "ShardAssigned/" ), LiteralStringRef( PERSIST_PREFIX "ShardAssigned0" ) );
 static const KeyRangeRef persistShardAvailableKeys = KeyRangeRef( LiteralStringRef( PERSIST_PREFIX "ShardAvailable/" ), LiteralStringRef( PERSIST_PREFIX "ShardAvailable0" ) );
+static const KeyRangeRef persistBulkLoadVisibleKeys = KeyRangeRef( LiteralStringRef( PERSIST_PREFIX "BulkLoadVisible/" ), LiteralStringRef( PERSIST_PREFIX "BulkLoadVisible0" ) );
 static const KeyRangeRef persistByteSampleKeys = KeyRangeRef( LiteralStringRef( PERSIST_PREFIX "BS/" ), LiteralStringRef( PERSIST_PREFIX "BS0" ) );
 static const KeyRangeRef persistByteSampleSampleKeys = KeyRangeRef( LiteralStringRef( PERSIST_PREFIX "BS/" PERSIST_PREFIX "BS/" ), LiteralStringRef( PERSIST_PREFIX "BS/" PERSIST_PREFIX "BS0" ) );
 static const KeyRef persistLogProtocol = LiteralStringRef(PERSIST_PREFIX "LogProtocol");
@@ -2537,6 +2944,13 @@ private:
 			startKey = m.param1;
 			nowAssigned = m.param2 != serverKeysFalse;
 			processedStartKey = true;
+		} else if (m.type == MutationRef::ClearRange && m.param1.substr(1).startsWith(bulkLoadPrefix)) {
+			// The move carrying a bulk load into this server has committed and cleared its registration
+			KeyRangeRef keys( m.param1.substr(1).removePrefix(bulkLoadPrefix), m.param2.substr(1).startsWith(bulkLoadPrefix) ? m.param2.substr(1).removePrefix(bulkLoadPrefix) : allKeys.end );
+			publishBulkLoad( data, keys, currentVersion );
+		} else if (m.type == MutationRef::SetValue && m.param1.substr(1).startsWith(bulkLoadPrefix)) {
+			// A range this server holds or is about to fetch has been registered for bulk load
+			data->bulkLoadRegistered = true;
 		} else if (m.type == MutationRef::SetValue && m.param1 == lastEpochEndPrivateKey) {
 			// lastEpochEnd transactions are guaranteed by the master to be alone in their own batch (version)
 			// That means we don't have to worry about the impact on changeServerKeys
@@ -2862,6 +3276,43 @@ ACTOR Future<Void> update( StorageServer* data, bool* pReceivedUpdate )
 	}
 }
 
+// Computes the values of the deferred atomic ops (see AtomicOpChain) in versions <= version, so that they can be made durable.
+// An op which starts a chain is folded over the value of its key in storage, which has not changed since the op was applied
+//   because otherwise the key would have been in versionedData and the op would not have been deferred.
+ACTOR Future<Void> resolveAtomicOps( StorageServer* data, Version version ) {
+	state std::vector<AtomicOpChain*> ops;
+	state std::vector<Future<Optional<Value>>> storageValues;
+
+	for(int i = 0; i < data->pendingAtomicOps.size() && data->pendingAtomicOps[i]->version <= version; i++) {
+		AtomicOpChain* op = data->pendingAtomicOps[i];
+		if (op->resolved) continue;
+		ops.push_back(op);
+		storageValues.push_back( op->prev ? Future<Optional<Value>>(Optional<Value>()) : data->storage.readValue(op->op.param1) );
+	}
+	if (ops.empty())
+		return Void();
+
+	wait( waitForAll(storageValues) );
+
+	// Ops are resolved in mutation log order, so the previous op in a chain has always been resolved already
+	for(int i = 0; i < ops.size(); i++) {
+		AtomicOpChain* op = ops[i];
+		ASSERT( !op->prev || op->prev->resolved );
+		auto mLV = data->getMutableMutationLog().find(op->version);
+		ASSERT( mLV != data->getMutableMutationLog().end() );
+
+		op->value = applyAtomicOp( op->op, op->prev ? Optional<ValueRef>(op->prev->value) : storageValues[i].get().castTo<ValueRef>(), mLV->second.arena() );
+		op->resolved = true;
+
+		// Only the newest op on the key updates the byte sample; if the key has been set or cleared since, that mutation already did
+		auto latest = data->data().atLatest().find(op->op.param1);
+		if (latest && latest->isAtomicOps() && latest->getAtomicOps() == op)
+			data->byteSampleApplySet( KeyValueRef(op->op.param1, op->value), op->version );
+	}
+
+	return Void();
+}
+
 ACTOR Future<Void> updateStorage(StorageServer* data) {
 	loop {
 		ASSERT( data->durableVersion.get() == data->storageVersion() );
@@ -2882,6 +3333,8 @@ ACTOR Future<Void> updateStorage(StorageServer* data) {
 		state Version desiredVersion = data->desiredOldestVersion.get();
 		state int64_t bytesLeft = SERVER_KNOBS->STORAGE_COMMIT_BYTES;
 
+		wait( resolveAtomicOps( data, desiredVersion ) );
+
 		// Write mutations to storage until we reach the desiredVersion or have written too much (bytesleft)
 		loop {
 			state bool done = data->storage.makeVersionMutationsDurable(newOldestVersion, desiredVersion, bytesLeft);
@@ -2994,6 +3447,37 @@ void setAssignedStatus( StorageServer* self, KeyRangeRef keys, bool nowAssigned
 	}
 }
 
+void setBulkLoadVisibleVersion( StorageServer* self, KeyRangeRef keys, Version version ) {
+	ASSERT( !keys.empty() );
+	// Nearly every shard is never bulk loaded, so don't log anything unless this changes a bulk loaded range
+	if (self->bulkLoadVisibleVersion.allEqual( keys, version ))
+		return;
+	self->bulkLoadVisibleVersion.insert( keys, version );
+
+	auto& mLV = self->addVersionToMutationLog( self->data().getLatestVersion() );
+	KeyRange visibleKeys = KeyRangeRef(
+		persistBulkLoadVisibleKeys.begin.toString() + keys.begin.toString(),
+		persistBulkLoadVisibleKeys.begin.toString() + keys.end.toString() );
+	self->addMutationToMutationLog( mLV, MutationRef( MutationRef::ClearRange, visibleKeys.begin, visibleKeys.end ) );
+	self->addMutationToMutationLog( mLV, MutationRef( MutationRef::SetValue, visibleKeys.begin, BinaryWriter::toValue( version, Unversioned() ) ) );
+	if (keys.end != allKeys.end) {
+		Version endVersion = self->bulkLoadVisibleVersion[ keys.end ];
+		self->addMutationToMutationLog( mLV, MutationRef( MutationRef::SetValue, visibleKeys.end, BinaryWriter::toValue( endVersion, Unversioned() ) ) );
+	}
+}
+
+void publishBulkLoad( StorageServer* self, KeyRangeRef keys, Version version ) {
+	std::vector<KeyRange> published;
+	auto r = self->bulkLoadVisibleVersion.intersectingRanges(keys);
+	for(auto i = r.begin(); i != r.end(); ++i)
+		if (i->value() == latestVersion)
+			published.push_back( keys & i->range() );
+	for(auto& range : published)
+		setBulkLoadVisibleVersion( self, range, version );
+	if (published.size())
+		TraceEvent("BulkLoadPublished", self->thisServerID).detail("KeyBegin", keys.begin).detail("KeyEnd", keys.end).detail("Version", version);
+}
+
 void StorageServerDisk::clearRange( KeyRangeRef keys ) {
 	storage->clear(keys);
 }
@@ -3019,6 +3503,12 @@ void StorageServerDisk::writeMutations( MutationListRef mutations, Version debug
 			storage->set( KeyValueRef(m->param1, m->param2) );
 		} else if (m->type == MutationRef::ClearRange) {
 			storage->clear( KeyRangeRef(m->param1, m->param2) );
+		} else if (isAtomicOp((MutationRef::Type) m->type)) {
+			// A deferred atomic op is written as the value resolveAtomicOps() computed for it
+			AtomicOpChain* op = data->pendingAtomicOps.front();
+			ASSERT( op->resolved && op->version == debugVersion && op->op.param1 == m->param1 );
+			data->pendingAtomicOps.pop_front();
+			storage->set( KeyValueRef(m->param1, op->value) );
 		}
 	}
 }
@@ -3075,13 +3565,22 @@ ACTOR Future<Void> applyByteSampleResult( StorageServer* data, IKeyValueStore* s
 			Key nextBegin = keyAfter(bs.back().key);
 			data->byteSampleClears.insert(KeyRangeRef(begin, nextBegin).removePrefix(persistByteSampleKeys.begin), true);
 			data->byteSampleClearsTooLarge.set(data->byteSampleClears.size() > SERVER_KNOBS->MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE);
+			if(!results) {
+				data->byteSampleRecovered.insert(KeyRangeRef(begin, nextBegin).removePrefix(persistByteSampleKeys.begin), true);
+				data->byteSampleRecoveryProgress.trigger();
+			}
 			begin = nextBegin;
 			if(begin == end) {
 				break;
 			}
 		} else {
-			data->byteSampleClears.insert(KeyRangeRef(begin.removePrefix(persistByteSampleKeys.begin), end == persistByteSampleKeys.end ? LiteralStringRef("\xff\xff\xff") : end.removePrefix(persistByteSampleKeys.begin)), true);
+			KeyRangeRef loaded(begin.removePrefix(persistByteSampleKeys.begin), end == persistByteSampleKeys.end ? LiteralStringRef("\xff\xff\xff") : end.removePrefix(persistByteSampleKeys.begin));
+			data->byteSampleClears.insert(loaded, true);
 			data->byteSampleClearsTooLarge.set(data->byteSampleClears.size() > SERVER_KNOBS->MAX_BYTE_SAMPLE_CLEAR_MAP_SIZE);
+			if(!results) {
+				data->byteSampleRecovered.insert(loaded, true);
+				data->byteSampleRecoveryProgress.trigger();
+			}
 			break;
 		}
 
@@ -3093,8 +3592,11 @@ ACTOR Future<Void> applyByteSampleResult( StorageServer* data, IKeyValueStore* s
 	return Void();
 }
 
+// Loads the byte sample from storage in BYTE_SAMPLE_LOAD_PARALLELISM ranges of roughly equal size (according to the sample of the byte sample).
+// Each range becomes usable for metrics as soon as it has been loaded, see byteSampleRangeRecovered().
 ACTOR Future<Void> restoreByteSample(StorageServer* data, IKeyValueStore* storage, Promise<Void> byteSampleSampleRecovered, Future<Void> startRestore) {
 	state std::vector<Standalone<VectorRef<KeyValueRef>>> byteSampleSample;
+	data->byteSampleRecoveryStart = now();
 	wait( applyByteSampleResult(data, storage, persistByteSampleSampleKeys.begin, persistByteSampleSampleKeys.end, &byteSampleSample) );
 	byteSampleSampleRecovered.send(Void());
 	wait( startRestore );
@@ -3132,6 +3634,9 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data, IKeyValueStore* storag
 	if( BUGGIFY )
 		wait( delay( deterministicRandom()->random01() * 10.0 ) );
 
+	data->byteSampleRecoveryTime = now() - data->byteSampleRecoveryStart;
+	TraceEvent("RecoveredByteSample", data->thisServerID).detail("Duration", data->byteSampleRecoveryTime);
+
 	return Void();
 }
 
@@ -3143,6 +3648,7 @@ ACTOR Future<bool> restoreDurableState( StorageServer* data, IKeyValueStore* sto
 	state Future<Optional<Value>> fPrimaryLocality = storage->readValue(persistPrimaryLocality);
 	state Future<Standalone<VectorRef<KeyValueRef>>> fShardAssigned = storage->readRange(persistShardAssignedKeys);
 	state Future<Standalone<VectorRef<KeyValueRef>>> fShardAvailable = storage->readRange(persistShardAvailableKeys);
+	state Future<Standalone<VectorRef<KeyValueRef>>> fBulkLoadVisible = storage->readRange(persistBulkLoadVisibleKeys);
 
 	state Promise<Void> byteSampleSampleRecovered;
 	state Promise<Void> startByteSampleRestore;
@@ -3150,7 +3656,7 @@ ACTOR Future<bool> restoreDurableState( StorageServer* data, IKeyValueStore* sto
 
 	TraceEvent("ReadingDurableState", data->thisServerID);
 	wait( waitForAll( (vector<Future<Optional<Value>>>(), fFormat, fID, fVersion, fLogProtocol, fPrimaryLocality) ) );
-	wait( waitForAll( (vector<Future<Standalone<VectorRef<KeyValueRef>>>>(), fShardAssigned, fShardAvailable) ) );
+	wait( waitForAll( (vector<Future<Standalone<VectorRef<KeyValueRef>>>>(), fShardAssigned, fShardAvailable, fBulkLoadVisible) ) );
 	wait( byteSampleSampleRecovered.getFuture() );
 	TraceEvent("RestoringDurableState", data->thisServerID);
 
@@ -3193,6 +3699,18 @@ ACTOR Future<bool> restoreDurableState( StorageServer* data, IKeyValueStore* sto
 		wait(yield());
 	}
 
+	// Restored before the shard assignment, so that reads of a published bulk load at earlier versions stay rejected
+	state Standalone<VectorRef<KeyValueRef>> bulkLoadVisible = fBulkLoadVisible.get();
+	state int bulkLoadVisibleLoc;
+	for(bulkLoadVisibleLoc=0; bulkLoadVisibleLoc<bulkLoadVisible.size(); bulkLoadVisibleLoc++) {
+		KeyRangeRef keys(
+			bulkLoadVisible[bulkLoadVisibleLoc].key.removePrefix(persistBulkLoadVisibleKeys.begin),
+			bulkLoadVisibleLoc+1==bulkLoadVisible.size() ? allKeys.end : bulkLoadVisible[bulkLoadVisibleLoc+1].key.removePrefix(persistBulkLoadVisibleKeys.begin));
+		ASSERT( !keys.empty() );
+		data->bulkLoadVisibleVersion.insert( keys, BinaryReader::fromStringRef<Version>( bulkLoadVisible[bulkLoadVisibleLoc].value, Unversioned() ) );
+		wait(yield());
+	}
+
 	state Standalone<VectorRef<KeyValueRef>> assigned = fShardAssigned.get();
 	state int assignedLoc;
 	for(assignedLoc=0; assignedLoc<assigned.size(); assignedLoc++) {
@@ -3421,12 +3939,40 @@ Future<Void> StorageServerMetrics::waitMetrics(WaitMetricsRequest req, Future<Vo
 /////////////////////////////// Core //////////////////////////////////////
 #pragma region Core
 
+// Returns when the byte sample for keys has been loaded, so that metrics for keys are no longer underestimated
+ACTOR Future<Void> byteSampleRangeRecovered( StorageServer* self, KeyRange keys ) {
+	loop {
+		if (self->byteSampleRecovery.isReady() || self->byteSampleRecovered.allEqual(keys, true))
+			return Void();
+		wait( self->byteSampleRecoveryProgress.onTrigger() );
+	}
+}
+
+ACTOR Future<Void> waitMetricsQ( StorageServer* self, WaitMetricsRequest req ) {
+	wait( byteSampleRangeRecovered(self, req.keys) );
+	wait( self->metrics.waitMetrics( req, delayJittered( SERVER_KNOBS->STORAGE_METRIC_TIMEOUT ) ) );
+	return Void();
+}
+
+ACTOR Future<Void> splitMetricsQ( StorageServer* self, SplitMetricsRequest req ) {
+	wait( byteSampleRangeRecovered(self, req.keys) );
+	self->metrics.splitMetrics( req );
+	return Void();
+}
+
+ACTOR Future<Void> getPhysicalMetricsQ( StorageServer* self, GetPhysicalMetricsRequest req ) {
+	wait( self->byteSampleRecovery );
+	StorageBytes sb = self->storage.getStorageBytes();
+	self->metrics.getPhysicalMetrics( req, sb );
+	return Void();
+}
+
 ACTOR Future<Void> metricsCore( StorageServer* self, StorageServerInterface ssi ) {
 	state Future<Void> doPollMetrics = Void();
 	state ActorCollection actors(false);
 
-	wait( self->byteSampleRecovery );
-
+	// Requests for metrics are served while the byte sample is still being recovered, but only once the part of the sample they
+	// depend on has been loaded.  Otherwise data distribution would see shards which are too small and merge them.
 	actors.add(traceCounters("StorageMetrics", self->thisServerID, SERVER_KNOBS->STORAGE_LOGGING_DELAY, &self->counters.cc, self->thisServerID.toString() + "/StorageMetrics"));
 
 	loop {
@@ -3436,7 +3982,7 @@ ACTOR Future<Void> metricsCore( StorageServer* self, StorageServerInterface ssi
 					TEST( true );	// waitMetrics immediate wrong_shard_server()
 					self->sendErrorWithPenalty(req.reply, wrong_shard_server(), self->getPenalty());
 				} else {
-					actors.add( self->metrics.waitMetrics( req, delayJittered( SERVER_KNOBS->STORAGE_METRIC_TIMEOUT ) ) );
+					actors.add( waitMetricsQ( self, req ) );
 				}
 			}
 			when (SplitMetricsRequest req = waitNext(ssi.splitMetrics.getFuture())) {
@@ -3444,12 +3990,11 @@ ACTOR Future<Void> metricsCore( StorageServer* self, StorageServerInterface ssi
 					TEST( true );	// splitMetrics immediate wrong_shard_server()
 					self->sendErrorWithPenalty(req.reply, wrong_shard_server(), self->getPenalty());
 				} else {
-					self->metrics.splitMetrics( req );
+					actors.add( splitMetricsQ( self, req ) );
 				}
 			}
 			when (GetPhysicalMetricsRequest req = waitNext(ssi.getPhysicalMetrics.getFuture())) {
-				StorageBytes sb = self->storage.getStorageBytes();
-				self->metrics.getPhysicalMetrics( req, sb );
+				actors.add( getPhysicalMetricsQ( self, req ) );
 			}
 			when (wait(doPollMetrics) ) {
 				self->metrics.poll();
@@ -3585,6 +4130,9 @@ ACTOR Future<Void> storageServerCore( StorageServer* self, StorageServerInterfac
 			when( ReplyPromise<KeyValueStoreType> reply = waitNext(ssi.getKeyValueStoreType.getFuture()) ) {
 				reply.send( self->storage.getKeyValueStoreType() );
 			}
+			when( BackupShardRequest req = waitNext(ssi.backupShard.getFuture()) ) {
+				actors.add( backupShardQ( self, req ) );
+			}
 			when( wait(doUpdate) ) {
 				updateReceived = false;
 				if (!self->logSystem)
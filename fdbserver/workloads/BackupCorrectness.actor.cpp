@@ -23,6 +23,7 @@
 #include "fdbclient/BackupContainer.h"
 #include "fdbserver/workloads/workloads.actor.h"
 #include "fdbserver/workloads/BulkSetup.actor.h"
+#include "fdbserver/RestoreInterface.h"
 #include "flow/actorcompiler.h"  // This must be the last #include.
 
 
@@ -42,6 +43,9 @@ struct BackupAndRestoreCorrectnessWorkload : TestWorkload {
 	bool allowPauses;
 	bool shareLogRange;
 	bool shouldSkipRestoreRanges;
+	bool parallelRestore;
+	int parallelRestoreWorkers;
+	double restoreBytesPerSecond;
 
 	BackupAndRestoreCorrectnessWorkload(WorkloadContext const& wcx)
 		: TestWorkload(wcx) {
@@ -60,6 +64,9 @@ struct BackupAndRestoreCorrectnessWorkload : TestWorkload {
 		allowPauses = getOption(options, LiteralStringRef("allowPauses"), true);
 		shareLogRange = getOption(options, LiteralStringRef("shareLogRange"), false);
 		prefixesMandatory = getOption(options, LiteralStringRef("prefixesMandatory"), std::vector<std::string>());
+		parallelRestore = getOption(options, LiteralStringRef("parallelRestore"), false);
+		parallelRestoreWorkers = getOption(options, LiteralStringRef("parallelRestoreWorkers"), 3);
+		restoreBytesPerSecond = 0;
 		shouldSkipRestoreRanges = deterministicRandom()->random01() < 0.3 ? true : false;
 		
 		TraceEvent("BARW_ClientId").detail("Id", wcx.clientId);
@@ -176,6 +183,9 @@ struct BackupAndRestoreCorrectnessWorkload : TestWorkload {
 	}
 
 	virtual void getMetrics(vector<PerfMetric>& m) {
+		if (parallelRestore) {
+			m.push_back(PerfMetric("Restore Bytes/sec", restoreBytesPerSecond, false));
+		}
 	}
 
 	ACTOR static Future<Void> changePaused(Database cx, FileBackupAgent* backupAgent) {
@@ -326,6 +336,57 @@ struct BackupAndRestoreCorrectnessWorkload : TestWorkload {
 		return Void();
 	}
 
+	// Restores restoreRanges with restore workers running in this process and records their throughput
+	ACTOR static Future<Void> doParallelRestore(BackupAndRestoreCorrectnessWorkload* self, Database cx, std::string url, UID randomID) {
+		wait(runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr) -> Future<Void> {
+			for (auto &kvrange : self->backupRanges)
+				tr->clear(kvrange);
+			return Void();
+		}));
+
+		TraceEvent("BARW_ParallelRestore", randomID).detail("LastBackupContainer", url).detail("RestoreAfter", self->restoreAfter).detail("BackupTag", printable(self->backupTag));
+
+		state BackupDescription desc = wait(IBackupContainer::openContainer(url)->describeBackup());
+
+		// Restore to the latest restorable version, or sometimes to an earlier one
+		state Version targetVersion = invalidVersion;
+		if (desc.maxRestorableVersion.present() && deterministicRandom()->random01() < 0.5) {
+			targetVersion = deterministicRandom()->randomInt64(desc.minRestorableVersion.get(), desc.contiguousLogEnd.get());
+		}
+
+		state std::vector<Future<Void>> workers;
+		for (int i = 0; i < self->parallelRestoreWorkers; i++) {
+			workers.push_back(runRestoreWorker(cx));
+		}
+		// Give every worker time to register before the leader reads the worker list
+		wait(delay(5.0));
+
+		state RestoreRequest request;
+		request.randomUid = deterministicRandom()->randomUniqueID();
+		request.url = StringRef(url);
+		request.targetVersion = targetVersion;
+		request.ranges = self->restoreRanges;
+
+		state RestoreRequestResult result;
+		wait(store(result, submitParallelRestore(cx, request)) || waitForAll(workers));
+		self->restoreBytesPerSecond = result.elapsed > 0 ? result.bytes / result.elapsed : 0;
+		TraceEvent("BARW_ParallelRestoreComplete", randomID)
+			.detail("RestoredVersion", result.restoredVersion)
+			.detail("Bytes", result.bytes)
+			.detail("Elapsed", result.elapsed)
+			.detail("BytesPerSecond", self->restoreBytesPerSecond);
+
+		workers.clear();
+		wait(runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr) -> Future<Void> {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->clear(restoreLeaderKey);
+			tr->clear(restoreWorkersKeys);
+			tr->clear(restoreRequestDoneKey);
+			return Void();
+		}));
+		return Void();
+	}
+
 	/**
 		This actor attempts to restore the database without clearing the keyspace.
 	 */
@@ -428,7 +489,10 @@ struct BackupAndRestoreCorrectnessWorkload : TestWorkload {
 			TEST(!startRestore.isReady()); //Restore starts at specified time
 			wait(startRestore);
 			
-			if (lastBackupContainer && self->performRestore) {
+			if (lastBackupContainer && self->performRestore && self->parallelRestore) {
+				wait(doParallelRestore(self, cx, lastBackupContainer->getURL(), randomID));
+			}
+			else if (lastBackupContainer && self->performRestore) {
 				if (deterministicRandom()->random01() < 0.5) {
 					wait(attemptDirtyRestore(self, cx, &backupAgent, StringRef(lastBackupContainer->getURL()), randomID));
 				}
@@ -0,0 +1,159 @@
+/*
+ * BulkLoadRangeFiles.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2018 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/BackupAgent.actor.h"
+#include "fdbclient/BackupContainer.h"
+#include "fdbclient/ManagementAPI.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h"  // This must be the last #include.
+
+// Writes a single-version snapshot of range files into a backup container, loads it with bulkLoad(), and checks that
+// all of the data is visible afterwards and that it is never visible at read versions from before the load.
+struct BulkLoadRangeFilesWorkload : TestWorkload {
+	int nodeCount, valueBytes, fileCount, blockSize;
+	Key keyPrefix;
+	bool pass;
+
+	BulkLoadRangeFilesWorkload(WorkloadContext const& wcx)
+		: TestWorkload(wcx), pass(true) {
+
+		nodeCount = getOption(options, LiteralStringRef("nodeCount"), 1000);
+		valueBytes = getOption(options, LiteralStringRef("valueBytes"), 100);
+		fileCount = getOption(options, LiteralStringRef("fileCount"), deterministicRandom()->randomInt(1, 5));
+		blockSize = getOption(options, LiteralStringRef("blockSize"), deterministicRandom()->randomInt(1000, 100000));
+		keyPrefix = getOption(options, LiteralStringRef("keyPrefix"), LiteralStringRef("bulkLoadRangeFiles/"));
+	}
+
+	virtual std::string description() {
+		return "BulkLoadRangeFiles";
+	}
+
+	virtual Future<Void> setup(Database const& cx) {
+		return Void();
+	}
+
+	virtual Future<Void> start(Database const& cx) {
+		if (clientId != 0)
+			return Void();
+		return _start(cx, this);
+	}
+
+	virtual Future<bool> check(Database const& cx) {
+		return pass;
+	}
+
+	virtual void getMetrics(vector<PerfMetric>& m) {
+	}
+
+	Key keyForIndex(int n) {
+		return keyPrefix.withSuffix( format("%08d", n) );
+	}
+
+	Value valueForIndex(int n) {
+		return StringRef( format("%08d", n) + std::string(valueBytes, '.') );
+	}
+
+	// Writes nodeCount keys into fileCount range files of a single-version snapshot at version
+	ACTOR static Future<Void> writeSnapshot(Reference<IBackupContainer> bc, BulkLoadRangeFilesWorkload* self, Version version) {
+		state std::vector<std::string> fileNames;
+		state int64_t totalBytes = 0;
+		state int i = 0;
+		for(; i < self->fileCount; ++i) {
+			state int begin = (int64_t)i * self->nodeCount / self->fileCount;
+			state int end = (int64_t)(i + 1) * self->nodeCount / self->fileCount;
+			state Standalone<VectorRef<KeyValueRef>> data;
+			for(int n = begin; n < end; ++n)
+				data.push_back_deep( data.arena(), KeyValueRef(self->keyForIndex(n), self->valueForIndex(n)) );
+
+			state KeyRange range = KeyRangeRef( i == 0 ? self->keyPrefix : self->keyForIndex(begin),
+			                              i == self->fileCount - 1 ? strinc(self->keyPrefix) : self->keyForIndex(end) );
+			state Reference<IBackupFile> file = wait( bc->writeRangeFile(version, i, version, self->blockSize) );
+			wait( fileBackup::writeRangeFile(file, self->blockSize, range, data) );
+			fileNames.push_back( file->getFileName() );
+			totalBytes += file->size();
+		}
+		wait( bc->writeKeyspaceSnapshotFile(fileNames, totalBytes) );
+		return Void();
+	}
+
+	ACTOR static Future<Void> _start(Database cx, BulkLoadRangeFilesWorkload* self) {
+		state std::string containerUrl = "file://simfdb/backups/bulkload-" + deterministicRandom()->randomUniqueID().toString();
+		state Reference<IBackupContainer> bc = IBackupContainer::openContainer(containerUrl);
+		state KeyRange keys = prefixRange(self->keyPrefix);
+		wait( bc->create() );
+		wait( writeSnapshot(bc, self, deterministicRandom()->randomInt64(1, 1e9)) );
+
+		state Transaction tr(cx);
+		state Version beforeVersion = wait( tr.getReadVersion() );
+		TraceEvent("BulkLoadRangeFiles_Start").detail("Container", containerUrl).detail("Files", self->fileCount).detail("BlockSize", self->blockSize);
+		try {
+			wait( bulkLoad(cx, containerUrl, keys) );
+		} catch( Error &e ) {
+			if( e.code() != error_code_bulk_load_no_destination )
+				throw;
+			TEST(true); // Bulk load on a cluster too small to move the data to a new team
+			return Void();
+		}
+		TraceEvent("BulkLoadRangeFiles_Loaded");
+
+		// All of the data is visible after the load
+		tr = Transaction(cx);
+		loop {
+			try {
+				Standalone<RangeResultRef> loaded = wait( tr.getRange(keys, CLIENT_KNOBS->TOO_MANY) );
+				ASSERT( !loaded.more );
+				if( loaded.size() != self->nodeCount ) {
+					TraceEvent(SevError, "BulkLoadRangeFiles_WrongCount").detail("Expected", self->nodeCount).detail("Actual", loaded.size());
+					self->pass = false;
+				}
+				for(int n = 0; n < loaded.size() && n < self->nodeCount; ++n) {
+					if( loaded[n].key != self->keyForIndex(n) || loaded[n].value != self->valueForIndex(n) ) {
+						TraceEvent(SevError, "BulkLoadRangeFiles_WrongData").detail("Index", n).detail("Key", loaded[n].key);
+						self->pass = false;
+						break;
+					}
+				}
+				break;
+			} catch( Error &e ) {
+				wait( tr.onError(e) );
+			}
+		}
+
+		// Reads from before the load never see any of the data
+		tr = Transaction(cx);
+		tr.setVersion(beforeVersion);
+		try {
+			Standalone<RangeResultRef> before = wait( tr.getRange(keys, 1) );
+			if( before.size() ) {
+				TraceEvent(SevError, "BulkLoadRangeFiles_VisibleBeforeLoad").detail("Version", beforeVersion).detail("Key", before[0].key);
+				self->pass = false;
+			}
+		} catch( Error &e ) {
+			if( e.code() != error_code_transaction_too_old )
+				throw;
+			TEST(true); // Read from before a bulk load rejected
+		}
+
+		TraceEvent("BulkLoadRangeFiles_Done").detail("Pass", self->pass);
+		return Void();
+	}
+};
+
+WorkloadFactory<BulkLoadRangeFilesWorkload> BulkLoadRangeFilesWorkloadFactory("BulkLoadRangeFiles");
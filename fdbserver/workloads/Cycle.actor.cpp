@@ -29,6 +29,7 @@ struct CycleWorkload : TestWorkload {
 	double testDuration, transactionsPerSecond, minExpectedTransactionsPerSecond;
 	Key		keyPrefix;
 	bool checkOnly;
+	int64_t readVersionStalenessMs;
 
 	vector<Future<Void>> clients;
 	PerfIntCounter transactions, retries, tooOldRetries, commitFailedRetries;
@@ -46,6 +47,7 @@ struct CycleWorkload : TestWorkload {
 		keyPrefix = getOption(options, LiteralStringRef("keyPrefix"), LiteralStringRef(""));
 		minExpectedTransactionsPerSecond = transactionsPerSecond * getOption(options, LiteralStringRef("expectedRate"), 0.7);
 		checkOnly = getOption(options, LiteralStringRef("checkOnly"), false);
+		readVersionStalenessMs = getOption(options, LiteralStringRef("readVersionStalenessMs"), 0);
 	}
 
 	virtual std::string description() { return "CycleWorkload"; }
@@ -101,6 +103,9 @@ struct CycleWorkload : TestWorkload {
 				state double tstart = now();
 				state int r = deterministicRandom()->randomInt(0, self->nodeCount);
 				state Transaction tr(cx);
+				if (self->readVersionStalenessMs > 0) {
+					tr.setOption(FDBTransactionOptions::READ_VERSION_MAX_STALENESS, StringRef((uint8_t*)&self->readVersionStalenessMs, sizeof(int64_t)));
+				}
 				while (true) {
 					try {
 						// Reverse next and next^2 node
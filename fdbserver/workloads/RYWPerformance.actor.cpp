@@ -279,6 +279,12 @@ struct RYWPerformanceWorkload : TestWorkload {
 			if( i == 13 ) fprintf(stderr, "\n");
 			else fprintf(stderr, ", ");
 		}
+		fprintf(stderr, "test_get_range_write_set, ");
+		for( i = 0; i < 4; i++ ) {
+			wait( self->test_get_range_basic( cx, self, i ) );
+			if( i == 3 ) fprintf(stderr, "\n");
+			else fprintf(stderr, ", ");
+		}
 		fprintf(stderr, "test_interleaved_sets_gets, ");
 		for( i = 0; i < 14; i++ ) {
 			wait( self->test_interleaved_sets_gets( cx, self, i ) );
@@ -0,0 +1,141 @@
+/*
+ * ReadCache.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2019 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbclient/ReadYourWrites.h"
+#include "fdbclient/SystemData.h"
+#include "fdbserver/TesterInterface.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h"  // This must be the last #include.
+
+// Writers change cached keys and uncached mirror keys to the same values in one transaction, updating the metadata
+// version as required.  Readers using the database read cache must always see a cached key equal to its mirror.
+struct ReadCacheWorkload : TestWorkload {
+	double testDuration;
+	int keyCount, readers;
+	double writeDelay;
+	Key cachedPrefix, mirrorPrefix;
+
+	Database cachedCx;
+	vector<Future<Void>> clients;
+	PerfIntCounter reads, writes, mismatches;
+
+	ReadCacheWorkload(WorkloadContext const& wcx)
+		: TestWorkload(wcx), reads("Reads"), writes("Writes"), mismatches("Mismatches")
+	{
+		testDuration = getOption( options, LiteralStringRef("testDuration"), 10.0 );
+		keyCount = getOption( options, LiteralStringRef("keyCount"), 10 );
+		readers = getOption( options, LiteralStringRef("readersPerClient"), 5 );
+		writeDelay = getOption( options, LiteralStringRef("writeDelay"), 0.5 );
+		cachedPrefix = LiteralStringRef("readCache/cached/");
+		mirrorPrefix = LiteralStringRef("readCache/mirror/");
+	}
+
+	virtual std::string description() { return "ReadCache"; }
+
+	virtual Future<Void> setup( Database const& cx ) {
+		return Void();
+	}
+
+	virtual Future<Void> start( Database const& cx ) {
+		cachedCx = cx->clone();
+		cachedCx->setOption(FDBDatabaseOptions::READ_CACHE_PREFIX, Optional<StringRef>(cachedPrefix));
+
+		if(clientId == 0)
+			clients.push_back(timeout(writer(cx->clone(), this), testDuration, Void()));
+		for(int i = 0; i < readers; i++)
+			clients.push_back(timeout(reader(cachedCx, this), testDuration, Void()));
+		return waitForAll(clients);
+	}
+
+	virtual Future<bool> check( Database const& cx ) {
+		int errors = 0;
+		for(auto &c : clients)
+			errors += c.isError();
+		if(errors)
+			TraceEvent(SevError, "TestFailure").detail("Reason", "There were client errors.");
+		clients.clear();
+
+		TraceEvent("ReadCacheCheck").detail("Hits", cachedCx->transactionReadCacheHits.getValue())
+			.detail("Misses", cachedCx->transactionReadCacheMisses.getValue()).detail("Mismatches", mismatches.getValue());
+		return !errors && mismatches.getValue() == 0;
+	}
+
+	virtual void getMetrics( vector<PerfMetric>& m ) {
+		m.push_back( reads.getMetric() );
+		m.push_back( writes.getMetric() );
+		m.push_back( mismatches.getMetric() );
+		if(cachedCx.getPtr())
+			m.push_back( PerfMetric( "Read cache hits", cachedCx->transactionReadCacheHits.getValue(), false ) );
+	}
+
+	Key keyFor( Key const& prefix, int i ) const {
+		return prefix.withSuffix(format("%08d", i));
+	}
+
+	ACTOR static Future<Void> writer( Database cx, ReadCacheWorkload *self ) {
+		state int64_t n = 0;
+		loop {
+			state ReadYourWritesTransaction tr(cx);
+			state int i = deterministicRandom()->randomInt(0, self->keyCount);
+			state Value value = StringRef(format("%lld", ++n));
+			loop {
+				try {
+					tr.set(self->keyFor(self->cachedPrefix, i), value);
+					tr.set(self->keyFor(self->mirrorPrefix, i), value);
+					tr.atomicOp(metadataVersionKey, metadataVersionRequiredValue, MutationRef::SetVersionstampedValue);
+					wait(tr.commit());
+					++self->writes;
+					break;
+				} catch(Error &e) {
+					wait(tr.onError(e));
+				}
+			}
+			wait(delay(self->writeDelay * deterministicRandom()->random01()));
+		}
+	}
+
+	ACTOR static Future<Void> reader( Database cx, ReadCacheWorkload *self ) {
+		loop {
+			state ReadYourWritesTransaction tr(cx);
+			state int i = deterministicRandom()->randomInt(0, self->keyCount);
+			loop {
+				try {
+					state Future<Optional<Value>> cached = tr.get(self->keyFor(self->cachedPrefix, i));
+					state Optional<Value> mirror = wait(tr.get(self->keyFor(self->mirrorPrefix, i)));
+					Optional<Value> cachedValue = wait(cached);
+					if(cachedValue != mirror) {
+						TraceEvent(SevError, "ReadCacheMismatch").detail("Key", self->keyFor(self->cachedPrefix, i))
+							.detail("Cached", cachedValue.present() ? cachedValue.get() : LiteralStringRef("<missing>"))
+							.detail("Mirror", mirror.present() ? mirror.get() : LiteralStringRef("<missing>"));
+						++self->mismatches;
+					}
+					++self->reads;
+					break;
+				} catch(Error &e) {
+					wait(tr.onError(e));
+				}
+			}
+			wait(delay(0.01));
+		}
+	}
+};
+
+WorkloadFactory<ReadCacheWorkload> ReadCacheWorkloadFactory("ReadCache");
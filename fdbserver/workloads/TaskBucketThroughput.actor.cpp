@@ -0,0 +1,128 @@
+/*
+ * TaskBucketThroughput.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2019 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/TaskBucket.h"
+#include "fdbclient/ReadYourWrites.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h"  // This must be the last #include.
+
+struct NoOpTaskFunc : TaskFuncBase {
+	static StringRef name;
+	static constexpr uint32_t version = 1;
+
+	StringRef getName() const { return name; };
+	Future<Void> execute(Database cx, Reference<TaskBucket> tb, Reference<FutureBucket> fb, Reference<Task> task) { return Void(); };
+	Future<Void> finish(Reference<ReadYourWritesTransaction> tr, Reference<TaskBucket> tb, Reference<FutureBucket> fb, Reference<Task> task) { return tb->finish(tr, task); };
+};
+StringRef NoOpTaskFunc::name = LiteralStringRef("TaskBucketThroughputNoOp");
+REGISTER_TASKFUNC(NoOpTaskFunc);
+
+// Fills a task bucket with tasks that do nothing and measures how quickly agentsPerClient agents on each client, each
+// running up to maxConcurrentTasks tasks, empty it.
+struct TaskBucketThroughputWorkload : TestWorkload {
+	int taskCount, tasksPerTransaction, agentsPerClient, maxConcurrentTasks;
+	double pollDelay;
+	double elapsed;
+
+	Reference<TaskBucket> taskBucket;
+	Reference<FutureBucket> futureBucket;
+
+	TaskBucketThroughputWorkload(WorkloadContext const& wcx)
+		: TestWorkload(wcx), elapsed(0)
+	{
+		taskCount = getOption( options, LiteralStringRef("taskCount"), 10000 );
+		tasksPerTransaction = getOption( options, LiteralStringRef("tasksPerTransaction"), 100 );
+		agentsPerClient = getOption( options, LiteralStringRef("agentsPerClient"), 10 );
+		maxConcurrentTasks = getOption( options, LiteralStringRef("maxConcurrentTasks"), 20 );
+		pollDelay = getOption( options, LiteralStringRef("pollDelay"), 0.1 );
+
+		Subspace taskSubspace(LiteralStringRef("taskBucketThroughput"));
+		taskBucket = Reference<TaskBucket>(new TaskBucket(taskSubspace.get(LiteralStringRef("tasks"))));
+		futureBucket = Reference<FutureBucket>(new FutureBucket(taskSubspace.get(LiteralStringRef("futures"))));
+	}
+
+	virtual std::string description() { return "TaskBucketThroughput"; }
+
+	virtual Future<Void> setup( Database const& cx ) {
+		if(clientId != 0)
+			return Void();
+		return _setup(cx, this);
+	}
+
+	virtual Future<Void> start( Database const& cx ) {
+		return _start(cx, this);
+	}
+
+	virtual Future<bool> check( Database const& cx ) {
+		return taskBucket->isEmpty(cx);
+	}
+
+	virtual void getMetrics( vector<PerfMetric>& m ) {
+		if(clientId != 0)
+			return;
+		m.push_back( PerfMetric( "Agents", agentsPerClient * clientCount, false ) );
+		m.push_back( PerfMetric( "Tasks", taskCount, false ) );
+		m.push_back( PerfMetric( "Tasks per second", elapsed > 0 ? taskCount / elapsed : 0, false ) );
+	}
+
+	ACTOR static Future<Void> _setup( Database cx, TaskBucketThroughputWorkload *self ) {
+		state int added = 0;
+
+		wait(self->taskBucket->clear(cx));
+		while(added < self->taskCount) {
+			state int count = std::min(self->tasksPerTransaction, self->taskCount - added);
+			wait(runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr) {
+				self->taskBucket->setOptions(tr);
+				for(int i = 0; i < count; i++) {
+					Reference<Task> task(new Task(NoOpTaskFunc::name, NoOpTaskFunc::version, StringRef(), deterministicRandom()->randomInt(0, 2)));
+					self->taskBucket->addTask(tr, task);
+				}
+				return Future<Void>(Void());
+			}));
+			added += count;
+		}
+
+		// Agents only run tasks while the bucket is unpaused
+		wait(self->taskBucket->changePause(cx, false));
+		return Void();
+	}
+
+	ACTOR static Future<Void> _start( Database cx, TaskBucketThroughputWorkload *self ) {
+		state double startTime = now();
+		state std::vector<Future<Void>> agents;
+
+		for(int i = 0; i < self->agentsPerClient; i++)
+			agents.push_back(self->taskBucket->run(cx, self->futureBucket, &self->pollDelay, self->maxConcurrentTasks));
+
+		loop {
+			bool isEmpty = wait(self->taskBucket->isEmpty(cx));
+			if(isEmpty)
+				break;
+			wait(delay(0.1) || waitForAll(agents));
+		}
+
+		self->elapsed = now() - startTime;
+		TraceEvent("TaskBucketThroughput").detail("ClientId", self->clientId).detail("Agents", self->agentsPerClient * self->clientCount)
+			.detail("Tasks", self->taskCount).detail("Elapsed", self->elapsed);
+		return Void();
+	}
+};
+
+WorkloadFactory<TaskBucketThroughputWorkload> TaskBucketThroughputWorkloadFactory("TaskBucketThroughput");
@@ -19,6 +19,8 @@
  */
 
 #include "fdbrpc/ActorFuzz.h"
+#include "fdbclient/CommitTransaction.h"
+#include "fdbserver/LogSystem.h"
 #include "fdbserver/TesterInterface.actor.h"
 #include "fdbserver/workloads/workloads.actor.h"
 #include "flow/actorcompiler.h" // has to be last include
@@ -47,18 +49,111 @@ ACTOR Future<Void> unitPerfTest() {
 	return Void();
 }
 
+// Compares framing mutations for TLogs by serializing them once per TLog against serializing once and copying, and
+// parsing message headers field by field against in bulk.
+void tlogMessagePerfTest(int messageCount, int locations, int tagsPerMessage) {
+	Arena arena;
+	std::vector<MutationRef> mutations;
+	for(int i = 0; i < messageCount; i++) {
+		mutations.push_back(MutationRef(MutationRef::SetValue, StringRef(arena, format("key%08d", i)),
+		                                StringRef(arena, std::string(deterministicRandom()->randomInt(10, 100), 'v'))));
+	}
+	std::vector<Tag> tags;
+	for(int i = 0; i < tagsPerMessage; i++)
+		tags.push_back(Tag(0, i));
+
+	std::vector<BinaryWriter> perLocation, copied;
+	for(int i = 0; i < locations; i++) {
+		perLocation.push_back(BinaryWriter(AssumeVersion(currentProtocolVersion)));
+		copied.push_back(BinaryWriter(AssumeVersion(currentProtocolVersion)));
+	}
+
+	double start = timer();
+	for(int i = 0; i < messageCount; i++) {
+		for(auto& wr : perLocation) {
+			int offset = wr.getLength();
+			wr << uint32_t(0) << uint32_t(i + 1) << uint16_t(tags.size());
+			for(auto& tag : tags)
+				wr << tag;
+			wr << mutations[i];
+			*(uint32_t*)((uint8_t*)wr.getData() + offset) = wr.getLength() - offset - sizeof(uint32_t);
+		}
+	}
+	double perLocationEncode = timer() - start;
+
+	start = timer();
+	for(int i = 0; i < messageCount; i++) {
+		StringRef message = writeTLogMessage(copied[0], i + 1, tags, mutations[i]);
+		for(int loc = 1; loc < locations; loc++)
+			copied[loc].serializeBytes(message);
+	}
+	double copiedEncode = timer() - start;
+
+	Standalone<StringRef> messages = copied[0].toValue();
+	ASSERT(messages == perLocation[0].toValue());
+
+	std::vector<Tag> readTags;
+	int64_t tagTotal = 0;
+	start = timer();
+	{
+		ArenaReader rd(messages.arena(), messages, AssumeVersion(currentProtocolVersion));
+		while(!rd.empty()) {
+			int32_t length;
+			uint32_t sub;
+			uint16_t tagCount;
+			rd >> length >> sub >> tagCount;
+			readTags.resize(tagCount);
+			for(int i = 0; i < tagCount; i++)
+				rd >> readTags[i];
+			tagTotal += tagCount;
+			rd.readBytes(length - sizeof(sub) - sizeof(tagCount) - tagCount*sizeof(Tag));
+		}
+	}
+	double fieldDecode = timer() - start;
+
+	start = timer();
+	{
+		ArenaReader rd(messages.arena(), messages, AssumeVersion(currentProtocolVersion));
+		while(!rd.empty()) {
+			uint32_t sub;
+			int32_t length = readTLogMessageHeader(rd, sub, readTags);
+			tagTotal -= readTags.size();
+			rd.readBytes(length);
+		}
+	}
+	double bulkDecode = timer() - start;
+	ASSERT(tagTotal == 0);
+
+	TraceEvent("TLogMessagePerf").detail("Messages", messageCount).detail("Locations", locations).detail("Tags", tagsPerMessage)
+		.detail("PerLocationEncode", perLocationEncode).detail("CopiedEncode", copiedEncode)
+		.detail("FieldDecode", fieldDecode).detail("BulkDecode", bulkDecode);
+	printf("TLog messages: %d messages to %d locations with %d tags\n", messageCount, locations, tagsPerMessage);
+	printf("  encode per location: %.3fs  encode once and copy: %.3fs\n", perLocationEncode, copiedEncode);
+	printf("  decode by field:     %.3fs  decode in bulk:       %.3fs\n", fieldDecode, bulkDecode);
+}
+
 struct UnitPerfWorkload : TestWorkload {
 	bool enabled;
+	bool tlogMessages;
+	int messageCount, locations, tagsPerMessage;
 
 	UnitPerfWorkload(WorkloadContext const& wcx)
 		: TestWorkload(wcx)
 	{
 		enabled = !clientId; // only do this on the "first" client
+		tlogMessages = getOption( options, LiteralStringRef("tlogMessages"), false );
+		messageCount = getOption( options, LiteralStringRef("messageCount"), 1000000 );
+		locations = getOption( options, LiteralStringRef("locations"), 3 );
+		tagsPerMessage = getOption( options, LiteralStringRef("tagsPerMessage"), 3 );
 	}
 
 	virtual std::string description() { return "UnitPerfWorkload"; }
 	virtual Future<Void> setup( Database const& cx ) { return Void(); }
 	virtual Future<Void> start( Database const& cx ) {
+		if (enabled && tlogMessages) {
+			tlogMessagePerfTest(messageCount, locations, tagsPerMessage);
+			return Void();
+		}
 		if (enabled)
 			return unitPerfTest();
 		return Void();
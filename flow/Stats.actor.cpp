@@ -19,6 +19,7 @@
  */
 
 #include "flow/Stats.h"
+#include "flow/UnitTest.h"
 #include "flow/actorcompiler.h" // has to be last include
 
 Counter::Counter(std::string const& name, CounterCollection& collection)
@@ -98,3 +99,99 @@ ACTOR Future<Void> traceCounters(std::string traceEventName, UID traceEventID, d
 		wait(delay(interval));
 	}
 }
+
+LatencyHistogram::LatencyHistogram(std::string const& name, std::string const& collectionName, UID id)
+  : name(name), count(0), sum(0), maxMeasurement(0)
+{
+	memset(buckets, 0, sizeof(buckets));
+
+	std::string metricPrefix = collectionName + "." + name;
+	countMetric.init(metricPrefix + "Count", id.toString());
+	p50Metric.init(metricPrefix + "P50Micros", id.toString());
+	p99Metric.init(metricPrefix + "P99Micros", id.toString());
+	p999Metric.init(metricPrefix + "P999Micros", id.toString());
+	maxMetric.init(metricPrefix + "MaxMicros", id.toString());
+}
+
+double LatencyHistogram::percentile(double p) const {
+	if(count == 0) {
+		return 0;
+	}
+
+	int64_t rank = std::max<int64_t>(1, std::ceil(p * count));
+	int64_t seen = 0;
+	for(int b = 0; b < BUCKETS; b++) {
+		seen += buckets[b];
+		if(seen >= rank) {
+			// The midpoint of the last bucket can exceed the largest measurement in it
+			return std::min(bucketValue(b), maxMeasurement);
+		}
+	}
+
+	return maxMeasurement;
+}
+
+void LatencyHistogram::logToTraceEvent(TraceEvent& te) {
+	double p50 = percentile(0.5), p90 = percentile(0.9), p99 = percentile(0.99), p999 = percentile(0.999);
+
+	te.detail((name + "Count").c_str(), count);
+	te.detail((name + "Mean").c_str(), count ? sum / count : 0);
+	te.detail((name + "Median").c_str(), p50);
+	te.detail((name + "P90").c_str(), p90);
+	te.detail((name + "P99").c_str(), p99);
+	te.detail((name + "P99.9").c_str(), p999);
+	te.detail((name + "Max").c_str(), maxMeasurement);
+
+	countMetric = count;
+	p50Metric = int64_t(p50 * 1e6);
+	p99Metric = int64_t(p99 * 1e6);
+	p999Metric = int64_t(p999 * 1e6);
+	maxMetric = int64_t(maxMeasurement * 1e6);
+
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	sum = 0;
+	maxMeasurement = 0;
+}
+
+ACTOR Future<Void> traceLatencyHistograms(std::string traceEventName, UID traceEventID, double interval, std::vector<LatencyHistogram*> histograms, std::string trackLatestName) {
+	state double last_interval = now();
+
+	loop {
+		wait(delay(interval));
+
+		TraceEvent te(traceEventName.c_str(), traceEventID);
+		te.detail("Elapsed", now() - last_interval);
+
+		for(auto h : histograms) {
+			h->logToTraceEvent(te);
+		}
+
+		if (!trackLatestName.empty()) {
+			te.trackLatest(trackLatestName.c_str());
+		}
+
+		last_interval = now();
+	}
+}
+
+TEST_CASE("/flow/LatencyHistogram/percentiles") {
+	LatencyHistogram h("Test", "LatencyHistogramTest", UID());
+	ASSERT(h.percentile(0.5) == 0);
+
+	// Latencies spread uniformly over [1us, 10s)
+	std::vector<double> measurements;
+	for(int i = 0; i < 100000; i++) {
+		measurements.push_back(std::pow(10.0, deterministicRandom()->random01() * 7 - 6));
+		h.addMeasurement(measurements.back());
+	}
+	std::sort(measurements.begin(), measurements.end());
+
+	for(double p : { 0.01, 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+		double exact = measurements[std::max<int>(0, std::ceil(p * measurements.size()) - 1)];
+		double estimate = h.percentile(p);
+		ASSERT(std::abs(estimate - exact) <= exact / 32 + 1e-6);
+	}
+
+	return Void();
+}
@@ -141,6 +141,69 @@ static void specialCounter(CounterCollection& collection, std::string const& nam
 
 Future<Void> traceCounters(std::string const& traceEventName, UID const& traceEventID, double const& interval, CounterCollection* const& counters, std::string const& trackLatestName = std::string());
 
+// Counts latency measurements in logarithmically spaced buckets, each 1/32 of a power of two wide, so that percentiles
+// are accurate to within about 3% using a fixed amount of memory and constant work per measurement, however many
+// measurements are added.  Measurements are in seconds and are bucketed with microsecond resolution.
+class LatencyHistogram : NonCopyable {
+public:
+	LatencyHistogram(std::string const& name, std::string const& collectionName, UID id);
+
+	// Adds a measurement which was shared by times events, such as the transactions in a batch
+	void addMeasurement(double seconds, int64_t times = 1) {
+		if(times <= 0) {
+			return;
+		}
+		uint64_t micros = seconds > 0 ? std::min<uint64_t>(seconds * 1e6, MAX_MICROS) : 0;
+		buckets[bucketFor(micros)] += times;
+		count += times;
+		sum += seconds * times;
+		maxMeasurement = std::max(maxMeasurement, seconds);
+	}
+
+	int64_t getCount() const { return count; }
+
+	// Returns an estimate of the latency below which the fraction p of the measurements in this interval fall
+	double percentile(double p) const;
+
+	// Adds the count, mean, maximum and percentiles of this interval to te, prefixed with the histogram's name, updates
+	// their metrics and starts a new interval
+	void logToTraceEvent(TraceEvent& te);
+
+private:
+	enum { SUB_BUCKET_BITS = 5, SUB_BUCKETS = 1 << SUB_BUCKET_BITS, MAX_MICROS_BITS = 40,
+		BUCKETS = (MAX_MICROS_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS };
+	static constexpr uint64_t MAX_MICROS = (uint64_t(1) << MAX_MICROS_BITS) - 1;
+
+	// Values below SUB_BUCKETS have a bucket each.  Above that, each power of two is split into SUB_BUCKETS buckets.
+	static int bucketFor(uint64_t micros) {
+		if(micros < SUB_BUCKETS) {
+			return micros;
+		}
+		int shift = 63 - clzll(micros) - SUB_BUCKET_BITS;
+		return (shift + 1) * SUB_BUCKETS + (micros >> shift) - SUB_BUCKETS;
+	}
+	// Returns the midpoint of a bucket, in seconds
+	static double bucketValue(int bucket) {
+		if(bucket < SUB_BUCKETS) {
+			return bucket * 1e-6;
+		}
+		int shift = bucket / SUB_BUCKETS - 1;
+		uint64_t lower = uint64_t(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+		return (lower + ((uint64_t(1) << shift) - 1) / 2.0) * 1e-6;
+	}
+
+	std::string name;
+	int64_t buckets[BUCKETS];
+	int64_t count;
+	double sum;
+	double maxMeasurement;
+
+	Int64MetricHandle countMetric, p50Metric, p99Metric, p999Metric, maxMetric;
+};
+
+// Logs the given histograms as one trace event every interval
+Future<Void> traceLatencyHistograms(std::string const& traceEventName, UID const& traceEventID, double const& interval, std::vector<LatencyHistogram*> const& histograms, std::string const& trackLatestName = std::string());
+
 class LatencyBands {
 public:
 	LatencyBands(std::string name, UID id, double loggingInterval) : name(name), id(id), loggingInterval(loggingInterval), cc(nullptr), filteredCount(nullptr) {}
@@ -216,6 +216,7 @@ public:
 
 	virtual void addref( ) = 0;
 	virtual void delref( ) = 0;
+	virtual bool isSoleOwnerUnsafe( ) const = 0;
 
 	void send(Never) {
 		if (TRACE_SAMPLE()) TraceEvent(SevSample, "Promise_sendNever");
@@ -352,11 +353,16 @@ protected:
 };
 
 template <class T>
-class ThreadSingleAssignmentVar : public ThreadSingleAssignmentVarBase, /* public FastAllocated<ThreadSingleAssignmentVar<T>>,*/ public ThreadSafeReferenceCounted<ThreadSingleAssignmentVar<T>>
+class ThreadSingleAssignmentVar : public ThreadSingleAssignmentVarBase, public ThreadSafeReferenceCounted<ThreadSingleAssignmentVar<T>>
 {
 public:
 	virtual ~ThreadSingleAssignmentVar() {}
 
+	// One of these is allocated for every client API call, so they are pooled by the fast allocator.  FastAllocated<>
+	// can't be used because subclasses differ in size; the virtual destructor passes the real size to operator delete.
+	static void* operator new(size_t s) { return allocateFast(s); }
+	static void operator delete(void* p, size_t s) { freeFast(s, p); }
+
 	T value;
 
 	T get() {
@@ -378,6 +384,10 @@ public:
 		ThreadSafeReferenceCounted<ThreadSingleAssignmentVar<T>>::delref( );
 	}
 
+	virtual bool isSoleOwnerUnsafe( ) const {
+		return ThreadSafeReferenceCounted<ThreadSingleAssignmentVar<T>>::isSoleOwnerUnsafe( );
+	}
+
 	void send(const T& value) {
 		if (TRACE_SAMPLE()) TraceEvent(SevSample, "Promise_send");
 		this->mutex.enter();
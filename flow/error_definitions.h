@@ -198,6 +198,8 @@ ERROR( restore_bad_read, 2368, "Unexpected number of bytes read")
 ERROR( restore_corrupted_data_padding, 2369, "Backup file has unexpected padding bytes")
 ERROR( restore_destination_not_empty, 2370, "Attempted to restore into a non-empty destination database")
 ERROR( restore_duplicate_uid, 2371, "Attempted to restore using a UID that had been used for an aborted restore")
+ERROR( bulk_load_no_destination, 2372, "Not enough storage servers to move bulk loaded data to a new team")
+ERROR( bulk_load_overlapping_team, 2373, "Bulk loaded data cannot be moved onto a server which holds its range")
 ERROR( task_invalid_version, 2381, "Invalid task version")
 ERROR( task_interrupted, 2382, "Task execution stopped due to timeout, abort, or completion by another worker")
 